@@ -202,6 +202,11 @@ extern void PrintMemoryManagementInf()
 #define IS_PART_SAME_STRING(x, y, len) \
 	((SAME == strncmp(x, y, len)) ? YES : NO)
 
+//! Check key x of length xlen and key y of length ylen have same bytes, no '\0' needed.
+//! Compare length first, then with build-in function memcmp(3).
+#define IS_SAME_KEY(x, xlen, y, ylen) \
+	((((xlen) == (ylen)) && (SAME == memcmp(x, y, xlen))) ? YES : NO)
+
 //+++++++++++++++++++++++++++++  Name and path management macros  +++++++++++++++++++++++++++++
 //! name for path and name
 typedef char PATH;
@@ -426,6 +431,9 @@ bool_t isSamePath(const char * __restrict path1, const char * __restrict path2)
 //! Get the number of elements stored in array, but array [a] must not allocated by malloc(3).
 #define ARRAY_SIZE(a) (sizeof((a)) / sizeof(((a)[0])))
 
+//! Ask CPU to load memory at address [x] into cache, without waiting for it.
+#define PREFETCH(x) __builtin_prefetch(x)
+
 #ifdef _DEBUGMODEON
 //! Output debug message, compiled date and time.
 # define OUTPUT_DEBUG_MSG \
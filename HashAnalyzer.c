@@ -0,0 +1,499 @@
+/**
+ *  @file   HashAnalyzer.c
+ *
+ *  @date   Oct 16, 2026
+ *  @author WangLiang
+ *  @email  liang.wang@elektrobit.com
+ *
+ *  @brief  Analyze quality and distribution of every hash method over a key corpus.
+ *
+ *   Keys are read one per line from the file given as argument, or from stdin. Duplicated keys are
+ * dropped. For each hash method it reports:
+ *   - collisions of the 31 bits value after & 0x7FFFFFFF, against the number expected from a random hash.
+ *   - bucket histogram, max and average chain of a NormalHash chained table, one bucket for each key.
+ *   - probe length distribution of an MPQ table, 1.5 slots for each key, and of a NormalHash open
+ *     addressing table.
+ *   - avalanche, how often each output bit flips when one input bit flips, and bias of each output bit.
+ *
+ *   Build: gcc -std=gnu99 -O2 HashAnalyzer.c CProjectDfn.c NormalHash/HashMethod.c NormalHash/VectorHash.c
+ *          NormalHash/OpenHash.c MPQHash/MPQHash.c -o HashAnalyzer
+ */
+
+#include "CProjectDfn.h"
+#include "NormalHash/HashMethod.h"
+#include "NormalHash/OpenHash.h"
+#include "MPQHash/MPQHash.h"
+
+#define HASH_VALUE_BITS 31                 ///< Bits left after & 0x7FFFFFFF.
+#define CHAIN_HISTOGRAM_SIZE 8             ///< Buckets with 0..6 items, last one counts 7 or more.
+#define PROBE_HISTOGRAM_SIZE 6             ///< Probes of 1, 2, 3-4, 5-8, 9-16, 17 or more.
+#define AVALANCHE_SAMPLE_KEYS 2000         ///< Keys sampled for avalanche test.
+#define AVALANCHE_MAX_BYTES 64             ///< Input bits flipped only in first bytes of each key.
+#define WEAK_AVALANCHE_BITS 8              ///< A flip changing fewer output bits than this is weak.
+
+/**
+ * @brief Key corpus, keys are unique and need no terminating '\0'.
+ */
+typedef struct Corpus
+{
+	char **keys;               ///< Address of each key.
+	size_t *lens;              ///< Length of each key.
+	int nKeys;                 ///< Number of keys.
+	int nDuplicated;           ///< Number of duplicated lines dropped.
+}Corpus;
+
+/**
+ * @brief Hash method being analyzed.
+ */
+typedef struct AnalyzedMethod
+{
+	const char *name;
+	unsigned int (*HashMethodLen)(const void *, size_t);
+}AnalyzedMethod;
+
+/**
+ * @brief Distribution of probe lengths of an open addressing table.
+ */
+typedef struct ProbeStat
+{
+	double fAverage;
+	unsigned int nMedian;
+	unsigned int nP99;
+	unsigned int nMax;
+	unsigned int histogram[PROBE_HISTOGRAM_SIZE];
+}ProbeStat;
+
+// Offset hash of MPQ, the one deciding start position in MPQ table.
+static unsigned int MPQHashLen(const void *key, size_t len)
+{
+	return HashStringLen(key, len, 0);
+}
+
+static const AnalyzedMethod methods[] =
+{
+	{"SDBM", SDBMHashLen},
+	{"RS", RSHashLen},
+	{"JS", JSHashLen},
+	{"PJW", PJWHashLen},
+	{"ELF", ELFHashLen},
+	{"BKDR", BKDRHashLen},
+	{"DJB", DJBHashLen},
+	{"AP", APHashLen},
+	{"Word", WordHashLen},
+	{"Vector", VectorHashLen},
+	{"MPQ", MPQHashLen},
+};
+
+//! Key being sorted by CompareKeys(), qsort() passes no context.
+static const Corpus *sortingCorpus = NULL;
+
+static int CompareKeys(const void *a, const void *b)
+{
+	int i = *(const int *)a, j = *(const int *)b;
+	size_t nMin = MIN(sortingCorpus->lens[i], sortingCorpus->lens[j]);
+	int ret = memcmp(sortingCorpus->keys[i], sortingCorpus->keys[j], nMin);
+
+	if (0 != ret)
+	{
+		return ret;
+	}
+	return (sortingCorpus->lens[i] > sortingCorpus->lens[j]) - (sortingCorpus->lens[i] < sortingCorpus->lens[j]);
+}
+
+static int CompareUInt(const void *a, const void *b)
+{
+	unsigned int x = *(const unsigned int *)a, y = *(const unsigned int *)b;
+	return (x > y) - (x < y);
+}
+
+/**
+ * @brief Read keys one per line, drop line end and duplicated keys.
+ *
+ * @param fp Where to read keys.
+ * @param pCorpus Save keys read.
+ * @return SUCCEED, or FAILED if no memory.
+ */
+static int ReadCorpus(FILE *fp, Corpus *pCorpus)
+{
+	char *line = NULL;
+	size_t nCap = 0, nAlloc = 1024;
+	ssize_t nRead;
+	int nKeys = 0;
+
+	pCorpus->keys = MALLOC(char *, nAlloc);
+	pCorpus->lens = MALLOC(size_t, nAlloc);
+	if (IS_NULL(pCorpus->keys) || IS_NULL(pCorpus->lens))
+	{
+		return FAILED;
+	}
+	while ((nRead = getline(&line, &nCap, fp)) >= 0)
+	{
+		while ((nRead > 0) && (('\n' == line[nRead-1]) || ('\r' == line[nRead-1])))
+		{
+			--nRead;
+		}
+		if ((size_t)nKeys == nAlloc)
+		{
+			nAlloc *= 2;
+			pCorpus->keys = (char **)realloc(pCorpus->keys, sizeof(char *) * nAlloc);
+			pCorpus->lens = (size_t *)realloc(pCorpus->lens, sizeof(size_t) * nAlloc);
+			if (IS_NULL(pCorpus->keys) || IS_NULL(pCorpus->lens))
+			{
+				FREE(line);
+				return FAILED;
+			}
+		}
+		pCorpus->keys[nKeys] = MALLOC(char, nRead + 1);
+		memcpy(pCorpus->keys[nKeys], line, nRead);
+		pCorpus->keys[nKeys][nRead] = '\0';
+		pCorpus->lens[nKeys] = nRead;
+		++nKeys;
+	}
+	FREE(line);
+	pCorpus->nKeys = nKeys;
+
+	// Sort, then keep first of each run of same keys.
+	int *order = MALLOC(int, nKeys + 1);
+	char **keys = MALLOC(char *, nKeys + 1);
+	size_t *lens = MALLOC(size_t, nKeys + 1);
+	int nUnique = 0, nLast = 0;
+	for (int i=0; i<nKeys; ++i)
+	{
+		order[i] = i;
+	}
+	sortingCorpus = pCorpus;
+	qsort(order, nKeys, sizeof(int), CompareKeys);
+	for (int i=0; i<nKeys; ++i)
+	{
+		if ((i > 0) && (0 == CompareKeys(&nLast, &order[i])))
+		{
+			FREE(pCorpus->keys[order[i]]);
+			continue;
+		}
+		nLast = order[i];
+		keys[nUnique] = pCorpus->keys[order[i]];
+		lens[nUnique] = pCorpus->lens[order[i]];
+		++nUnique;
+	}
+	FREE(order);
+	FREE(pCorpus->keys);
+	FREE(pCorpus->lens);
+	pCorpus->keys = keys;
+	pCorpus->lens = lens;
+	pCorpus->nDuplicated = nKeys - nUnique;
+	pCorpus->nKeys = nUnique;
+	return SUCCEED;
+}
+
+static void FreeCorpus(Corpus *pCorpus)
+{
+	for (int i=0; i<pCorpus->nKeys; ++i)
+	{
+		FREE(pCorpus->keys[i]);
+	}
+	FREE(pCorpus->keys);
+	FREE(pCorpus->lens);
+}
+
+/**
+ * @brief Count keys whose 31 bits hash value equals the one of another key.
+ *
+ * @param hashes Hash value of each key.
+ * @param nKeys Number of keys.
+ * @return Number of collisions, a group of k same values counts k-1.
+ */
+static unsigned int CountCollisions(const unsigned int *hashes, int nKeys)
+{
+	unsigned int *sorted = MALLOC(unsigned int, nKeys + 1);
+	unsigned int nCollisions = 0;
+
+	for (int i=0; i<nKeys; ++i)
+	{
+		sorted[i] = hashes[i] & 0x7FFFFFFF;
+	}
+	qsort(sorted, nKeys, sizeof(unsigned int), CompareUInt);
+	for (int i=1; i<nKeys; ++i)
+	{
+		if (sorted[i] == sorted[i-1])
+		{
+			++nCollisions;
+		}
+	}
+	FREE(sorted);
+	return nCollisions;
+}
+
+/**
+ * @brief Put probe lengths into statistics, probe lengths are sorted.
+ *
+ * @param probes Probe length of each key, 1 means found in start slot.
+ * @param nKeys Number of keys.
+ * @param pStat Save statistics.
+ */
+static void SummarizeProbes(unsigned int *probes, int nKeys, ProbeStat *pStat)
+{
+	unsigned long long nTotal = 0;
+
+	memset(pStat, 0, sizeof(ProbeStat));
+	if (0 == nKeys)
+	{
+		return;
+	}
+	qsort(probes, nKeys, sizeof(unsigned int), CompareUInt);
+	for (int i=0; i<nKeys; ++i)
+	{
+		unsigned int nSlot = 0;
+		while ((nSlot < PROBE_HISTOGRAM_SIZE - 1) && (probes[i] > (1U << nSlot)))
+		{
+			++nSlot;
+		}
+		++pStat->histogram[nSlot];
+		nTotal += probes[i];
+	}
+	pStat->fAverage = (double)nTotal / nKeys;
+	pStat->nMedian = probes[nKeys / 2];
+	pStat->nP99 = probes[(int)((long long)nKeys * 99 / 100)];
+	pStat->nMax = probes[nKeys - 1];
+}
+
+/**
+ * @brief Insert all hash values into an MPQ table, 1.5 slots for each key, measure probe of each.
+ */
+static void ProbeMPQTable(const unsigned int *hashes, int nKeys, ProbeStat *pStat)
+{
+	unsigned int nTableSize = MAX((unsigned int)(nKeys * 1.5), 16U);
+	struct HashItem *pTable = InitHashTable(nTableSize);
+	unsigned int *probes = MALLOC(unsigned int, nKeys + 1);
+
+	for (int i=0; i<nKeys; ++i)
+	{
+		int position = InsertHashItem(pTable, nTableSize, hashes[i], 0, 0, NULL);
+		probes[i] = (position + nTableSize - hashes[i] % nTableSize) % nTableSize + 1;
+	}
+	SummarizeProbes(probes, nKeys, pStat);
+	FREE(probes);
+	FREE(pTable);
+}
+
+/**
+ * @brief Insert all hash values into a NormalHash open addressing table, measure probe of each.
+ */
+static void ProbeOpenTable(const unsigned int *hashes, int nKeys, ProbeStat *pStat)
+{
+	unsigned int nSlotBits = SlotBitsForItems(nKeys);
+	unsigned int nMask = (1U << nSlotBits) - 1;
+	HashSlot *pSlots = InitSlotTable(nSlotBits);
+	unsigned int *probes = MALLOC(unsigned int, nKeys + 1);
+
+	for (int i=0; i<nKeys; ++i)
+	{
+		// Item only marks slot used, it is never read.
+		unsigned int nPos = InsertSlot(pSlots, nSlotBits, hashes[i], pSlots, 0);
+		probes[i] = ((nPos - SlotIndex(hashes[i], nSlotBits)) & nMask) + 1;
+	}
+	SummarizeProbes(probes, nKeys, pStat);
+	FREE(probes);
+	FREE(pSlots);
+}
+
+/**
+ * @brief Print bucket histogram, max and average chain of a chained table, one bucket for each key.
+ */
+static void AnalyzeChains(const AnalyzedMethod *pMethod, const unsigned int *hashes, int nKeys)
+{
+	unsigned int nBuckets = MAX(nKeys, 16);
+	unsigned int *counts = (unsigned int *)calloc(nBuckets, sizeof(unsigned int));
+	unsigned int histogram[CHAIN_HISTOGRAM_SIZE] = {0};
+	unsigned int nMax = 0, nUsed = 0;
+	unsigned long long nCompares = 0;
+
+	for (int i=0; i<nKeys; ++i)
+	{
+		++counts[hashes[i] % nBuckets];
+	}
+	for (unsigned int i=0; i<nBuckets; ++i)
+	{
+		++histogram[MIN(counts[i], (unsigned int)CHAIN_HISTOGRAM_SIZE - 1)];
+		nMax = MAX(nMax, counts[i]);
+		nUsed += (counts[i] > 0);
+		// Finding each item of a chain of n compares 1+2+...+n items.
+		nCompares += (unsigned long long)counts[i] * (counts[i] + 1) / 2;
+	}
+	printf("%-8s", pMethod->name);
+	for (int i=0; i<CHAIN_HISTOGRAM_SIZE; ++i)
+	{
+		printf(" %8u", histogram[i]);
+	}
+	printf(" %5u %7.3f %7.3f\n", nMax, nUsed ? (double)nKeys / nUsed : 0.0,
+			nKeys ? (double)nCompares / nKeys : 0.0);
+	FREE(counts);
+}
+
+static void PrintProbes(const AnalyzedMethod *pMethod, const ProbeStat *pStat)
+{
+	printf("%-8s %7.3f %6u %6u %6u", pMethod->name, pStat->fAverage, pStat->nMedian, pStat->nP99, pStat->nMax);
+	for (int i=0; i<PROBE_HISTOGRAM_SIZE; ++i)
+	{
+		printf(" %8u", pStat->histogram[i]);
+	}
+	printf("\n");
+}
+
+/**
+ * @brief Print avalanche and bit bias of a hash method.
+ *
+ *   Avalanche flips each bit in first AVALANCHE_MAX_BYTES bytes of sampled keys, a good hash flips each
+ * output bit with chance 0.5. Bias is how far chance of each output bit being 1 is from 0.5.
+ */
+static void AnalyzeBits(const AnalyzedMethod *pMethod, const Corpus *pCorpus, const unsigned int *hashes)
+{
+	unsigned long long flips[HASH_VALUE_BITS] = {0}, ones[HASH_VALUE_BITS] = {0};
+	unsigned long long nTrials = 0, nWeak = 0;
+	char buffer[AVALANCHE_MAX_BYTES];
+	int nStep = MAX(pCorpus->nKeys / AVALANCHE_SAMPLE_KEYS, 1);
+	double fFlipSum = 0.0, fWorstFlip = 0.0, fWorstBias = 0.0;
+
+	for (int i=0; i<pCorpus->nKeys; ++i)
+	{
+		for (int bit=0; bit<HASH_VALUE_BITS; ++bit)
+		{
+			ones[bit] += (hashes[i] >> bit) & 1;
+		}
+	}
+
+	for (int i=0; i<pCorpus->nKeys; i+=nStep)
+	{
+		size_t nBytes = MIN(pCorpus->lens[i], (size_t)AVALANCHE_MAX_BYTES);
+		unsigned int nHash = hashes[i] & 0x7FFFFFFF;
+
+		// Flip bits in a copy of the head, the rest of key stays where it is.
+		char *key = pCorpus->keys[i];
+		memcpy(buffer, key, nBytes);
+		for (size_t nBit=0; nBit<nBytes*8; ++nBit)
+		{
+			unsigned int nFlipped;
+			key[nBit/8] ^= (char)(1 << (nBit%8));
+			nFlipped = (nHash ^ (*(pMethod->HashMethodLen))(key, pCorpus->lens[i])) & 0x7FFFFFFF;
+			key[nBit/8] = buffer[nBit/8];
+
+			if (__builtin_popcount(nFlipped) < WEAK_AVALANCHE_BITS)
+			{
+				++nWeak;
+			}
+			for (int bit=0; bit<HASH_VALUE_BITS; ++bit)
+			{
+				flips[bit] += (nFlipped >> bit) & 1;
+			}
+			++nTrials;
+		}
+	}
+
+	for (int bit=0; bit<HASH_VALUE_BITS; ++bit)
+	{
+		double fFlip = nTrials ? (double)flips[bit] / nTrials : 0.0;
+		double fOne = pCorpus->nKeys ? (double)ones[bit] / pCorpus->nKeys : 0.0;
+		fFlipSum += fFlip;
+		fWorstFlip = MAX(fWorstFlip, (fFlip > 0.5) ? fFlip - 0.5 : 0.5 - fFlip);
+		fWorstBias = MAX(fWorstBias, (fOne > 0.5) ? fOne - 0.5 : 0.5 - fOne);
+	}
+	printf("%-8s %10llu %9.4f %9.4f %8.3f%% %9.4f\n", pMethod->name, nTrials, fFlipSum / HASH_VALUE_BITS,
+			fWorstFlip, nTrials ? 100.0 * nWeak / nTrials : 0.0, fWorstBias);
+}
+
+int main(int argc, char *argv[])
+{
+	Corpus corpus;
+	FILE *fp = stdin;
+	int nMethods = ARRAY_SIZE(methods);
+	ProbeStat *mpqStats, *openStats;
+	unsigned int **hashes;
+
+	if (argc > 2)
+	{
+		fprintf(stderr, "Usage: %s [key file, one key each line, stdin if not given]\n", argv[0]);
+		return 1;
+	}
+	if ((2 == argc) && IS_NULL(fp = fopen(argv[1], "r")))
+	{
+		perror(argv[1]);
+		return 1;
+	}
+	if (FAILED == ReadCorpus(fp, &corpus))
+	{
+		fprintf(stderr, "No memory for keys.\n");
+		return 1;
+	}
+	if (stdin != fp)
+	{
+		fclose(fp);
+	}
+
+	mpqStats = MALLOC(ProbeStat, nMethods);
+	openStats = MALLOC(ProbeStat, nMethods);
+	hashes = MALLOC(unsigned int *, nMethods);
+
+	double fExpected = (double)corpus.nKeys * MAX(corpus.nKeys - 1, 0) / 2 / 2147483648.0;
+	printf("%d unique keys, %d duplicated lines dropped.\n\n", corpus.nKeys, corpus.nDuplicated);
+
+	for (int m=0; m<nMethods; ++m)
+	{
+		hashes[m] = MALLOC(unsigned int, corpus.nKeys + 1);
+		for (int i=0; i<corpus.nKeys; ++i)
+		{
+			hashes[m][i] = (*(methods[m].HashMethodLen))(corpus.keys[i], corpus.lens[i]);
+		}
+	}
+
+	printf("Collisions of 31 bits hash value, %.2f expected from a random hash:\n", fExpected);
+	for (int m=0; m<nMethods; ++m)
+	{
+		printf("%-8s %u\n", methods[m].name, CountCollisions(hashes[m], corpus.nKeys));
+	}
+
+	printf("\nChained table, %d buckets, number of buckets holding n items:\n", MAX(corpus.nKeys, 16));
+	printf("%-8s %8s %8s %8s %8s %8s %8s %8s %8s %5s %7s %7s\n", "method",
+			"n=0", "n=1", "n=2", "n=3", "n=4", "n=5", "n=6", "n>=7", "max", "avg", "cmp");
+	for (int m=0; m<nMethods; ++m)
+	{
+		AnalyzeChains(&methods[m], hashes[m], corpus.nKeys);
+	}
+
+	for (int m=0; m<nMethods; ++m)
+	{
+		ProbeMPQTable(hashes[m], corpus.nKeys, &mpqStats[m]);
+		ProbeOpenTable(hashes[m], corpus.nKeys, &openStats[m]);
+	}
+	printf("\nMPQ table, 1.5 slots each key, slots probed to find each key:\n");
+	printf("%-8s %7s %6s %6s %6s %8s %8s %8s %8s %8s %8s\n", "method",
+			"avg", "p50", "p99", "max", "1", "2", "3-4", "5-8", "9-16", ">16");
+	for (int m=0; m<nMethods; ++m)
+	{
+		PrintProbes(&methods[m], &mpqStats[m]);
+	}
+	printf("\nOpen addressing table, at most %d%% full, slots probed to find each key:\n",
+			OPEN_HASH_MAX_LOAD_PERCENT);
+	printf("%-8s %7s %6s %6s %6s %8s %8s %8s %8s %8s %8s\n", "method",
+			"avg", "p50", "p99", "max", "1", "2", "3-4", "5-8", "9-16", ">16");
+	for (int m=0; m<nMethods; ++m)
+	{
+		PrintProbes(&methods[m], &openStats[m]);
+	}
+
+	printf("\nAvalanche of one input bit flip (ideal 0.5), weak flips change < %d output bits,"
+			" bias of output bits (ideal 0):\n", WEAK_AVALANCHE_BITS);
+	printf("%-8s %10s %9s %9s %9s %9s\n", "method", "trials", "flip", "worst", "weak", "bias");
+	for (int m=0; m<nMethods; ++m)
+	{
+		AnalyzeBits(&methods[m], &corpus, hashes[m]);
+	}
+
+	for (int m=0; m<nMethods; ++m)
+	{
+		FREE(hashes[m]);
+	}
+	FREE(hashes);
+	FREE(mpqStats);
+	FREE(openStats);
+	FreeCorpus(&corpus);
+	return 0;
+}
@@ -0,0 +1,735 @@
+/**
+ *  @file   HashBenchmark.c
+ *
+ *  @date   Oct 16, 2026
+ *  @author WangLiang
+ *  @email  liang.wang@elektrobit.com
+ *
+ *  @brief  Benchmark build, hit lookup, miss lookup and remove of one hash engine, print CSV or JSON.
+ *
+ *   Engine is selected at compile time like HashTester.c, so each engine is one binary:
+ *
+ *   gcc -std=gnu99 -O2 HashBenchmark.c CProjectDfn.c PerfCounter.c MPQHash/Hash.c MPQHash/MPQHash.c
+ *       MPQHash/ConcurrentHash.c -lpthread -lm -o HashBenchmarkMPQ
+ *   gcc -std=gnu99 -O2 -DTEST_LIST_HASH HashBenchmark.c CProjectDfn.c PerfCounter.c NormalHash/Hash.c NormalHash/HashMethod.c
+ *       NormalHash/VectorHash.c NormalHash/OpenHash.c NormalHash/Slab.c -lpthread -lm -o HashBenchmarkList
+ *   gcc -std=gnu99 -O2 -DTEST_PERFECT_HASH HashBenchmark.c CProjectDfn.c PerfCounter.c PerfectHash/Hash.c
+ *       -lm -o HashBenchmarkPerfect
+ *   gcc -std=gnu99 -O2 -mavx2 -DTEST_SWISS_HASH HashBenchmark.c CProjectDfn.c PerfCounter.c SwissHash/Hash.c
+ *       -lm -o HashBenchmarkSwiss
+ *
+ *   Each configuration (hash method, layout, number of keys) runs one warmup round and then repeated
+ * rounds, a round builds a table, looks up every key, looks up as many missing keys, and removes every
+ * key. Each operation reports min, median, p90 and max ns/op over rounds, ops/sec of the median round,
+ * and for lookups the per-operation latency p50, p99 and p99.9 of the last round, timed by rdtsc.
+ * PerfectHash builds a static key set, it's rounds have no remove.
+ *
+ *   Options:
+ *   -n 256,4096,...   numbers of keys, default from L1 resident to far beyond LLC.
+ *   -l 32             length of each key.
+ *   -r 5              timed rounds of each configuration.
+ *   -w 1              warmup rounds of each configuration.
+ *   -m BKDR           only this hash method, NormalHash only.
+ *   -o csv|json       output format, csv by default.
+ *   -p                also count cycles, instructions, LLC misses, dTLB misses and branch misses of
+ *                     each operation in timed rounds, see PerfCounter.h.
+ */
+
+#if !defined(TEST_LIST_HASH) && !defined(TEST_PERFECT_HASH) && !defined(TEST_SWISS_HASH)
+#define TEST_MPQHASH
+#endif
+
+#include "CProjectDfn.h"
+#include "PerfCounter.h"
+#if defined(TEST_LIST_HASH)
+#include "NormalHash/Hash.h"
+#elif defined(TEST_PERFECT_HASH)
+#include "PerfectHash/Hash.h"
+#elif defined(TEST_SWISS_HASH)
+#include "SwissHash/Hash.h"
+#else
+#include "MPQHash/Hash.h"
+#endif
+#include <math.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCHMARK_RDTSC
+#endif
+
+#define MAX_SIZES 16                       ///< Max number of -n values.
+#define DEFAULT_KEY_LEN 32
+#define DEFAULT_ROUNDS 5
+#define DEFAULT_WARMUP_ROUNDS 1
+
+//! Operations timed in each round.
+enum
+{
+	OP_BUILD,
+	OP_HIT,
+	OP_MISS,
+	OP_REMOVE,
+	OP_NUM
+};
+
+static const char *opNames[OP_NUM] = {"build", "hit", "miss", "remove"};
+
+//! Operations the engine has, key set of a perfect hash can not change.
+#ifdef TEST_PERFECT_HASH
+#define ENGINE_OP_NUM OP_REMOVE
+#else
+#define ENGINE_OP_NUM OP_NUM
+#endif
+
+/**
+ * @brief Hash method and layout of one configuration.
+ */
+typedef struct BenchMethod
+{
+	const char *name;
+#ifdef TEST_LIST_HASH
+	unsigned int (*HashMethod)(const char *);
+#endif
+}BenchMethod;
+
+static const BenchMethod methods[] =
+{
+#ifdef TEST_LIST_HASH
+	{"SDBM", SDBMHash},
+	{"RS", RSHash},
+	{"JS", JSHash},
+	{"PJW", PJWHash},
+	{"ELF", ELFHash},
+	{"BKDR", BKDRHash},
+	{"DJB", DJBHash},
+	{"AP", APHash},
+	{"Word", WordHash},
+	{"Vector", VectorHash},
+#elif defined(TEST_PERFECT_HASH)
+	{"PTHash"},
+#elif defined(TEST_SWISS_HASH)
+	{"Word"},
+#else
+	{"MPQ"},
+#endif
+};
+
+#ifdef TEST_LIST_HASH
+#define ENGINE_NAME "NormalHash"
+static const struct
+{
+	const char *name;
+	unsigned int flags;
+}layouts[] =
+{
+	{"chained", HASH_LAYOUT_CHAINED},
+	{"open", HASH_LAYOUT_OPEN_ADDRESSING},
+	{"chained-filter", HASH_LAYOUT_CHAINED | HASH_KEY_FILTER},
+	{"open-filter", HASH_LAYOUT_OPEN_ADDRESSING | HASH_KEY_FILTER},
+};
+#elif defined(TEST_PERFECT_HASH)
+#define ENGINE_NAME "PerfectHash"
+static const struct
+{
+	const char *name;
+	unsigned int flags;
+}layouts[] =
+{
+	{"keys", PERFECT_HASH_KEEP_KEYS},
+};
+#elif defined(TEST_SWISS_HASH)
+#define ENGINE_NAME "SwissHash"
+static const struct
+{
+	const char *name;
+	unsigned int flags;
+}layouts[] =
+{
+	{"swiss", 0},
+};
+#else
+#define ENGINE_NAME "MPQHash"
+#define MPQ_BENCH_KEY_FILTER 0x100   ///< Or with key check, BuildKeyFilter() after table is built.
+static const struct
+{
+	const char *name;
+	unsigned int flags;
+}layouts[] =
+{
+	{"mpq", HASH_CHECK_FINGERPRINT},
+	{"mpq-verify", HASH_CHECK_KEY},
+	{"mpq-filter", HASH_CHECK_FINGERPRINT | MPQ_BENCH_KEY_FILTER},
+};
+#endif
+
+/**
+ * @brief Options from command line.
+ */
+typedef struct BenchOptions
+{
+	int sizes[MAX_SIZES];
+	int nSizes;
+	int nKeyLen;
+	int nRounds;
+	int nWarmupRounds;
+	const char *onlyMethod;    ///< NULL for every method.
+	bool_t bJson;
+	bool_t bCounters;          ///< Whether to read performance counters, -p.
+	PerfCounters *pCounters;   ///< Opened counters, NULL if not wanted.
+}BenchOptions;
+
+/**
+ * @brief Result of one operation of one configuration.
+ */
+typedef struct OpResult
+{
+	double nsPerOp[64];        ///< ns/op of each timed round.
+	int nRounds;
+	double latency[3];         ///< p50, p99, p99.9 ns of one operation, < 0 if not measured.
+	double counts[PERF_COUNTER_NUM];    ///< Sum of each counter over timed rounds, < 0 if unavailable.
+	double fCountedOps;        ///< Operations counted in counts.
+}OpResult;
+
+//! Nanoseconds of one rdtsc tick, calibrated at start.
+static double nsPerTick = 1.0;
+
+static inline unsigned long long NowNs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static inline unsigned long long NowTicks(void)
+{
+#ifdef BENCHMARK_RDTSC
+	return __rdtsc();
+#else
+	return NowNs();
+#endif
+}
+
+/**
+ * @brief Measure how many ns one tick of NowTicks() is, against CLOCK_MONOTONIC.
+ */
+static void CalibrateTicks(void)
+{
+	unsigned long long startNs = NowNs(), startTicks = NowTicks();
+	while (NowNs() - startNs < 50000000ULL)
+	{
+	}
+	nsPerTick = (double)(NowNs() - startNs) / (double)(NowTicks() - startTicks);
+}
+
+static int CompareDouble(const void *a, const void *b)
+{
+	double x = *(const double *)a, y = *(const double *)b;
+	return (x > y) - (x < y);
+}
+
+// Nearest rank percentile of sorted values.
+static double Percentile(const double *sorted, int n, double fPercent)
+{
+	int nRank = (int)ceil(n * fPercent / 100);
+	return sorted[CLAMP(nRank - 1, 0, n - 1)];
+}
+
+/**
+ * @brief Small fast random generator, same keys on every run.
+ */
+static inline unsigned long long NextRandom(unsigned long long *pState)
+{
+	*pState ^= *pState << 13;
+	*pState ^= *pState >> 7;
+	*pState ^= *pState << 17;
+	return *pState;
+}
+
+/**
+ * @brief Create keys in one block, key i starts with i written in base 64, so all keys differ.
+ *
+ * @param nFirst Index of first key, keys from another range never equal these.
+ * @param nKeys Number of keys.
+ * @param nKeyLen Length of each key, at least 6.
+ * @param pBlock Save the block, free it after use.
+ * @return Address of each key.
+ */
+static char **MakeKeys(int nFirst, int nKeys, int nKeyLen, char **pBlock)
+{
+	static const char digits[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz+-";
+	unsigned long long state = 0x9E3779B97F4A7C15ULL ^ (unsigned long long)nFirst;
+	char **keys = MALLOC(char *, nKeys + 1);
+	char *block = MALLOC(char, (size_t)nKeys * (nKeyLen + 1) + 1);
+
+	for (int i=0; i<nKeys; ++i)
+	{
+		char *key = block + (size_t)i * (nKeyLen + 1);
+		unsigned int nIndex = (unsigned int)(nFirst + i);
+		for (int j=0; j<nKeyLen; ++j)
+		{
+			key[j] = (j < 6) ? digits[(nIndex >> (6 * j)) & 63] : (char)(NextRandom(&state) % 94 + 33);
+		}
+		key[nKeyLen] = '\0';
+		keys[i] = key;
+	}
+	*pBlock = block;
+	return keys;
+}
+
+/**
+ * @brief Shuffle keys, so lookups do not walk memory in the order keys were inserted.
+ *
+ * @param keys Keys to shuffle.
+ * @param nKeys Number of keys.
+ * @param nSeed Seed of order, another seed gives another order.
+ */
+static void ShuffleKeys(char **keys, int nKeys, unsigned long long nSeed)
+{
+	unsigned long long state = 0x2545F4914F6CDD1DULL ^ nSeed;
+	for (int i=nKeys-1; i>0; --i)
+	{
+		int j = (int)(NextRandom(&state) % (i + 1));
+		char *tmp = keys[i];
+		keys[i] = keys[j];
+		keys[j] = tmp;
+	}
+}
+
+static HashInf *BuildTable(const BenchMethod *pMethod, unsigned int flags, int nKeys, char **keys)
+{
+#ifdef TEST_LIST_HASH
+	return HashFromArrayEx(nKeys, keys, pMethod->HashMethod, flags);
+#elif defined(TEST_PERFECT_HASH)
+	(void)pMethod;
+	return HashFromArrayEx(nKeys, keys, flags);
+#elif defined(TEST_SWISS_HASH)
+	(void)pMethod;
+	(void)flags;
+	return HashFromArray(nKeys, keys);
+#else
+	// Layout of MPQ is how keys are checked.
+	(void)pMethod;
+	HashInf *pHashInf = HashFromArray(nKeys, keys);
+	if (IS_NULL(pHashInf))
+	{
+		return NULL;
+	}
+	SetKeyCheck(pHashInf, (int)(flags & ~MPQ_BENCH_KEY_FILTER));
+	if (flags & MPQ_BENCH_KEY_FILTER)
+	{
+		BuildKeyFilter(pHashInf);
+	}
+	return pHashInf;
+#endif
+}
+
+/**
+ * @brief Look up every key, time the whole loop, and each lookup when latency wanted.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param keys Keys to look up.
+ * @param nKeys Number of keys.
+ * @param latency Save ticks of each lookup, NULL to time only the whole loop.
+ * @param pFound Add number of keys found.
+ * @return ns of whole loop.
+ */
+static unsigned long long LookupAll(HashInf *pHashInf, char **keys, int nKeys, double *latency, int *pFound)
+{
+	unsigned long long startNs = NowNs();
+	int nFound = 0;
+
+	if (IS_NULL(latency))
+	{
+		for (int i=0; i<nKeys; ++i)
+		{
+			nFound += IS_NOT_NULL(GetStringAddress(pHashInf, keys[i]));
+		}
+	}
+	else
+	{
+		for (int i=0; i<nKeys; ++i)
+		{
+			unsigned long long startTicks = NowTicks();
+			nFound += IS_NOT_NULL(GetStringAddress(pHashInf, keys[i]));
+			latency[i] = (double)(NowTicks() - startTicks);
+		}
+	}
+	*pFound += nFound;
+	return NowNs() - startNs;
+}
+
+static inline void StartPhase(const BenchOptions *pOptions)
+{
+	if (IS_NOT_NULL(pOptions->pCounters))
+	{
+		StartPerfCounters(pOptions->pCounters);
+	}
+}
+
+static inline void StopPhase(const BenchOptions *pOptions, unsigned long long *counts)
+{
+	if (IS_NOT_NULL(pOptions->pCounters))
+	{
+		StopPerfCounters(pOptions->pCounters);
+		memcpy(counts, pOptions->pCounters->values, sizeof(pOptions->pCounters->values));
+	}
+}
+
+/**
+ * @brief Run warmup and timed rounds of one configuration.
+ *
+ * @return SUCCEED, or FAILED if a lookup gave a wrong answer.
+ */
+static int RunConfig(const BenchOptions *pOptions, const BenchMethod *pMethod, unsigned int flags,
+		int nKeys, char **hitKeys, char **lookupKeys, char **missKeys, OpResult *results)
+{
+	double *latency = MALLOC(double, nKeys + 1);
+	int nTotalRounds = pOptions->nWarmupRounds + pOptions->nRounds;
+	int ret = SUCCEED;
+
+	for (int op=0; op<OP_NUM; ++op)
+	{
+		results[op].nRounds = 0;
+		results[op].latency[0] = results[op].latency[1] = results[op].latency[2] = -1.0;
+		results[op].fCountedOps = 0;
+		for (int c=0; c<PERF_COUNTER_NUM; ++c)
+		{
+			results[op].counts[c] = 0;
+		}
+	}
+
+	for (int round=0; round<nTotalRounds; ++round)
+	{
+		bool_t bTimed = (round >= pOptions->nWarmupRounds) ? YES : NO;
+		bool_t bLastRound = (round == nTotalRounds - 1) ? YES : NO;
+		unsigned long long costNs[OP_NUM], counts[OP_NUM][PERF_COUNTER_NUM];
+		int nHits = 0, nMisses = 0, nRemoved = 0;
+
+		StartPhase(pOptions);
+		unsigned long long startNs = NowNs();
+		HashInf *pHashInf = BuildTable(pMethod, flags, nKeys, hitKeys);
+		costNs[OP_BUILD] = NowNs() - startNs;
+		StopPhase(pOptions, counts[OP_BUILD]);
+		if (IS_NULL(pHashInf))
+		{
+			fprintf(stderr, "%s/%s/%d: no memory to build hash table.\n", ENGINE_NAME, pMethod->name, nKeys);
+			ret = FAILED;
+			break;
+		}
+
+		StartPhase(pOptions);
+		costNs[OP_HIT] = LookupAll(pHashInf, lookupKeys, nKeys, NULL, &nHits);
+		StopPhase(pOptions, counts[OP_HIT]);
+		StartPhase(pOptions);
+		costNs[OP_MISS] = LookupAll(pHashInf, missKeys, nKeys, NULL, &nMisses);
+		StopPhase(pOptions, counts[OP_MISS]);
+
+		// Latency of single lookups is taken once, after timed loops, so rdtsc does not slow them.
+		if (bLastRound)
+		{
+			int nIgnored = 0;
+			for (int op=OP_HIT; op<=OP_MISS; ++op)
+			{
+				LookupAll(pHashInf, (OP_HIT == op) ? lookupKeys : missKeys, nKeys, latency, &nIgnored);
+				qsort(latency, nKeys, sizeof(double), CompareDouble);
+				results[op].latency[0] = Percentile(latency, nKeys, 50.0) * nsPerTick;
+				results[op].latency[1] = Percentile(latency, nKeys, 99.0) * nsPerTick;
+				results[op].latency[2] = Percentile(latency, nKeys, 99.9) * nsPerTick;
+			}
+		}
+
+#ifdef TEST_PERFECT_HASH
+		nRemoved = nKeys;
+#else
+		StartPhase(pOptions);
+		startNs = NowNs();
+		for (int i=0; i<nKeys; ++i)
+		{
+			nRemoved += (SUCCEED == RemoveString(pHashInf, hitKeys[i]));
+		}
+		costNs[OP_REMOVE] = NowNs() - startNs;
+		StopPhase(pOptions, counts[OP_REMOVE]);
+#endif
+		DeleteHashInf(&pHashInf);
+
+		if ((nHits != nKeys) || (0 != nMisses) || (nRemoved != nKeys))
+		{
+			fprintf(stderr, "%s/%s/%d: %d of %d hits, %d false hits, %d removed.\n",
+					ENGINE_NAME, pMethod->name, nKeys, nHits, nKeys, nMisses, nRemoved);
+			ret = FAILED;
+		}
+		if (bTimed && (results[OP_BUILD].nRounds < (int)ARRAY_SIZE(results[OP_BUILD].nsPerOp)))
+		{
+			for (int op=0; op<ENGINE_OP_NUM; ++op)
+			{
+				results[op].nsPerOp[results[op].nRounds++] = (double)costNs[op] / MAX(nKeys, 1);
+				if (IS_NULL(pOptions->pCounters))
+				{
+					continue;
+				}
+				results[op].fCountedOps += nKeys;
+				for (int c=0; c<PERF_COUNTER_NUM; ++c)
+				{
+					if (PERF_COUNTER_UNAVAILABLE == counts[op][c])
+					{
+						results[op].counts[c] = -1.0;
+					}
+					else if (results[op].counts[c] >= 0)
+					{
+						results[op].counts[c] += (double)counts[op][c];
+					}
+				}
+			}
+		}
+	}
+	FREE(latency);
+	return ret;
+}
+
+static void PrintHeader(const BenchOptions *pOptions)
+{
+	if (pOptions->bJson)
+	{
+		printf("[\n");
+	}
+	else
+	{
+		printf("engine,method,layout,keys,key_len,op,rounds,ns_per_op_min,ns_per_op_p50,ns_per_op_p90,"
+				"ns_per_op_max,ops_per_sec,latency_p50_ns,latency_p99_ns,latency_p999_ns");
+		if (IS_NOT_NULL(pOptions->pCounters))
+		{
+			for (int c=0; c<PERF_COUNTER_NUM; ++c)
+			{
+				printf(",%s_per_op", PerfCounterName(c));
+			}
+			printf(",ipc");
+		}
+		printf("\n");
+	}
+}
+
+/**
+ * @brief Print each counter per operation and instructions per cycle, empty or null if unavailable.
+ */
+static void PrintCounters(const BenchOptions *pOptions, const OpResult *pResult)
+{
+	double values[PERF_COUNTER_NUM + 1];
+
+	if (IS_NULL(pOptions->pCounters))
+	{
+		return;
+	}
+	for (int c=0; c<PERF_COUNTER_NUM; ++c)
+	{
+		values[c] = ((pResult->counts[c] < 0) || (0 == pResult->fCountedOps)) ? -1.0
+				: pResult->counts[c] / pResult->fCountedOps;
+	}
+	values[PERF_COUNTER_NUM] = ((values[PERF_CYCLES] > 0) && (values[PERF_INSTRUCTIONS] >= 0))
+			? values[PERF_INSTRUCTIONS] / values[PERF_CYCLES] : -1.0;
+
+	for (int c=0; c<=PERF_COUNTER_NUM; ++c)
+	{
+		const char *name = (c < PERF_COUNTER_NUM) ? PerfCounterName(c) : "ipc";
+		const char *suffix = (c < PERF_COUNTER_NUM) ? "_per_op" : "";
+		if (pOptions->bJson)
+		{
+			printf(", \"%s%s\": ", name, suffix);
+			printf((values[c] < 0) ? "null" : "%.3f", values[c]);
+		}
+		else
+		{
+			printf((values[c] < 0) ? "," : ",%.3f", values[c]);
+		}
+	}
+}
+
+static void PrintResult(const BenchOptions *pOptions, const BenchMethod *pMethod, const char *layout,
+		int nKeys, int op, OpResult *pResult, bool_t bFirst)
+{
+	double sorted[ARRAY_SIZE(pResult->nsPerOp)];
+	int n = pResult->nRounds;
+	const char *names[3] = {"latency_p50_ns", "latency_p99_ns", "latency_p999_ns"};
+
+	memcpy(sorted, pResult->nsPerOp, sizeof(double) * n);
+	qsort(sorted, n, sizeof(double), CompareDouble);
+	double fMedian = Percentile(sorted, n, 50.0);
+
+	if (pOptions->bJson)
+	{
+		printf("%s  {\"engine\": \"%s\", \"method\": \"%s\", \"layout\": \"%s\", \"keys\": %d, \"key_len\": %d, "
+				"\"op\": \"%s\", \"rounds\": %d, \"ns_per_op_min\": %.3f, \"ns_per_op_p50\": %.3f, "
+				"\"ns_per_op_p90\": %.3f, \"ns_per_op_max\": %.3f, \"ops_per_sec\": %.0f",
+				bFirst ? "" : ",\n", ENGINE_NAME, pMethod->name, layout, nKeys, pOptions->nKeyLen,
+				opNames[op], n, sorted[0], fMedian, Percentile(sorted, n, 90.0), sorted[n-1],
+				(fMedian > 0) ? 1e9 / fMedian : 0.0);
+		for (int i=0; i<3; ++i)
+		{
+			if (pResult->latency[i] < 0)
+			{
+				printf(", \"%s\": null", names[i]);
+			}
+			else
+			{
+				printf(", \"%s\": %.1f", names[i], pResult->latency[i]);
+			}
+		}
+		PrintCounters(pOptions, pResult);
+		printf("}");
+	}
+	else
+	{
+		printf("%s,%s,%s,%d,%d,%s,%d,%.3f,%.3f,%.3f,%.3f,%.0f", ENGINE_NAME, pMethod->name, layout, nKeys,
+				pOptions->nKeyLen, opNames[op], n, sorted[0], fMedian, Percentile(sorted, n, 90.0),
+				sorted[n-1], (fMedian > 0) ? 1e9 / fMedian : 0.0);
+		for (int i=0; i<3; ++i)
+		{
+			if (pResult->latency[i] < 0)
+			{
+				printf(",");
+			}
+			else
+			{
+				printf(",%.1f", pResult->latency[i]);
+			}
+		}
+		PrintCounters(pOptions, pResult);
+		printf("\n");
+	}
+	fflush(stdout);
+}
+
+/**
+ * @brief Read command line options.
+ * @return SUCCEED, or FAILED if an option is wrong.
+ */
+static int ParseOptions(int argc, char *argv[], BenchOptions *pOptions)
+{
+	static const int defaultSizes[] = {256, 4096, 65536, 1048576, 4194304};
+	int opt;
+
+	memcpy(pOptions->sizes, defaultSizes, sizeof(defaultSizes));
+	pOptions->nSizes = ARRAY_SIZE(defaultSizes);
+	pOptions->nKeyLen = DEFAULT_KEY_LEN;
+	pOptions->nRounds = DEFAULT_ROUNDS;
+	pOptions->nWarmupRounds = DEFAULT_WARMUP_ROUNDS;
+	pOptions->onlyMethod = NULL;
+	pOptions->bJson = NO;
+	pOptions->bCounters = NO;
+	pOptions->pCounters = NULL;
+
+	while (-1 != (opt = getopt(argc, argv, "n:l:r:w:m:o:p")))
+	{
+		switch (opt)
+		{
+		case 'n':
+			pOptions->nSizes = 0;
+			for (char *tok = strtok(optarg, ","); IS_NOT_NULL(tok) && (pOptions->nSizes < MAX_SIZES);
+					tok = strtok(NULL, ","))
+			{
+				pOptions->sizes[pOptions->nSizes++] = MAX(atoi(tok), 1);
+			}
+			break;
+		case 'l':
+			pOptions->nKeyLen = MAX(atoi(optarg), 6);
+			break;
+		case 'r':
+			pOptions->nRounds = CLAMP(atoi(optarg), 1, 64);
+			break;
+		case 'w':
+			pOptions->nWarmupRounds = MAX(atoi(optarg), 0);
+			break;
+		case 'm':
+			pOptions->onlyMethod = optarg;
+			break;
+		case 'o':
+			pOptions->bJson = IS_SAME_STRING(optarg, "json");
+			break;
+		case 'p':
+			pOptions->bCounters = YES;
+			break;
+		default:
+			return FAILED;
+		}
+	}
+	return (pOptions->nSizes > 0) ? SUCCEED : FAILED;
+}
+
+int main(int argc, char *argv[])
+{
+	BenchOptions options;
+	PerfCounters counters;
+	OpResult results[OP_NUM];
+	bool_t bFirst = YES;
+	int ret = 0;
+
+	if (FAILED == ParseOptions(argc, argv, &options))
+	{
+		fprintf(stderr, "Usage: %s [-n 256,4096,...] [-l key length] [-r rounds] [-w warmup rounds]"
+				" [-m method] [-o csv|json] [-p]\n", argv[0]);
+		return 1;
+	}
+	if (options.bCounters)
+	{
+		// Columns are kept when no counter opens, so output has the same fields on every machine.
+		if (FAILED == OpenPerfCounters(&counters))
+		{
+			fprintf(stderr, "No performance counter available, check /proc/sys/kernel/perf_event_paranoid.\n");
+		}
+		options.pCounters = &counters;
+	}
+	CalibrateTicks();
+	PrintHeader(&options);
+
+	for (int s=0; s<options.nSizes; ++s)
+	{
+		int nKeys = options.sizes[s];
+		char *hitBlock, *missBlock;
+		char **hitKeys = MakeKeys(0, nKeys, options.nKeyLen, &hitBlock);
+		char **missKeys = MakeKeys(nKeys, nKeys, options.nKeyLen, &missBlock);
+		char **lookupKeys = MALLOC(char *, nKeys + 1);
+
+		// Keys are inserted in one order and looked up in another, chained nodes come from a slab in insert
+		// order, so looking up in insert order would read memory one node after another.
+		ShuffleKeys(hitKeys, nKeys, 1);
+		memcpy(lookupKeys, hitKeys, sizeof(char *) * nKeys);
+		ShuffleKeys(lookupKeys, nKeys, 2);
+		ShuffleKeys(missKeys, nKeys, 3);
+
+		for (unsigned int m=0; m<ARRAY_SIZE(methods); ++m)
+		{
+			if (IS_NOT_NULL(options.onlyMethod) && !IS_SAME_STRING(options.onlyMethod, methods[m].name))
+			{
+				continue;
+			}
+			for (unsigned int l=0; l<ARRAY_SIZE(layouts); ++l)
+			{
+				if (FAILED == RunConfig(&options, &methods[m], layouts[l].flags, nKeys, hitKeys, lookupKeys, missKeys,
+						results))
+				{
+					ret = 1;
+				}
+				// A table that could not be built has no round to print.
+				for (int op=0; (op<ENGINE_OP_NUM) && (results[op].nRounds > 0); ++op)
+				{
+					PrintResult(&options, &methods[m], layouts[l].name, nKeys, op, &results[op], bFirst);
+					bFirst = NO;
+				}
+			}
+		}
+		FREE(hitKeys);
+		FREE(lookupKeys);
+		FREE(missKeys);
+		FREE(hitBlock);
+		FREE(missBlock);
+	}
+
+	if (options.bJson)
+	{
+		printf("\n]\n");
+	}
+	if (IS_NOT_NULL(options.pCounters))
+	{
+		ClosePerfCounters(options.pCounters);
+	}
+	return ret;
+}
@@ -0,0 +1,170 @@
+/**
+ * @file   HashStats.h
+ *
+ * @date   Oct 16, 2026
+ * @author WangLiang
+ * @email  liang.wang@elektrobit.com
+ *
+ * @brief  Optional counters of searches in a hash information, shared by MPQHash and NormalHash.
+ *
+ *   Build every file with -DHASH_STATS to count, without it counters are compiled out, hash information
+ * has no counter fields and GetHashStats() returns FAILED. All files of a program must agree, the
+ * size of hash information depends on it.
+ *
+ *   Each hash information has HASH_STATS_THREADS counter slots, one cache line each. A thread always
+ * counts into the same slot, so threads searching at the same time do not fight for a cache line.
+ * Counters are added without lock, if more than HASH_STATS_THREADS threads search one hash information
+ * at the same time, some counts of threads sharing a slot can be lost.
+ */
+
+#ifndef HASHSTATS_H_
+#define HASHSTATS_H_
+
+#include "CProjectDfn.h"
+
+/**
+ * @brief Number of counter slots in each hash information.
+ */
+#define HASH_STATS_THREADS 16
+
+/**
+ * @brief Counters of searches, a search is made by lookup, remove, upsert and insert checking duplicate.
+ */
+typedef struct HashStats
+{
+	unsigned long long nLookups;         ///< Number of searches.
+	unsigned long long nHits;            ///< Searches which found the key.
+	unsigned long long nMisses;          ///< Searches which did not find the key.
+	unsigned long long nProbes;          ///< Items visited, chain length walked or slots probed, all searches.
+	unsigned long long nMaxProbe;        ///< Most items visited by one search.
+	unsigned long long nCompares;        ///< Keys compared by bytes, for MPQ pairs of hash A and B compared.
+	unsigned long long nHashMismatches;  ///< Items with the same hash key but another key, for MPQ same
+	                                     ///< offset hash but different hash A or B.
+	unsigned long long nFilterRejects;   ///< Misses decided by key filter, no item visited, see KeyFilter.h.
+}HashStats;
+
+/**
+ * @brief Counters of one thread, a cache line.
+ */
+typedef struct HashStatsSlot
+{
+	HashStats stats;
+}__attribute__ ((aligned (64))) HashStatsSlot;
+
+#ifdef HASH_STATS
+
+/**
+ * @brief Slot given to next thread, and slot of calling thread, -1 until it first counts.
+ *
+ *   Weak, so every file including this header shares one of each in a program, as an extern defined in
+ * one file would be. Threads counting from MPQHash and NormalHash never get the same slot by accident.
+ */
+__attribute__ ((weak)) int hashStatsNextIndex = 0;
+__attribute__ ((weak)) __thread int hashStatsThreadIndex = -1;
+
+/**
+ * @brief Create counter slots of a hash information, all zero, each slot on it's own cache line.
+ *
+ * @return Created slots, free them by FREE(), or NULL if no memory.
+ */
+static inline HashStatsSlot *CreateHashStatsSlots(void)
+{
+	void *slots = NULL;
+
+	if (0 != posix_memalign(&slots, sizeof(HashStatsSlot), sizeof(HashStatsSlot) * HASH_STATS_THREADS))
+	{
+		return NULL;
+	}
+	memset(slots, 0, sizeof(HashStatsSlot) * HASH_STATS_THREADS);
+	return (HashStatsSlot *)slots;
+}
+
+/**
+ * @brief Get counters of calling thread.
+ *
+ *   Threads are given slots in the order they first search, thread N uses slot N % HASH_STATS_THREADS.
+ *
+ * @param slots Counter slots of a hash information.
+ * @return Counters calling thread adds to.
+ */
+static inline HashStats *ThreadHashStats(HashStatsSlot *slots)
+{
+	if (hashStatsThreadIndex < 0)
+	{
+		hashStatsThreadIndex = __atomic_fetch_add(&hashStatsNextIndex, 1, __ATOMIC_RELAXED) % HASH_STATS_THREADS;
+	}
+	return &slots[hashStatsThreadIndex].stats;
+}
+
+//! Counters of calling thread in a hash information.
+#define HASH_STATS_OF(pHashInf) ThreadHashStats((pHashInf)->statsSlots)
+
+// Plain load and store, no locked instruction, slot is normally written by one thread only.
+#define HASH_STATS_ADD(pStats, field, n) \
+	__atomic_store_n(&(pStats)->field, __atomic_load_n(&(pStats)->field, __ATOMIC_RELAXED) + (n), __ATOMIC_RELAXED)
+
+#define HASH_STATS_MAX(pStats, field, n) \
+	do \
+	{ \
+		if ((unsigned long long)(n) > __atomic_load_n(&(pStats)->field, __ATOMIC_RELAXED)) \
+		{ \
+			__atomic_store_n(&(pStats)->field, (unsigned long long)(n), __ATOMIC_RELAXED); \
+		} \
+	} while (0)
+
+/**
+ * @brief Count one finished search.
+ *
+ * @param pStats Counters of calling thread.
+ * @param bFound Whether key was found.
+ * @param nProbes Items visited by the search.
+ */
+static inline void CountHashSearch(HashStats *pStats, int bFound, unsigned int nProbes)
+{
+	HASH_STATS_ADD(pStats, nLookups, 1);
+	if (bFound)
+	{
+		HASH_STATS_ADD(pStats, nHits, 1);
+	}
+	else
+	{
+		HASH_STATS_ADD(pStats, nMisses, 1);
+	}
+	HASH_STATS_ADD(pStats, nProbes, nProbes);
+	HASH_STATS_MAX(pStats, nMaxProbe, nProbes);
+}
+
+/**
+ * @brief Add counters of all slots together, max probe is the max of all slots.
+ *
+ * @param slots Counter slots of a hash information.
+ * @param pStats Save counters.
+ */
+static inline void SumHashStats(HashStatsSlot *slots, HashStats *pStats)
+{
+	memset(pStats, 0, sizeof(HashStats));
+	for (int i=0; i<HASH_STATS_THREADS; ++i)
+	{
+		HashStats *pSlot = &slots[i].stats;
+		pStats->nLookups += __atomic_load_n(&pSlot->nLookups, __ATOMIC_RELAXED);
+		pStats->nHits += __atomic_load_n(&pSlot->nHits, __ATOMIC_RELAXED);
+		pStats->nMisses += __atomic_load_n(&pSlot->nMisses, __ATOMIC_RELAXED);
+		pStats->nProbes += __atomic_load_n(&pSlot->nProbes, __ATOMIC_RELAXED);
+		pStats->nCompares += __atomic_load_n(&pSlot->nCompares, __ATOMIC_RELAXED);
+		pStats->nHashMismatches += __atomic_load_n(&pSlot->nHashMismatches, __ATOMIC_RELAXED);
+		pStats->nFilterRejects += __atomic_load_n(&pSlot->nFilterRejects, __ATOMIC_RELAXED);
+		pStats->nMaxProbe = MAX(pStats->nMaxProbe, __atomic_load_n(&pSlot->nMaxProbe, __ATOMIC_RELAXED));
+	}
+}
+
+#else
+
+// Arguments are only cast to void, so counting code needs no #ifdef and compiles to nothing.
+#define HASH_STATS_OF(pHashInf) ((HashStats *)NULL)
+#define HASH_STATS_ADD(pStats, field, n) ((void)(pStats), (void)(n))
+#define HASH_STATS_MAX(pStats, field, n) ((void)(pStats), (void)(n))
+#define CountHashSearch(pStats, bFound, nProbes) ((void)(pStats), (void)(bFound), (void)(nProbes))
+
+#endif
+
+#endif /* HASHSTATS_H_ */
@@ -16,8 +16,11 @@
 #include "NormalHash/Hash.h"
 #else
 #include "MPQHash/Hash.h"
+#include "MPQHash/ConcurrentHash.h"
 #endif
 #include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
 #include <time.h>
 #include <sys/time.h>
 
@@ -31,8 +34,16 @@ typedef struct TestStruct
 #define ITEM_NUM 999999
 #define STR_LEN 63
 #define FIND_THIS_NODE_IN_LIST 987654
+#define MISS_TABLE_SIZE 4096
+#define MISS_LOOKUP_NUM 100000
+#define MISS_PERCENT 70
+#define CONCURRENT_READER_NUM 4
+#define CONCURRENT_ITEM_NUM 10000
+#define CONCURRENT_WRITE_NUM 200000
 #ifdef TEST_LIST_HASH
 #define DEFAULT_HASH_METHOD BKDRHash
+#define DEFAULT_HASH_LOOKUP GetStringAddressBKDRHash
+#define DEFAULT_HASH_LAYOUT HASH_LAYOUT_CHAINED
 #endif
 
 char *GetNextStr(void **pNode)
@@ -90,7 +101,7 @@ int TestHashList()
 	// Hash search
 	gettimeofday(&startTime,NULL);
 #ifdef TEST_LIST_HASH
-	HashInf *pHashInf = HashFromList(ITEM_NUM, &head, GetNextStr, DEFAULT_HASH_METHOD);
+	HashInf *pHashInf = HashFromListEx(ITEM_NUM, &head, GetNextStr, DEFAULT_HASH_METHOD, DEFAULT_HASH_LAYOUT);
 #else
 	HashInf *pHashInf = HashFromList(ITEM_NUM, GetNextStr, &head);
 #endif
@@ -103,7 +114,11 @@ int TestHashList()
 	gettimeofday(&endTime,NULL);
 	costTime = 1000 * 1000 * (endTime.tv_sec - startTime.tv_sec) + endTime.tv_usec - startTime.tv_usec;
 	printf("Hash searched str:%s, cost %llu us.\n", NULL != findResult ? findResult : "string NOT found!", costTime);
+	gettimeofday(&startTime,NULL);
 	DeleteHashInf(&pHashInf);
+	gettimeofday(&endTime,NULL);
+	costTime = 1000 * 1000 * (endTime.tv_sec - startTime.tv_sec) + endTime.tv_usec - startTime.tv_usec;
+	printf("Delete hash table cost %llu us.\n", costTime);
 
 	currNode = head.next;
 	while(NULL != currNode)
@@ -151,7 +166,7 @@ int TestHashArray()
 	// Hash table search
 	gettimeofday(&startTime,NULL);
 #ifdef TEST_LIST_HASH
-	HashInf *pHashInf = HashFromArray(ITEM_NUM, array, DEFAULT_HASH_METHOD);
+	HashInf *pHashInf = HashFromArrayEx(ITEM_NUM, array, DEFAULT_HASH_METHOD, DEFAULT_HASH_LAYOUT);
 #else
 	HashInf *pHashInf = HashFromArray(ITEM_NUM, array);
 #endif
@@ -159,13 +174,217 @@ int TestHashArray()
 	costTime = 1000 * 1000 * (endTime.tv_sec - startTime.tv_sec) + endTime.tv_usec - startTime.tv_usec;
 	printf("Create hash table cost %llu us.\n", costTime);
 
+	// Same table built by one thread for each CPU.
+	gettimeofday(&startTime,NULL);
+#ifdef TEST_LIST_HASH
+	HashInf *pParallelHashInf = HashFromArrayParallel(ITEM_NUM, array, DEFAULT_HASH_METHOD, DEFAULT_HASH_LAYOUT, 0);
+#else
+	HashInf *pParallelHashInf = HashFromArrayParallel(ITEM_NUM, array, 0);
+#endif
+	gettimeofday(&endTime,NULL);
+	costTime = 1000 * 1000 * (endTime.tv_sec - startTime.tv_sec) + endTime.tv_usec - startTime.tv_usec;
+	printf("Create hash table in parallel cost %llu us.\n", costTime);
+	DeleteHashInf(&pParallelHashInf);
+
 	gettimeofday(&startTime,NULL);
 	char *findResult = (char *)GetStringAddress(pHashInf, findStr);
 	gettimeofday(&endTime,NULL);
 	costTime = 1000 * 1000 * (endTime.tv_sec - startTime.tv_sec) + endTime.tv_usec - startTime.tv_usec;
 	printf("Hash searched str:%s, used %llu us.\n", NULL != findResult ? findResult : "string NOT found!", costTime);
 
+	// Search every string one by one, then all in one batch.
+	void **batchResult = (void **)malloc(sizeof(void *)*(ITEM_NUM));
+	gettimeofday(&startTime,NULL);
+	for (int i=0; i<ITEM_NUM; ++i)
+	{
+		batchResult[i] = GetStringAddress(pHashInf, array[i]);
+	}
+	gettimeofday(&endTime,NULL);
+	costTime = 1000 * 1000 * (endTime.tv_sec - startTime.tv_sec) + endTime.tv_usec - startTime.tv_usec;
+	printf("Hash searched %d strings one by one, used %llu us.\n", ITEM_NUM, costTime);
+
+	gettimeofday(&startTime,NULL);
+	GetStringAddressBatch(pHashInf, (const char **)array, ITEM_NUM, batchResult);
+	gettimeofday(&endTime,NULL);
+	costTime = 1000 * 1000 * (endTime.tv_sec - startTime.tv_sec) + endTime.tv_usec - startTime.tv_usec;
+	printf("Hash searched %d strings in batch, used %llu us.\n", ITEM_NUM, costTime);
+
+	// Lengths known in advance, as for keys cut out of a buffer.
+	size_t *keyLen = (size_t *)malloc(sizeof(size_t)*(ITEM_NUM));
+	for (int i=0; i<ITEM_NUM; ++i)
+	{
+		keyLen[i] = strlen(array[i]);
+	}
+	gettimeofday(&startTime,NULL);
+	for (int i=0; i<ITEM_NUM; ++i)
+	{
+		batchResult[i] = GetKeyAddress(pHashInf, array[i], keyLen[i]);
+	}
+	gettimeofday(&endTime,NULL);
+	costTime = 1000 * 1000 * (endTime.tv_sec - startTime.tv_sec) + endTime.tv_usec - startTime.tv_usec;
+	printf("Hash searched %d keys with length, used %llu us.\n", ITEM_NUM, costTime);
+	FREE(keyLen);
+
+#ifdef TEST_LIST_HASH
+	// Lookup compiled for the hash method, no call through function pointer.
+	gettimeofday(&startTime,NULL);
+	for (int i=0; i<ITEM_NUM; ++i)
+	{
+		batchResult[i] = DEFAULT_HASH_LOOKUP(pHashInf, array[i]);
+	}
+	gettimeofday(&endTime,NULL);
+	costTime = 1000 * 1000 * (endTime.tv_sec - startTime.tv_sec) + endTime.tv_usec - startTime.tv_usec;
+	printf("Hash searched %d strings by lookup of hash method, used %llu us.\n", ITEM_NUM, costTime);
+#endif
+#ifdef HASH_MAP_VALUES
+	// Map each string to it's index, value comes from the item the probe ends on.
+	int wrongValue = 0;
+	for (int i=0; i<ITEM_NUM; ++i)
+	{
+		UpsertStringValue(pHashInf, array[i], (void *)(intptr_t)(i + 1));
+	}
+	gettimeofday(&startTime,NULL);
+	for (int i=0; i<ITEM_NUM; ++i)
+	{
+		batchResult[i] = GetStringValue(pHashInf, array[i]);
+	}
+	gettimeofday(&endTime,NULL);
+	costTime = 1000 * 1000 * (endTime.tv_sec - startTime.tv_sec) + endTime.tv_usec - startTime.tv_usec;
+	for (int i=0; i<ITEM_NUM; ++i)
+	{
+		// Same string may be generated twice, then it maps to the last index.
+		intptr_t nIndex = (intptr_t)batchResult[i];
+		wrongValue += ((nIndex < 1) || (nIndex > ITEM_NUM) || (0 != strcmp(array[nIndex-1], array[i]))) ? 1 : 0;
+	}
+	printf("Hash searched %d values, used %llu us, %d wrong.\n", ITEM_NUM, costTime, wrongValue);
+#endif
+
+	// Copy keys into a pool owned by hash table, compares no longer touch the scattered strings of array.
+	gettimeofday(&startTime,NULL);
+	InternKeys(pHashInf);
+	gettimeofday(&endTime,NULL);
+	costTime = 1000 * 1000 * (endTime.tv_sec - startTime.tv_sec) + endTime.tv_usec - startTime.tv_usec;
+	printf("Intern keys cost %llu us.\n", costTime);
+
+	gettimeofday(&startTime,NULL);
+	for (int i=0; i<ITEM_NUM; ++i)
+	{
+		batchResult[i] = GetStringAddress(pHashInf, array[i]);
+	}
+	gettimeofday(&endTime,NULL);
+	costTime = 1000 * 1000 * (endTime.tv_sec - startTime.tv_sec) + endTime.tv_usec - startTime.tv_usec;
+	int notCopied = 0;
+	for (int i=0; i<ITEM_NUM; ++i)
+	{
+		notCopied += (IS_NULL(batchResult[i]) || (batchResult[i] == array[i])
+				|| (0 != strcmp((char *)batchResult[i], array[i]))) ? 1 : 0;
+	}
+	printf("Hash searched %d interned strings, used %llu us, %d not copied.\n", ITEM_NUM, costTime, notCopied);
+
+#ifndef TEST_LIST_HASH
+	// Hash values alone decide a hit by default, compare keys as well.
+	SetKeyCheck(pHashInf, HASH_CHECK_KEY);
+	gettimeofday(&startTime,NULL);
+	for (int i=0; i<ITEM_NUM; ++i)
+	{
+		batchResult[i] = GetStringAddress(pHashInf, array[i]);
+	}
+	gettimeofday(&endTime,NULL);
+	costTime = 1000 * 1000 * (endTime.tv_sec - startTime.tv_sec) + endTime.tv_usec - startTime.tv_usec;
+	int notVerified = 0;
+	for (int i=0; i<ITEM_NUM; ++i)
+	{
+		notVerified += (IS_NULL(batchResult[i]) || (0 != strcmp((char *)batchResult[i], array[i]))) ? 1 : 0;
+	}
+	printf("Hash searched %d strings verifying keys, used %llu us, %d not verified.\n", ITEM_NUM, costTime, notVerified);
+
+	// Keys cut out of a buffer have no '\0' after them, verifying compares them by their own length.
+	const char *sliceBuffer = "helloworld";
+	const void *sliceKeys[] = {sliceBuffer, sliceBuffer + 5};
+	size_t sliceLens[] = {5, 5};
+	// Kept without their length, they can not be verified.
+	HashInf *pSliceInf = HashFromKeys(ARRAY_SIZE(sliceKeys), sliceKeys, sliceLens);
+	int sliceWrong = (FAILED == SetKeyCheck(pSliceInf, HASH_CHECK_KEY)) ? 0 : 1;
+	DeleteHashInf(&pSliceInf);
+	// Inserted after verifying is set, they are copied with their length.
+	pSliceInf = HashFromKeys(0, NULL, NULL);
+	SetKeyCheck(pSliceInf, HASH_CHECK_KEY);
+	for (int i=0; i<(int)ARRAY_SIZE(sliceKeys); ++i)
+	{
+		InsertKey(pSliceInf, sliceKeys[i], sliceLens[i]);
+	}
+	char *sliceFound = (char *)GetKeyAddress(pSliceInf, "hello", 5);
+	sliceWrong += (IS_NULL(sliceFound) || (0 != memcmp(sliceFound, "hello", 5))) ? 1 : 0;
+	sliceFound = (char *)GetKeyAddress(pSliceInf, "world", 5);
+	sliceWrong += (IS_NULL(sliceFound) || (0 != memcmp(sliceFound, "world", 5))) ? 1 : 0;
+	sliceWrong += IS_NOT_NULL(GetKeyAddress(pSliceInf, sliceBuffer, 10)) ? 1 : 0;
+	sliceWrong += IS_NOT_NULL(GetStringAddress(pSliceInf, "hell")) ? 1 : 0;
+	printf("Hash verified 5 checks of keys cut out of a buffer, %d wrong.\n", sliceWrong);
+	DeleteHashInf(&pSliceInf);
+#endif
+	FREE(batchResult);
+
+	gettimeofday(&startTime,NULL);
 	DeleteHashInf(&pHashInf);
+	gettimeofday(&endTime,NULL);
+	costTime = 1000 * 1000 * (endTime.tv_sec - startTime.tv_sec) + endTime.tv_usec - startTime.tv_usec;
+	printf("Delete hash table cost %llu us.\n", costTime);
+	for (int i=0; i<ITEM_NUM; ++i)
+	{
+		FREE(array[i]);
+	}
+	FREE(array);
+
+	return 0;
+}
+
+#ifndef TEST_LIST_HASH
+int TestMPQHashString()
+{
+	struct timeval startTime, endTime;
+	unsigned long long costTime = 0ULL;
+	unsigned int nHash, nHashA, nHashB, checkSum = 0;
+	int mismatch = 0;
+
+	char **array = (char **)malloc(sizeof(char *)*(ITEM_NUM));
+	for (int i=0; i<ITEM_NUM; ++i)
+	{
+		array[i] = rand_str(STR_LEN);
+	}
+
+	// Three passes over each string, how InsertHash and GetHashTablePos used to hash.
+	gettimeofday(&startTime,NULL);
+	for (int i=0; i<ITEM_NUM; ++i)
+	{
+		checkSum += HashString(array[i], 0) ^ HashString(array[i], 1) ^ HashString(array[i], 2);
+	}
+	gettimeofday(&endTime,NULL);
+	costTime = 1000 * 1000 * (endTime.tv_sec - startTime.tv_sec) + endTime.tv_usec - startTime.tv_usec;
+	printf("HashString x3 hashed %d strings, used %llu us.\n", ITEM_NUM, costTime);
+
+	// One pass over each string.
+	gettimeofday(&startTime,NULL);
+	for (int i=0; i<ITEM_NUM; ++i)
+	{
+		HashString3(array[i], &nHash, &nHashA, &nHashB);
+		checkSum -= nHash ^ nHashA ^ nHashB;
+	}
+	gettimeofday(&endTime,NULL);
+	costTime = 1000 * 1000 * (endTime.tv_sec - startTime.tv_sec) + endTime.tv_usec - startTime.tv_usec;
+	printf("HashString3 hashed %d strings, used %llu us.\n", ITEM_NUM, costTime);
+
+	// Both ways must give the same hash values.
+	for (int i=0; i<ITEM_NUM; ++i)
+	{
+		HashString3(array[i], &nHash, &nHashA, &nHashB);
+		if ((nHash != HashString(array[i], 0)) || (nHashA != HashString(array[i], 1))
+				|| (nHashB != HashString(array[i], 2)))
+		{
+			++mismatch;
+		}
+	}
+	printf("HashString3 check sum:%u, mismatched %d strings.\n", checkSum, mismatch);
+
 	for (int i=0; i<ITEM_NUM; ++i)
 	{
 		FREE(array[i]);
@@ -175,10 +394,285 @@ int TestHashArray()
 	return 0;
 }
 
+int TestMPQMissPath()
+{
+	struct timeval startTime, endTime;
+	unsigned long long costTime = 0ULL;
+	unsigned int nMaxProbe = 0;
+	int found = 0, foundBounded = 0, foundRobinHood = 0;
+
+	// Fill every item but one, a missing string then runs to that one unless probe ends earlier.
+	struct HashItem *lpTable = InitHashTable(MISS_TABLE_SIZE);
+	struct HashItem *lpRobinHoodTable = InitHashTable(MISS_TABLE_SIZE);
+	char **array = (char **)malloc(sizeof(char *)*(MISS_TABLE_SIZE));
+	for (int i=0; i<MISS_TABLE_SIZE-1; ++i)
+	{
+		array[i] = rand_str(STR_LEN);
+		int position = InsertHash(array[i], lpTable, MISS_TABLE_SIZE);
+		nMaxProbe = MAX(nMaxProbe, HashItemProbeLen(position, HashString(array[i], 0), MISS_TABLE_SIZE));
+		InsertHashRobinHood(array[i], lpRobinHoodTable, MISS_TABLE_SIZE);
+	}
+
+	// MISS_PERCENT of lookups are for strings never inserted.
+	char **missArray = (char **)malloc(sizeof(char *)*(MISS_LOOKUP_NUM));
+	const char **lookups = (const char **)malloc(sizeof(char *)*(MISS_LOOKUP_NUM));
+	for (int i=0; i<MISS_LOOKUP_NUM; ++i)
+	{
+		missArray[i] = rand_str(STR_LEN);
+		lookups[i] = (i % 100 < MISS_PERCENT) ? missArray[i] : array[i % (MISS_TABLE_SIZE-1)];
+	}
+
+	gettimeofday(&startTime,NULL);
+	for (int i=0; i<MISS_LOOKUP_NUM; ++i)
+	{
+		found += (-1 != GetHashTablePos(lookups[i], lpTable, MISS_TABLE_SIZE)) ? 1 : 0;
+	}
+	gettimeofday(&endTime,NULL);
+	costTime = 1000 * 1000 * (endTime.tv_sec - startTime.tv_sec) + endTime.tv_usec - startTime.tv_usec;
+	printf("Full table searched %d strings, %d%% missing, used %llu us, %d found.\n",
+			MISS_LOOKUP_NUM, MISS_PERCENT, costTime, found);
+
+	gettimeofday(&startTime,NULL);
+	for (int i=0; i<MISS_LOOKUP_NUM; ++i)
+	{
+		foundBounded += (-1 != GetHashTablePosBounded(lookups[i], lpTable, MISS_TABLE_SIZE, nMaxProbe)) ? 1 : 0;
+	}
+	gettimeofday(&endTime,NULL);
+	costTime = 1000 * 1000 * (endTime.tv_sec - startTime.tv_sec) + endTime.tv_usec - startTime.tv_usec;
+	printf("Full table searched %d strings within max probe %u, used %llu us, %d found.\n",
+			MISS_LOOKUP_NUM, nMaxProbe, costTime, foundBounded);
+
+	gettimeofday(&startTime,NULL);
+	for (int i=0; i<MISS_LOOKUP_NUM; ++i)
+	{
+		foundRobinHood += (-1 != GetHashTablePosRobinHood(lookups[i], lpRobinHoodTable, MISS_TABLE_SIZE)) ? 1 : 0;
+	}
+	gettimeofday(&endTime,NULL);
+	costTime = 1000 * 1000 * (endTime.tv_sec - startTime.tv_sec) + endTime.tv_usec - startTime.tv_usec;
+	printf("Full table in Robin Hood order searched %d strings, used %llu us, %d found.\n",
+			MISS_LOOKUP_NUM, costTime, foundRobinHood);
+
+	// Hash information puts items by Robin Hood order itself.
+	HashInf *pHashInf = HashFromArray(MISS_TABLE_SIZE-1, array);
+	found = 0;
+	gettimeofday(&startTime,NULL);
+	for (int i=0; i<MISS_LOOKUP_NUM; ++i)
+	{
+		found += IS_NOT_NULL(GetStringAddress(pHashInf, lookups[i])) ? 1 : 0;
+	}
+	gettimeofday(&endTime,NULL);
+	costTime = 1000 * 1000 * (endTime.tv_sec - startTime.tv_sec) + endTime.tv_usec - startTime.tv_usec;
+	printf("Hash searched %d strings, %d%% missing, used %llu us, %d found.\n",
+			MISS_LOOKUP_NUM, MISS_PERCENT, costTime, found);
+
+	// Most missing strings are rejected by key filter without probing.
+	BuildKeyFilter(pHashInf);
+	found = 0;
+	gettimeofday(&startTime,NULL);
+	for (int i=0; i<MISS_LOOKUP_NUM; ++i)
+	{
+		found += IS_NOT_NULL(GetStringAddress(pHashInf, lookups[i])) ? 1 : 0;
+	}
+	gettimeofday(&endTime,NULL);
+	costTime = 1000 * 1000 * (endTime.tv_sec - startTime.tv_sec) + endTime.tv_usec - startTime.tv_usec;
+	printf("Hash with key filter searched %d strings, used %llu us, %d found.\n",
+			MISS_LOOKUP_NUM, costTime, found);
+	DeleteHashInf(&pHashInf);
+
+	for (int i=0; i<MISS_LOOKUP_NUM; ++i)
+	{
+		FREE(missArray[i]);
+	}
+	for (int i=0; i<MISS_TABLE_SIZE-1; ++i)
+	{
+		FREE(array[i]);
+	}
+	FREE(lookups);
+	FREE(missArray);
+	FREE(array);
+	FREE(lpTable);
+	FREE(lpRobinHoodTable);
+
+	return 0;
+}
+
+/**
+ * @brief What a reader thread of TestConcurrentReaders() searches, and what it found.
+ */
+typedef struct ConcurrentReaderTask
+{
+	ConcurrentHashInf *pHashInf;
+	char **stable;               ///< Strings never removed, always found.
+	char **churn;                ///< Strings writer inserts, upserts and removes meanwhile.
+	int *pStop;                  ///< Set by main thread when writer is done.
+	unsigned long long nLookups;
+	int nErrors;
+}ConcurrentReaderTask;
+
+void *ConcurrentReader(void *pArg)
+{
+	ConcurrentReaderTask *pTask = (ConcurrentReaderTask *)pArg;
+	int nReader = RegisterReader(pTask->pHashInf);
+
+	if (-1 == nReader)
+	{
+		++pTask->nErrors;
+		return NULL;
+	}
+	for (unsigned int i=0; !__atomic_load_n(pTask->pStop, __ATOMIC_ACQUIRE); ++i)
+	{
+		const char *stable = pTask->stable[i % CONCURRENT_ITEM_NUM];
+		const char *churn = pTask->churn[i % CONCURRENT_WRITE_NUM];
+		char *found = (char *)ConcurrentGetStringAddress(pTask->pHashInf, nReader, stable);
+
+		// A stable string is always there, a churn string is there or not, never another string.
+		if (IS_NULL(found) || (0 != strcmp(found, stable)))
+		{
+			++pTask->nErrors;
+		}
+		found = (char *)ConcurrentGetStringAddress(pTask->pHashInf, nReader, churn);
+		if (IS_NOT_NULL(found) && (0 != strcmp(found, churn)))
+		{
+			++pTask->nErrors;
+		}
+		pTask->nLookups += 2;
+	}
+	UnregisterReader(pTask->pHashInf, nReader);
+	return NULL;
+}
+
+int TestConcurrentReaders()
+{
+	struct timeval startTime, endTime;
+	unsigned long long costTime = 0ULL, nLookups = 0ULL;
+	pthread_t threads[CONCURRENT_READER_NUM];
+	ConcurrentReaderTask tasks[CONCURRENT_READER_NUM];
+	int nStop = 0, nErrors = 0;
+
+	char **stable = (char **)malloc(sizeof(char *)*(CONCURRENT_ITEM_NUM));
+	char **churn = (char **)malloc(sizeof(char *)*(CONCURRENT_WRITE_NUM));
+	for (int i=0; i<CONCURRENT_ITEM_NUM; ++i)
+	{
+		stable[i] = rand_str(STR_LEN);
+	}
+	for (int i=0; i<CONCURRENT_WRITE_NUM; ++i)
+	{
+		churn[i] = rand_str(STR_LEN);
+	}
+	ConcurrentHashInf *pHashInf = ConcurrentHashFromArray(CONCURRENT_ITEM_NUM, stable);
+
+	for (int i=0; i<CONCURRENT_READER_NUM; ++i)
+	{
+		tasks[i].pHashInf = pHashInf;
+		tasks[i].stable = stable;
+		tasks[i].churn = churn;
+		tasks[i].pStop = &nStop;
+		tasks[i].nLookups = 0;
+		tasks[i].nErrors = 0;
+		pthread_create(&threads[i], NULL, ConcurrentReader, &tasks[i]);
+	}
+
+	// Writer grows table many times and retires old ones while readers search them.
+	gettimeofday(&startTime,NULL);
+	for (int i=0; i<CONCURRENT_WRITE_NUM; ++i)
+	{
+		nErrors += (SUCCEED == ConcurrentInsertString(pHashInf, churn[i])) ? 0 : 1;
+	}
+	for (int i=0; i<CONCURRENT_WRITE_NUM; i+=2)
+	{
+		nErrors += (SUCCEED == ConcurrentUpsertString(pHashInf, churn[i])) ? 0 : 1;
+	}
+	for (int i=0; i<CONCURRENT_WRITE_NUM; ++i)
+	{
+		nErrors += (SUCCEED == ConcurrentRemoveString(pHashInf, churn[i])) ? 0 : 1;
+	}
+	gettimeofday(&endTime,NULL);
+	costTime = 1000 * 1000 * (endTime.tv_sec - startTime.tv_sec) + endTime.tv_usec - startTime.tv_usec;
+
+	__atomic_store_n(&nStop, 1, __ATOMIC_RELEASE);
+	for (int i=0; i<CONCURRENT_READER_NUM; ++i)
+	{
+		pthread_join(threads[i], NULL);
+		nLookups += tasks[i].nLookups;
+		nErrors += tasks[i].nErrors;
+	}
+	printf("Concurrent table: %d readers searched %llu strings while writer changed %d strings in %llu us, "
+			"%d errors.\n", CONCURRENT_READER_NUM, nLookups, CONCURRENT_WRITE_NUM, costTime, nErrors);
+
+	DeleteConcurrentHashInf(&pHashInf);
+	for (int i=0; i<CONCURRENT_ITEM_NUM; ++i)
+	{
+		FREE(stable[i]);
+	}
+	for (int i=0; i<CONCURRENT_WRITE_NUM; ++i)
+	{
+		FREE(churn[i]);
+	}
+	FREE(stable);
+	FREE(churn);
+
+	return nErrors;
+}
+#else
+int TestListHashMethods()
+{
+	struct timeval startTime, endTime;
+	unsigned long long costTime = 0ULL;
+	unsigned int checkSum = 0;
+	const struct
+	{
+		const char *name;
+		unsigned int (*HashMethod)(const char *);
+	}methods[] =
+	{
+		{"BKDRHash", BKDRHash},
+		{"DJBHash", DJBHash},
+		{"SDBMHash", SDBMHash},
+		{"APHash", APHash},
+		{"WordHash", WordHash},
+		{"VectorHash", VectorHash},
+	};
+
+	char **array = (char **)malloc(sizeof(char *)*(ITEM_NUM));
+	for (int i=0; i<ITEM_NUM; ++i)
+	{
+		array[i] = rand_str(STR_LEN);
+	}
+
+	for (unsigned int m=0; m<ARRAY_SIZE(methods); ++m)
+	{
+		gettimeofday(&startTime,NULL);
+		for (int i=0; i<ITEM_NUM; ++i)
+		{
+			checkSum += (*methods[m].HashMethod)(array[i]);
+		}
+		gettimeofday(&endTime,NULL);
+		costTime = 1000 * 1000 * (endTime.tv_sec - startTime.tv_sec) + endTime.tv_usec - startTime.tv_usec;
+		printf("%s hashed %d strings, used %llu us.\n", methods[m].name, ITEM_NUM, costTime);
+	}
+	printf("Hash method check sum:%u.\n", checkSum);
+
+	for (int i=0; i<ITEM_NUM; ++i)
+	{
+		FREE(array[i]);
+	}
+	FREE(array);
+
+	return 0;
+}
+#endif
+
 int main()
 {
 	//TestHashList();
 	TestHashArray();
+#ifndef TEST_LIST_HASH
+	TestMPQHashString();
+	TestMPQMissPath();
+	TestConcurrentReaders();
+#else
+	TestListHashMethods();
+#endif
 
 	return 0;
 }
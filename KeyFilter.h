@@ -0,0 +1,187 @@
+/**
+ * @file   KeyFilter.h
+ *
+ * @date   Oct 16, 2026
+ * @author WangLiang
+ * @email  liang.wang@elektrobit.com
+ *
+ * @brief  Blocked bloom filter checked before hash table, shared by MPQHash and NormalHash.
+ *
+ * Data structure:
+ *
+ *   block 0          block 1                       block nBlocks-1
+ * +----------------+----------------+-------+----------------+
+ * | 8 x 32 bits    | 8 x 32 bits    |  ...  | 8 x 32 bits    |
+ * +----------------+----------------+-------+----------------+
+ *
+ *   A key is filtered by the hash key hash table already computed for it, it is not hashed again. Hash
+ * key is mixed, high bits of the mix choose a block of 32 bytes, and one bit is set in each word of it.
+ * So a check reads one cache line, a key whose bits are not all set was never added and needs no search.
+ * A key which was added is never filtered out, other keys pass by a small chance, about 1% with
+ * KEY_FILTER_BITS_PER_KEY. Bits are never cleared, a removed key keeps passing until filter is built
+ * again, which hash information does when it's table grows.
+ */
+
+#ifndef KEYFILTER_H_
+#define KEYFILTER_H_
+
+#include "CProjectDfn.h"
+
+/**
+ * @brief Bits of filter for each key it is sized for.
+ */
+#define KEY_FILTER_BITS_PER_KEY 10
+
+/**
+ * @brief Words of a block, one bit is set in each.
+ */
+#define KEY_FILTER_BLOCK_WORDS 8
+
+/**
+ * @brief A block, half of a cache line.
+ */
+typedef struct KeyFilterBlock
+{
+	unsigned int words[KEY_FILTER_BLOCK_WORDS];
+}__attribute__ ((aligned (32))) KeyFilterBlock;
+
+/**
+ * @brief Key filter information.
+ */
+typedef struct KeyFilter
+{
+	KeyFilterBlock *pBlocks;      ///< Blocks of filter, NULL if no filter, then every key passes.
+	unsigned int nBlocks;         ///< Number of blocks.
+}KeyFilter;
+
+/**
+ * @brief Mix hash key, some hash methods leave high bits unused or badly spread.
+ */
+static inline unsigned int KeyFilterMix(unsigned int nHash)
+{
+	nHash ^= nHash >> 16;
+	nHash *= 0x85ebca6bU;
+	nHash ^= nHash >> 13;
+	nHash *= 0xc2b2ae35U;
+	nHash ^= nHash >> 16;
+	return nHash;
+}
+
+/**
+ * @brief Get bit of a key in one word of it's block.
+ *
+ * @param nMixed Mixed hash key of key.
+ * @param i Index of word.
+ * @return Bit mask with one bit set.
+ */
+static inline unsigned int KeyFilterBit(unsigned int nMixed, int i)
+{
+	// Odd constants, each word takes a different top 5 bits of the product.
+	static const unsigned int salts[KEY_FILTER_BLOCK_WORDS] =
+	{
+		0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+		0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U,
+	};
+	return 1U << ((nMixed * salts[i]) >> 27);
+}
+
+/**
+ * @brief Get block of a key from high bits of it's mixed hash key.
+ */
+static inline KeyFilterBlock *KeyFilterBlockOf(const KeyFilter *pFilter, unsigned int nMixed)
+{
+	return &(pFilter->pBlocks[((unsigned long long)nMixed * pFilter->nBlocks) >> 32]);
+}
+
+/**
+ * @brief Initialize a key filter, no filter until KeyFilterCreate().
+ * @param pFilter Which filter to initialize.
+ */
+static inline void KeyFilterInit(KeyFilter *pFilter)
+{
+	pFilter->pBlocks = NULL;
+	pFilter->nBlocks = 0;
+}
+
+/**
+ * @brief Release blocks of a key filter, every key passes afterwards.
+ * @param pFilter Which filter to release.
+ */
+static inline void KeyFilterDestroy(KeyFilter *pFilter)
+{
+	FREE(pFilter->pBlocks);
+	KeyFilterInit(pFilter);
+}
+
+/**
+ * @brief Create an empty key filter, blocks of an old one are released.
+ *
+ * @param pFilter Which filter to create.
+ * @param nKeys Number of keys filter is sized for.
+ * @return SUCCEED, or FAILED if no memory, then there is no filter.
+ */
+static inline int KeyFilterCreate(KeyFilter *pFilter, unsigned long long nKeys)
+{
+	unsigned long long nBlocks = (nKeys * KEY_FILTER_BITS_PER_KEY + sizeof(KeyFilterBlock) * 8 - 1)
+			/ (sizeof(KeyFilterBlock) * 8);
+	void *pBlocks = NULL;
+
+	KeyFilterDestroy(pFilter);
+	nBlocks = CLAMP(nBlocks, 1ULL, 0xFFFFFFFFULL);
+	if (0 != posix_memalign(&pBlocks, 64, sizeof(KeyFilterBlock) * nBlocks))
+	{
+		return FAILED;
+	}
+	memset(pBlocks, 0, sizeof(KeyFilterBlock) * nBlocks);
+	pFilter->pBlocks = (KeyFilterBlock *)pBlocks;
+	pFilter->nBlocks = (unsigned int)nBlocks;
+	return SUCCEED;
+}
+
+/**
+ * @brief Add a key to key filter.
+ *
+ * @param pFilter Which filter to add to, nothing is done if there is no filter.
+ * @param nHash Hash key of key, computed by hash table.
+ */
+static inline void KeyFilterAdd(KeyFilter *pFilter, unsigned int nHash)
+{
+	if (IS_NULL(pFilter->pBlocks))
+	{
+		return;
+	}
+	unsigned int nMixed = KeyFilterMix(nHash);
+	KeyFilterBlock *pBlock = KeyFilterBlockOf(pFilter, nMixed);
+	for (int i=0; i<KEY_FILTER_BLOCK_WORDS; ++i)
+	{
+		pBlock->words[i] |= KeyFilterBit(nMixed, i);
+	}
+}
+
+/**
+ * @brief Check whether a key may be in hash table.
+ *
+ * @param pFilter Which filter to check.
+ * @param nHash Hash key of key, computed by hash table.
+ * @return NO if key was never added, YES if it may have been or there is no filter.
+ */
+static inline bool_t KeyFilterMayContain(const KeyFilter *pFilter, unsigned int nHash)
+{
+	if (IS_NULL(pFilter->pBlocks))
+	{
+		return YES;
+	}
+	unsigned int nMixed = KeyFilterMix(nHash);
+	const KeyFilterBlock *pBlock = KeyFilterBlockOf(pFilter, nMixed);
+	unsigned int nMissing = 0;
+
+	// No branch in loop, compiler may check all words at once.
+	for (int i=0; i<KEY_FILTER_BLOCK_WORDS; ++i)
+	{
+		unsigned int nBit = KeyFilterBit(nMixed, i);
+		nMissing |= (pBlock->words[i] & nBit) ^ nBit;
+	}
+	return (0 == nMissing) ? YES : NO;
+}
+
+#endif /* KEYFILTER_H_ */
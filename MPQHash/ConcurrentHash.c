@@ -0,0 +1,369 @@
+/**
+ * @file   MPQHash/ConcurrentHash.c
+ *
+ * @date   Oct 16, 2026
+ * @author WangLiang
+ * @email  liang.wang@elektrobit.com
+ *
+ * @brief  MPQ hash table searched by many threads without lock while one thread changes it.
+ */
+
+#include "ConcurrentHash.h"
+
+/**
+ * @brief Create a table, all items are empty.
+ * @param nTableSize Number of items.
+ * @return Created table, or NULL if no memory.
+ */
+static ConcurrentTable *CreateTable(int nTableSize)
+{
+	ConcurrentTable *pTable = (ConcurrentTable *)malloc(sizeof(ConcurrentTable) + sizeof(HashItem) * nTableSize);
+	if (IS_NULL(pTable))
+	{
+		return NULL;
+	}
+	pTable->nTableSize = nTableSize;
+	pTable->pNext = NULL;
+	pTable->nRetireEpoch = 0;
+	for (int i=0; i<nTableSize; ++i)
+	{
+		pTable->items[i].HASH_ITEM_STATE = HASH_ITEM_EMPTY;
+	}
+	return pTable;
+}
+
+/**
+ * @brief Fill an empty item and publish it, readers see it whole or not at all.
+ *
+ * @param pTable Which table to put into, writer only.
+ * @param nHash Offset hash.
+ * @param nHashA Hash A.
+ * @param nHashB Hash B.
+ * @param pAddr Address of item.
+ */
+static void PublishItem(ConcurrentTable *pTable, unsigned int nHash, unsigned int nHashA, unsigned int nHashB,
+		void *pAddr)
+{
+	unsigned int nHashPos = nHash % pTable->nTableSize;
+	HashItem *pItem;
+
+	// Deleted items are not reused, a reader may still be comparing their hash values.
+	while (HASH_ITEM_EMPTY != pTable->items[nHashPos].HASH_ITEM_STATE)
+	{
+		nHashPos = (nHashPos + 1) % pTable->nTableSize;
+	}
+	pItem = &(pTable->items[nHashPos]);
+	FillHashItem(pItem, nHash, nHashA, nHashB, pAddr);
+	__atomic_store_n(&(pItem->HASH_ITEM_STATE), HashItemWord(nHashA), __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Free retired tables no active reader can be reading, writer only.
+ * @param pHashInf Which hash information to clean.
+ */
+static void FreeRetiredTables(ConcurrentHashInf *pHashInf)
+{
+	unsigned long long nOldest = __atomic_load_n(&(pHashInf->nEpoch), __ATOMIC_SEQ_CST);
+	ConcurrentTable **ppTable = &(pHashInf->pRetired);
+
+	// Oldest epoch saved by a reader still searching.
+	for (int i=0; i<MAX_READER_THREADS; ++i)
+	{
+		unsigned long long nEpoch = __atomic_load_n(&(pHashInf->readers[i].nEpoch), __ATOMIC_SEQ_CST);
+		if ((0 != nEpoch) && (nEpoch < nOldest))
+		{
+			nOldest = nEpoch;
+		}
+	}
+
+	// A reader that started after table was retired can not see it.
+	while (IS_NOT_NULL(*ppTable))
+	{
+		ConcurrentTable *pTable = *ppTable;
+		if (pTable->nRetireEpoch < nOldest)
+		{
+			*ppTable = pTable->pNext;
+			FREE(pTable);
+		}
+		else
+		{
+			ppTable = &(pTable->pNext);
+		}
+	}
+}
+
+/**
+ * @brief Copy existing items into a new table and publish it, old table is retired, writer only.
+ *
+ *   New table is twice bigger, or same size if most used items are deleted ones.
+ *
+ * @param pHashInf Which hash information to grow.
+ * @return SUCCEED, or FAILED if no memory.
+ */
+static int GrowTable(ConcurrentHashInf *pHashInf)
+{
+	ConcurrentTable *pOldTable = pHashInf->pTable;
+	ConcurrentTable *pNewTable;
+	int nNewSize = pOldTable->nTableSize;
+
+	if (pHashInf->nItemNum + 1 > pHashInf->fMaxLoadFactor * nNewSize / 2)
+	{
+		nNewSize *= 2;
+	}
+	pNewTable = CreateTable(nNewSize);
+	if (IS_NULL(pNewTable))
+	{
+		return FAILED;
+	}
+	for (int i=0; i<pOldTable->nTableSize; ++i)
+	{
+		HashItem *pItem = &(pOldTable->items[i]);
+		if (HASH_ITEM_EXISTS == HashItemState(pItem))
+		{
+			PublishItem(pNewTable, pItem->HashKey, HashItemA(pItem), HashItemB(pItem), pItem->pAddr);
+		}
+	}
+	pHashInf->nUsedNum = pHashInf->nItemNum;
+
+	// Publish new table, then start a new epoch, readers of old table all have older epochs.
+	__atomic_store_n(&(pHashInf->pTable), pNewTable, __ATOMIC_SEQ_CST);
+	pOldTable->nRetireEpoch = __atomic_fetch_add(&(pHashInf->nEpoch), 1, __ATOMIC_SEQ_CST);
+	pOldTable->pNext = pHashInf->pRetired;
+	pHashInf->pRetired = pOldTable;
+	FreeRetiredTables(pHashInf);
+	return SUCCEED;
+}
+
+/**
+ * @brief Search an item with known hash values, writer only.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param str Which string want to search.
+ * @param pHash Save offset hash of string.
+ * @param pHashA Save hash A of string.
+ * @param pHashB Save hash B of string.
+ * @return Item found, or NULL if not found.
+ */
+static HashItem *WriterFindItem(ConcurrentHashInf *pHashInf, const char *str,
+		unsigned int *pHash, unsigned int *pHashA, unsigned int *pHashB)
+{
+	ConcurrentTable *pTable = pHashInf->pTable;
+	int position;
+
+	HashString3(str, pHash, pHashA, pHashB);
+	position = FindHashItem(pTable->items, pTable->nTableSize, *pHash, *pHashA, *pHashB);
+	return (-1 != position) ? &(pTable->items[position]) : NULL;
+}
+
+/**
+ * @brief Put a new item into published table, grow it first if needed, writer only.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param nHash Offset hash.
+ * @param nHashA Hash A.
+ * @param nHashB Hash B.
+ * @param pAddr Address of item.
+ * @return SUCCEED, or FAILED if no memory.
+ */
+static int AddItem(ConcurrentHashInf *pHashInf, unsigned int nHash, unsigned int nHashA, unsigned int nHashB,
+		void *pAddr)
+{
+	if (pHashInf->nUsedNum + 1 > pHashInf->fMaxLoadFactor * pHashInf->pTable->nTableSize)
+	{
+		if (FAILED == GrowTable(pHashInf))
+		{
+			return FAILED;
+		}
+	}
+	PublishItem(pHashInf->pTable, nHash, nHashA, nHashB, pAddr);
+	++pHashInf->nItemNum;
+	++pHashInf->nUsedNum;
+	return SUCCEED;
+}
+
+/**
+ * @brief Create concurrent hash information from a array.
+ *
+ * @param itemNum Number of items in array.
+ * @param pArray Pointer pointed to array which will create hash information.
+ * @return Pointer to created hash information, or NULL if no memory.
+ */
+ConcurrentHashInf *ConcurrentHashFromArray(int itemNum, char **pArray)
+{
+	ConcurrentHashInf *pHashInf = NULL;
+
+	// Each reader epoch is on it's own cache line, malloc() only aligns to 16 bytes.
+	if (0 != posix_memalign((void **)&pHashInf, sizeof(ReaderEpoch), sizeof(ConcurrentHashInf)))
+	{
+		return NULL;
+	}
+	memset(pHashInf, 0, sizeof(ConcurrentHashInf));
+	pHashInf->pTable = CreateTable(MAX((int)(itemNum * ZOOM_TIMES_PREVENT_CONFLICT), MIN_HASH_TABLE_SIZE));
+	if (IS_NULL(pHashInf->pTable))
+	{
+		FREE(pHashInf);
+		return NULL;
+	}
+	pHashInf->fMaxLoadFactor = DEFAULT_MAX_LOAD_FACTOR;
+	pHashInf->nEpoch = 1;
+
+	// Add each string to hash table.
+	for (int i=0; i<itemNum; ++i)
+	{
+		if (FAILED == ConcurrentInsertString(pHashInf, pArray[i]))
+		{
+			DeleteConcurrentHashInf(&pHashInf);
+			return NULL;
+		}
+	}
+	return pHashInf;
+}
+
+/**
+ * @brief Delete concurrent hash information, no reader or writer may use it any more.
+ *
+ * @param pHashInf Pointer to which hash information you want to delete.
+ */
+void DeleteConcurrentHashInf(ConcurrentHashInf **pHashInf)
+{
+	ConcurrentTable *pTable, *pNextTable;
+
+	if (IS_NOT_FREED(*pHashInf))
+	{
+		for (pTable = (*pHashInf)->pRetired; IS_NOT_NULL(pTable); pTable = pNextTable)
+		{
+			pNextTable = pTable->pNext;
+			FREE(pTable);
+		}
+		SECURE_FREE((*pHashInf)->pTable);
+		FREE(*pHashInf);
+	}
+}
+
+/**
+ * @brief Get a reader index for the calling thread.
+ *
+ * @param pHashInf Which hash information will be searched.
+ * @return Reader index, or -1 if MAX_READER_THREADS readers are registered.
+ */
+int RegisterReader(ConcurrentHashInf *pHashInf)
+{
+	for (int i=0; i<MAX_READER_THREADS; ++i)
+	{
+		if (__sync_bool_compare_and_swap(&(pHashInf->readers[i].bRegistered), NO, YES))
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+/**
+ * @brief Give back a reader index, the thread must not use it afterwards.
+ *
+ * @param pHashInf Which hash information is searched.
+ * @param nReader Reader index from RegisterReader().
+ */
+void UnregisterReader(ConcurrentHashInf *pHashInf, int nReader)
+{
+	__atomic_store_n(&(pHashInf->readers[nReader].nEpoch), 0, __ATOMIC_RELEASE);
+	__atomic_store_n(&(pHashInf->readers[nReader].bRegistered), NO, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Get real string address without lock, safe while writer changes hash table.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param nReader Reader index of calling thread, from RegisterReader().
+ * @param str Which string you want to find.
+ * @return Real string address you want to search, or NULL if not found.
+ */
+void *ConcurrentGetStringAddress(ConcurrentHashInf *pHashInf, int nReader, const char *str)
+{
+	ReaderEpoch *pReader = &(pHashInf->readers[nReader]);
+	unsigned int nHash, nHashA, nHashB;
+	void *pAddr = NULL;
+	unsigned int nState;
+
+	// Hash before entering epoch, keep the time old tables are pinned short.
+	HashString3(str, &nHash, &nHashA, &nHashB);
+
+	// Save epoch before loading table, so writer can not free the table loaded.
+	__atomic_store_n(&(pReader->nEpoch), __atomic_load_n(&(pHashInf->nEpoch), __ATOMIC_SEQ_CST), __ATOMIC_SEQ_CST);
+	ConcurrentTable *pTable = __atomic_load_n(&(pHashInf->pTable), __ATOMIC_SEQ_CST);
+	unsigned int nHashStart = nHash % pTable->nTableSize, nHashPos = nHashStart;
+
+	while (HASH_ITEM_EMPTY != (nState = __atomic_load_n(&(pTable->items[nHashPos].HASH_ITEM_STATE), __ATOMIC_ACQUIRE)))
+	{
+		HashItem *pItem = &(pTable->items[nHashPos]);
+		if (IsHashItemOf(pItem, nState, nHash, nHashA, nHashB))
+		{
+			pAddr = __atomic_load_n(&(pItem->pAddr), __ATOMIC_ACQUIRE);
+			break;
+		}
+		nHashPos = (nHashPos + 1) % pTable->nTableSize;
+		if (nHashPos == nHashStart)
+		{
+			break;
+		}
+	}
+
+	__atomic_store_n(&(pReader->nEpoch), 0, __ATOMIC_RELEASE);
+	return pAddr;
+}
+
+/**
+ * @brief Insert a string, writer only, table is copied to a bigger one if needed.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param str Which string want to insert, it is not checked whether already in hash table.
+ * @return SUCCEED, or FAILED if no memory.
+ */
+int ConcurrentInsertString(ConcurrentHashInf *pHashInf, const char *str)
+{
+	unsigned int nHash, nHashA, nHashB;
+
+	HashString3(str, &nHash, &nHashA, &nHashB);
+	return AddItem(pHashInf, nHash, nHashA, nHashB, (char *)str);
+}
+
+/**
+ * @brief Remove a string, writer only.
+ *
+ * @param pHashInf Which hash information to remove from.
+ * @param str Which string want to remove.
+ * @return SUCCEED, or FAILED if string is not in hash table.
+ */
+int ConcurrentRemoveString(ConcurrentHashInf *pHashInf, const char *str)
+{
+	unsigned int nHash, nHashA, nHashB;
+	HashItem *pItem = WriterFindItem(pHashInf, str, &nHash, &nHashA, &nHashB);
+
+	if (IS_NULL(pItem))
+	{
+		return FAILED;
+	}
+	__atomic_store_n(&(pItem->HASH_ITEM_STATE), HASH_ITEM_DELETED, __ATOMIC_RELEASE);
+	--pHashInf->nItemNum;
+	return SUCCEED;
+}
+
+/**
+ * @brief Insert a string, or replace address of same string already in hash table, writer only.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param str Which string want to insert, readers get this address afterwards.
+ * @return SUCCEED, or FAILED if no memory.
+ */
+int ConcurrentUpsertString(ConcurrentHashInf *pHashInf, const char *str)
+{
+	unsigned int nHash, nHashA, nHashB;
+	HashItem *pItem = WriterFindItem(pHashInf, str, &nHash, &nHashA, &nHashB);
+
+	if (IS_NOT_NULL(pItem))
+	{
+		__atomic_store_n(&(pItem->pAddr), (void *)str, __ATOMIC_RELEASE);
+		return SUCCEED;
+	}
+	return AddItem(pHashInf, nHash, nHashA, nHashB, (char *)str);
+}
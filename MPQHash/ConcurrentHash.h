@@ -0,0 +1,145 @@
+/**
+ * @file   MPQHash/ConcurrentHash.h
+ *
+ * @date   Oct 16, 2026
+ * @author WangLiang
+ * @email  liang.wang@elektrobit.com
+ *
+ * @brief  MPQ hash table searched by many threads without lock while one thread changes it.
+ */
+
+#ifndef CONCURRENTHASH_H_
+#define CONCURRENTHASH_H_
+
+#include "../CProjectDfn.h"
+#include "MPQHash.h"
+#include "Hash.h"
+
+/**
+ * Rules:
+ *
+ *   1. Only one thread (the writer) may call ConcurrentInsertString(), ConcurrentRemoveString() and
+ *      ConcurrentUpsertString() at a time.
+ *   2. Any thread may call ConcurrentGetStringAddress() at any time, with a reader index got from
+ *      RegisterReader(), each reader index is used by only one thread.
+ *
+ *   Writer fills hash values and pAddr of an item first, then sets it's state word (HASH_ITEM_STATE) with
+ * release order, a reader reads the state word with acquire order before anything else, so it never sees a
+ * half written item.
+ * Deleted items are never reused, they are dropped when the table is copied.
+ *
+ *   When table is full enough, writer copies items into a new table and publishes it. Old table is
+ * freed only after every reader that could still be reading it has left, tracked by epochs: a reader
+ * saves global epoch when it starts a search, writer bumps global epoch after publishing a new table,
+ * and frees an old table once no active reader has saved an epoch older than the bump.
+ */
+
+/**
+ * @brief Max number of reader threads registered at the same time.
+ */
+#define MAX_READER_THREADS 128
+
+/**
+ * @brief A published table, size and items together, so readers get both with one load.
+ */
+typedef struct ConcurrentTable
+{
+	int nTableSize;                 ///< Number of items.
+	struct ConcurrentTable *pNext;  ///< Next retired table waiting to be freed, writer only.
+	unsigned long long nRetireEpoch;///< Global epoch when it is retired, writer only.
+	HashItem items[];               ///< Hash table.
+}ConcurrentTable;
+
+/**
+ * @brief Epoch of one reader, a cache line each, so readers do not slow down each other.
+ */
+typedef struct ReaderEpoch
+{
+	unsigned long long nEpoch;      ///< Global epoch when current search started, 0 if not searching.
+	int bRegistered;                ///< YES if a thread uses this index.
+}__attribute__ ((aligned (64))) ReaderEpoch;
+
+/**
+ * @brief Concurrent hash information.
+ */
+typedef struct ConcurrentHashInf
+{
+	ConcurrentTable *pTable;        ///< Published table.
+	int nItemNum;                   ///< Number of items, writer only.
+	int nUsedNum;                   ///< Number of existing and deleted items, writer only.
+	double fMaxLoadFactor;          ///< Table is copied when used items would take more than this part.
+	ConcurrentTable *pRetired;      ///< Old tables waiting until no reader uses them, writer only.
+	unsigned long long nEpoch;      ///< Global epoch.
+	ReaderEpoch readers[MAX_READER_THREADS];
+}ConcurrentHashInf;
+
+/**
+ * @brief Create concurrent hash information from a array.
+ *
+ * @param itemNum Number of items in array.
+ * @param pArray Pointer pointed to array which will create hash information.
+ * @return Pointer to created hash information, or NULL if no memory.
+ */
+ConcurrentHashInf *ConcurrentHashFromArray(int itemNum, char **pArray);
+
+/**
+ * @brief Delete concurrent hash information, no reader or writer may use it any more.
+ *
+ * @param pHashInf Pointer to which hash information you want to delete.
+ */
+void DeleteConcurrentHashInf(ConcurrentHashInf **pHashInf);
+
+/**
+ * @brief Get a reader index for the calling thread.
+ *
+ * @param pHashInf Which hash information will be searched.
+ * @return Reader index, or -1 if MAX_READER_THREADS readers are registered.
+ */
+int RegisterReader(ConcurrentHashInf *pHashInf);
+
+/**
+ * @brief Give back a reader index, the thread must not use it afterwards.
+ *
+ * @param pHashInf Which hash information is searched.
+ * @param nReader Reader index from RegisterReader().
+ */
+void UnregisterReader(ConcurrentHashInf *pHashInf, int nReader);
+
+/**
+ * @brief Get real string address without lock, safe while writer changes hash table.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param nReader Reader index of calling thread, from RegisterReader().
+ * @param str Which string you want to find.
+ * @return Real string address you want to search, or NULL if not found.
+ */
+void *ConcurrentGetStringAddress(ConcurrentHashInf *pHashInf, int nReader, const char *str);
+
+/**
+ * @brief Insert a string, writer only, table is copied to a bigger one if needed.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param str Which string want to insert, it is not checked whether already in hash table.
+ * @return SUCCEED, or FAILED if no memory.
+ */
+int ConcurrentInsertString(ConcurrentHashInf *pHashInf, const char *str);
+
+/**
+ * @brief Remove a string, writer only.
+ *
+ * @param pHashInf Which hash information to remove from.
+ * @param str Which string want to remove.
+ * @return SUCCEED, or FAILED if string is not in hash table.
+ */
+int ConcurrentRemoveString(ConcurrentHashInf *pHashInf, const char *str);
+
+/**
+ * @brief Insert a string, or replace address of same string already in hash table, writer only.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param str Which string want to insert, readers get this address afterwards.
+ * @return SUCCEED, or FAILED if no memory.
+ */
+int ConcurrentUpsertString(ConcurrentHashInf *pHashInf, const char *str);
+
+#endif /* CONCURRENTHASH_H_ */
@@ -8,30 +8,503 @@
  * @brief  Create a hash table from string array or list, search string by hash table.
  */
 
+#include <pthread.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "Hash.h"
 
+/**
+ * @brief Work of one thread in HashFromArrayParallel().
+ */
+typedef struct BuildTask
+{
+	HashInf *pHashInf;      ///< Hash information being built.
+	char **pArray;          ///< Array of all strings.
+	int nStart;             ///< First string of this thread.
+	int nEnd;               ///< After last string of this thread.
+}BuildTask;
+
+//! Length of a key which is a string ending with '\0', measured only if the key is copied.
+#define STRING_KEY_LEN ((size_t)-1)
+
+//! Most threads of HashFromArrayParallel() for each online CPU.
+#define MAX_BUILD_THREADS_PER_CPU 4
+
+/**
+ * @brief Create empty hash information.
+ *
+ * @param itemNum Number of items expected.
+ * @return Pointer to created hash information, or NULL if no memory.
+ */
+static HashInf *CreateHashInf(int itemNum)
+{
+	HashInf *pHashInf = (HashInf *)malloc(sizeof(HashInf));
+	if (IS_NULL(pHashInf))
+	{
+		return NULL;
+	}
+	pHashInf->nTableSize = MAX((int)(itemNum * ZOOM_TIMES_PREVENT_CONFLICT), MIN_HASH_TABLE_SIZE);
+	pHashInf->pHashTable = InitHashTable(pHashInf->nTableSize);
+	if (IS_NULL(pHashInf->pHashTable))
+	{
+		FREE(pHashInf);
+		return NULL;
+	}
+	pHashInf->nItemNum = 0;
+	pHashInf->nDeletedNum = 0;
+	pHashInf->fMaxLoadFactor = DEFAULT_MAX_LOAD_FACTOR;
+	pHashInf->nKeyCheck = HASH_CHECK_FINGERPRINT;
+	pHashInf->nMaxProbe = 0;
+	pHashInf->bRobinHood = YES;
+	pHashInf->pOldTable = NULL;
+	pHashInf->nOldTableSize = 0;
+	pHashInf->nOldMaxProbe = 0;
+	pHashInf->bOldRobinHood = YES;
+	pHashInf->nRehashPos = 0;
+	pHashInf->pBlob = NULL;
+	pHashInf->nBlobSize = 0;
+	pHashInf->pMapping = NULL;
+	pHashInf->nMappingSize = 0;
+	pHashInf->bInternKeys = NO;
+	pHashInf->bKeyLenLost = NO;
+	StringPoolInit(&(pHashInf->keyPool));
+	KeyFilterInit(&(pHashInf->keyFilter));
+#ifdef HASH_STATS
+	pHashInf->statsSlots = CreateHashStatsSlots();
+	if (IS_NULL(pHashInf->statsSlots))
+	{
+		DeleteHashInf(&pHashInf);
+	}
+#endif
+	return pHashInf;
+}
+
+/**
+ * @brief Put an item into a table in order table is kept in, longest probe of table grows if needed.
+ *
+ * @param lpTable Which table to put in, it has an empty item.
+ * @param nTableSize Size of table.
+ * @param bRobinHood YES if table is in Robin Hood order.
+ * @param pItem Item to put, saves item whose place it took, empty or deleted.
+ * @param pMaxProbe Longest probe of table.
+ */
+static void PutItemInOrder(HashItem *lpTable, unsigned int nTableSize, bool_t bRobinHood, HashItem *pItem,
+		unsigned int *pMaxProbe)
+{
+	// Load factor counts deleted items too, an empty item always ends the probe.
+	if (NO == bRobinHood)
+	{
+		int position = FindFreeHashItem(lpTable, nTableSize, pItem->HashKey);
+		HashItem tmpItem = lpTable[position];
+
+		lpTable[position] = *pItem;
+		*pItem = tmpItem;
+		*pMaxProbe = MAX(*pMaxProbe, HashItemProbeLen(position, lpTable[position].HashKey, nTableSize));
+	}
+	else
+	{
+		PutHashItemRobinHood(lpTable, nTableSize, pItem, pMaxProbe);
+	}
+}
+
+/**
+ * @brief Put an item with known hash values into current table by Robin Hood order, count deleted item it
+ * reuses.
+ *
+ * @param pHashInf Which hash information to put.
+ * @param nHash Offset hash.
+ * @param nHashA Hash A.
+ * @param nHashB Hash B.
+ * @param pAddr Address of item.
+ * @param pValue Value of item, only kept with HASH_MAP_VALUES.
+ */
+static void PutHashItem(HashInf *pHashInf, unsigned int nHash, unsigned int nHashA, unsigned int nHashB,
+		void *pAddr, void *pValue)
+{
+	HashItem newItem;
+
+	FillHashItem(&newItem, nHash, nHashA, nHashB, pAddr);
+	SetHashItemValue(&newItem, pValue);
+	newItem.HASH_ITEM_STATE = HashItemWord(nHashA);
+
+	PutItemInOrder(pHashInf->pHashTable, pHashInf->nTableSize, pHashInf->bRobinHood, &newItem,
+			&(pHashInf->nMaxProbe));
+	if (HASH_ITEM_DELETED == HashItemState(&newItem))
+	{
+		--pHashInf->nDeletedNum;
+	}
+}
+
+/**
+ * @brief Find longest probe of items in a table filled without tracking it, and whether it is in Robin Hood
+ * order, i.e. probe length never grows by more than one from an item to the next.
+ *
+ * @param lpTable Which table to scan.
+ * @param nTableSize Size of table.
+ * @param pbRobinHood Save YES if table is in Robin Hood order.
+ * @return Biggest HashItemProbeLen() of used items, 0 if table is empty.
+ */
+static unsigned int ScanProbeOrder(const HashItem *lpTable, unsigned int nTableSize, bool_t *pbRobinHood)
+{
+	const HashItem *pLast = &lpTable[nTableSize-1];
+	unsigned int nMaxProbe = 0, nProbe;
+	// Item before first one is the last one.
+	bool_t bPrevUsed = (HASH_ITEM_EMPTY != pLast->HASH_ITEM_STATE) ? YES : NO;
+	unsigned int nPrevProbe = (YES == bPrevUsed) ? HashItemProbeLen(nTableSize - 1, pLast->HashKey, nTableSize) : 0;
+
+	*pbRobinHood = YES;
+	for (unsigned int i=0; i<nTableSize; ++i)
+	{
+		if (HASH_ITEM_EMPTY == lpTable[i].HASH_ITEM_STATE)
+		{
+			bPrevUsed = NO;
+			continue;
+		}
+		nProbe = HashItemProbeLen(i, lpTable[i].HashKey, nTableSize);
+		if (nProbe > ((YES == bPrevUsed) ? nPrevProbe + 1 : 0))
+		{
+			*pbRobinHood = NO;
+		}
+		nMaxProbe = MAX(nMaxProbe, nProbe);
+		nPrevProbe = nProbe;
+		bPrevUsed = YES;
+	}
+	return nMaxProbe;
+}
+
+/**
+ * @brief Get real address of a found item, in a loaded file pAddr is offset in key blob.
+ *
+ *   Items of a loaded file are not read when it is loaded, so an offset is checked here, a corrupt one
+ * never gives an address outside key blob. Blob ends with '\0', checked by LoadHashInf(), so every key
+ * in it ends inside it.
+ *
+ * @param pHashInf Hash information item is in.
+ * @param pItem Found item, or NULL.
+ * @return Real address, or NULL if pItem is NULL or it's offset is not in key blob.
+ */
+static inline void *ItemAddress(const HashInf *pHashInf, const HashItem *pItem)
+{
+	if (IS_NULL(pItem))
+	{
+		return NULL;
+	}
+	if (IS_NULL(pHashInf->pBlob))
+	{
+		return pItem->pAddr;
+	}
+	return ((size_t)pItem->pAddr < pHashInf->nBlobSize) ? (void *)(pHashInf->pBlob + (size_t)pItem->pAddr) : NULL;
+}
+
+/**
+ * @brief Check whether an item whose hash values match really holds a key, length first, then bytes.
+ *
+ *   Interned keys have their length before them. Other keys are strings ending with '\0', their length is
+ * found by strnlen() reading at most len + 1 bytes. Keys with a length are interned, see KeepKeyLen().
+ *
+ * @param pHashInf Hash information item is in.
+ * @param pItem Item with matching hash values.
+ * @param key Which key you want to find.
+ * @param len Length of key.
+ * @return YES if item holds the key.
+ */
+static inline bool_t IsKeyOfItem(const HashInf *pHashInf, const HashItem *pItem, const void *key, size_t len)
+{
+	const char *pStored = (const char *)ItemAddress(pHashInf, pItem);
+	if (IS_NULL(pStored))
+	{
+		return NO;
+	}
+	size_t nStoredLen = (YES == pHashInf->bInternKeys) ? StringPoolKeyLen(pStored) : strnlen(pStored, len + 1);
+
+	return ((nStoredLen == len) && (0 == memcmp(pStored, key, len))) ? YES : NO;
+}
+
+/**
+ * @brief Search an item with known hash values in one table, same as FindHashItemRobinHood() or
+ * FindHashItemBounded() but counts probes and checks keys with HASH_CHECK_KEY.
+ *
+ *   Without HASH_STATS and with HASH_CHECK_FINGERPRINT it is just one of them.
+ *
+ * @param pHashInf Hash information table belongs to.
+ * @param lpTable Which table to search.
+ * @param nTableSize Size of table.
+ * @param nMaxProbe Longest probe of items in table, search ends after it.
+ * @param bRobinHood YES if table is in Robin Hood order, search ends at an item nearer to it's start.
+ * @param nHash Offset hash.
+ * @param nHashA Hash A.
+ * @param nHashB Hash B.
+ * @param key Which key you want to find, only read with HASH_CHECK_KEY.
+ * @param len Length of key.
+ * @param pStats Counters of calling thread, only used with HASH_STATS.
+ * @param pProbes Add number of items probed, only used with HASH_STATS.
+ * @return Position of item, or -1 if not found.
+ */
+static inline int ProbeTable(const HashInf *pHashInf, const HashItem *lpTable, unsigned int nTableSize,
+		unsigned int nMaxProbe, bool_t bRobinHood, unsigned int nHash, unsigned int nHashA, unsigned int nHashB,
+		const void *key, size_t len, HashStats *pStats, unsigned int *pProbes)
+{
+#ifndef HASH_STATS
+	if (HASH_CHECK_FINGERPRINT == pHashInf->nKeyCheck)
+	{
+		return (YES == bRobinHood) ? FindHashItemRobinHood(lpTable, nTableSize, nHash, nHashA, nHashB)
+				: FindHashItemBounded(lpTable, nTableSize, nHash, nHashA, nHashB, nMaxProbe);
+	}
+#endif
+	unsigned int nHashPos = nHash % nTableSize;
+
+	for (unsigned int nProbe = 0; nProbe <= nMaxProbe; ++nProbe)
+	{
+		if (HASH_ITEM_EMPTY == lpTable[nHashPos].HASH_ITEM_STATE)
+		{
+			break;
+		}
+		++(*pProbes);
+		if (HASH_ITEM_EXISTS == HashItemState(&lpTable[nHashPos]))
+		{
+			HASH_STATS_ADD(pStats, nCompares, 1);
+			if (IsHashItemOf(&lpTable[nHashPos], lpTable[nHashPos].HASH_ITEM_STATE, nHash, nHashA, nHashB))
+			{
+				if ((HASH_CHECK_FINGERPRINT == pHashInf->nKeyCheck)
+						|| (YES == IsKeyOfItem(pHashInf, &lpTable[nHashPos], key, len)))
+				{
+					return nHashPos;
+				}
+				// Hash values collide, another key with the same ones may come later in probe.
+				HASH_STATS_ADD(pStats, nHashMismatches, 1);
+			}
+			else if (lpTable[nHashPos].HashKey == nHash)
+			{
+				HASH_STATS_ADD(pStats, nHashMismatches, 1);
+			}
+		}
+		// Key would have taken place of an item nearer to it's start.
+		if ((YES == bRobinHood) && (HashItemProbeLen(nHashPos, lpTable[nHashPos].HashKey, nTableSize) < nProbe))
+		{
+			break;
+		}
+		nHashPos = (nHashPos + 1 == nTableSize) ? 0 : nHashPos + 1;
+	}
+	return -1;
+}
+
+/**
+ * @brief Search an item with known hash values, in current table and old table while growing.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param nHash Offset hash.
+ * @param nHashA Hash A.
+ * @param nHashB Hash B.
+ * @param key Which key you want to find, only read with HASH_CHECK_KEY.
+ * @param len Length of key, or STRING_KEY_LEN.
+ * @param pbInOldTable Set to YES if item is found in old table, can be NULL.
+ * @return Item found, or NULL if not found.
+ */
+static HashItem *FindItem(HashInf *pHashInf, unsigned int nHash, unsigned int nHashA, unsigned int nHashB,
+		const void *key, size_t len, bool_t *pbInOldTable)
+{
+	HashStats *pStats = HASH_STATS_OF(pHashInf);
+	unsigned int nProbes = 0;
+
+	if (NO == KeyFilterMayContain(&(pHashInf->keyFilter), nHash))
+	{
+		HASH_STATS_ADD(pStats, nFilterRejects, 1);
+		CountHashSearch(pStats, NO, 0);
+		return NULL;
+	}
+
+	// String is measured only when it's bytes are compared.
+	if ((HASH_CHECK_KEY == pHashInf->nKeyCheck) && (STRING_KEY_LEN == len))
+	{
+		len = strlen((const char *)key);
+	}
+
+	int position = ProbeTable(pHashInf, pHashInf->pHashTable, pHashInf->nTableSize, pHashInf->nMaxProbe,
+			pHashInf->bRobinHood, nHash, nHashA, nHashB, key, len, pStats, &nProbes);
+	if (-1 != position)
+	{
+		CountHashSearch(pStats, YES, nProbes);
+		return &(pHashInf->pHashTable[position]);
+	}
+
+	// While growing, item may still be in old table.
+	if (IS_NOT_NULL(pHashInf->pOldTable))
+	{
+		position = ProbeTable(pHashInf, pHashInf->pOldTable, pHashInf->nOldTableSize, pHashInf->nOldMaxProbe,
+				pHashInf->bOldRobinHood, nHash, nHashA, nHashB, key, len, pStats, &nProbes);
+		if (-1 != position)
+		{
+			if (IS_NOT_NULL(pbInOldTable))
+			{
+				*pbInOldTable = YES;
+			}
+			CountHashSearch(pStats, YES, nProbes);
+			return &(pHashInf->pOldTable[position]);
+		}
+	}
+	CountHashSearch(pStats, NO, nProbes);
+	return NULL;
+}
+
+/**
+ * @brief Move some buckets of old table into new table, free old table when all moved.
+ *
+ * @param pHashInf Which hash information is growing.
+ * @param nBuckets Max number of buckets to move.
+ */
+static void MoveOldBuckets(HashInf *pHashInf, int nBuckets)
+{
+	HashItem *pOldTable = pHashInf->pOldTable;
+	int nEnd = MIN(pHashInf->nRehashPos + nBuckets, pHashInf->nOldTableSize);
+
+	for (int i=pHashInf->nRehashPos; i<nEnd; ++i)
+	{
+		if (HASH_ITEM_EXISTS == HashItemState(&pOldTable[i]))
+		{
+			PutHashItem(pHashInf, pOldTable[i].HashKey, HashItemA(&pOldTable[i]), HashItemB(&pOldTable[i]),
+					pOldTable[i].pAddr, HashItemValue(&pOldTable[i]));
+			// Keep probe going in old table, items after it may not be moved yet.
+			pOldTable[i].HASH_ITEM_STATE = HASH_ITEM_DELETED;
+		}
+	}
+	pHashInf->nRehashPos = nEnd;
+
+	if (pHashInf->nRehashPos == pHashInf->nOldTableSize)
+	{
+		FREE(pHashInf->pOldTable);
+		pHashInf->nOldTableSize = 0;
+		pHashInf->nOldMaxProbe = 0;
+		pHashInf->nRehashPos = 0;
+	}
+}
+
+/**
+ * @brief Create key filter for keys current table holds before it grows, add every key in both tables.
+ *
+ * @param pHashInf Which hash information to fill filter of.
+ * @return SUCCEED, or FAILED if no memory, hash information has no filter then.
+ */
+static int FillKeyFilter(HashInf *pHashInf)
+{
+	HashItem *tables[2] = {pHashInf->pHashTable, pHashInf->pOldTable};
+	int nSizes[2] = {pHashInf->nTableSize, pHashInf->nOldTableSize};
+	unsigned long long nKeys = MAX((unsigned long long)(pHashInf->fMaxLoadFactor * pHashInf->nTableSize),
+			(unsigned long long)pHashInf->nItemNum);
+
+	if (FAILED == KeyFilterCreate(&(pHashInf->keyFilter), nKeys))
+	{
+		return FAILED;
+	}
+	for (int t=0; t<2; ++t)
+	{
+		for (int i=0; IS_NOT_NULL(tables[t]) && (i<nSizes[t]); ++i)
+		{
+			if (HASH_ITEM_EXISTS == HashItemState(&tables[t][i]))
+			{
+				KeyFilterAdd(&(pHashInf->keyFilter), tables[t][i].HashKey);
+			}
+		}
+	}
+	return SUCCEED;
+}
+
+/**
+ * @brief Start to grow hash table, create a new table, items will be moved on later inserts.
+ *
+ *   New table is twice bigger, or same size if most used items are deleted ones, then moving just
+ * drops deleted items.
+ *
+ * @param pHashInf Which hash information to grow.
+ * @return SUCCEED, or FAILED if no memory.
+ */
+static int GrowHashTable(HashInf *pHashInf)
+{
+	int nNewSize = pHashInf->nTableSize;
+	HashItem *pNewTable;
+
+	if (pHashInf->nItemNum + 1 > pHashInf->fMaxLoadFactor * nNewSize / 2)
+	{
+		nNewSize *= 2;
+	}
+	while (pHashInf->nItemNum + 1 > pHashInf->fMaxLoadFactor * nNewSize)
+	{
+		nNewSize *= 2;
+	}
+	pNewTable = InitHashTable(nNewSize);
+	if (IS_NULL(pNewTable))
+	{
+		return FAILED;
+	}
+
+	// Last growing is not finished, move the rest before starting a new one.
+	if (IS_NOT_NULL(pHashInf->pOldTable))
+	{
+		MoveOldBuckets(pHashInf, pHashInf->nOldTableSize);
+	}
+
+	pHashInf->pOldTable = pHashInf->pHashTable;
+	pHashInf->nOldTableSize = pHashInf->nTableSize;
+	pHashInf->nOldMaxProbe = pHashInf->nMaxProbe;
+	pHashInf->bOldRobinHood = pHashInf->bRobinHood;
+	pHashInf->nRehashPos = 0;
+	pHashInf->pHashTable = pNewTable;
+	pHashInf->nTableSize = nNewSize;
+	pHashInf->nMaxProbe = 0;
+	pHashInf->bRobinHood = YES;
+	pHashInf->nDeletedNum = 0;
+
+	// Filter is sized for new table, removed keys drop out of it.
+	if (IS_NOT_NULL(pHashInf->keyFilter.pBlocks))
+	{
+		FillKeyFilter(pHashInf);
+	}
+	return SUCCEED;
+}
+
+/**
+ * @brief Make room for one more item, start or go on growing hash table.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @return SUCCEED, or FAILED if no memory.
+ */
+static int ReserveOneItem(HashInf *pHashInf)
+{
+	// Deleted items make probe longer as well, count them.
+	if (pHashInf->nItemNum + pHashInf->nDeletedNum + 1 > pHashInf->fMaxLoadFactor * pHashInf->nTableSize)
+	{
+		if (FAILED == GrowHashTable(pHashInf))
+		{
+			return FAILED;
+		}
+	}
+	if (IS_NOT_NULL(pHashInf->pOldTable))
+	{
+		MoveOldBuckets(pHashInf, REHASH_BUCKETS_PER_INSERT);
+	}
+	return SUCCEED;
+}
+
 /**
  * @brief Create hash information from list.
  *
  * @param itemNum Number of items in array.
  * @param list Pointer pointed to list which will create hash information.
  * @param GetNextStr Method of how to get string from list.
- * @return Pointer to created hash information.
+ * @return Pointer to created hash information, or NULL if no memory.
  */
 HashInf *HashFromList(int itemNum, char *(GetNextStr)(void **), void *list)
 {
 	char *str = NULL;
-	int hashTableIndex;
-
-	PrepareCryptTable();
-	HashInf *pHashInf = (HashInf *)malloc(sizeof(HashInf));
-	pHashInf->pHashTable = InitHashTable(itemNum * ZOOM_TIMES_PREVENT_CONFLICT);
-	pHashInf->nTableSize = itemNum * ZOOM_TIMES_PREVENT_CONFLICT;
+	HashInf *pHashInf = CreateHashInf(itemNum);
 
 	// Get every string in list and add them to hash table.
-	while(NULL != (str = (*GetNextStr)(&list)))
+	while(IS_NOT_NULL(pHashInf) && (NULL != (str = (*GetNextStr)(&list))))
 	{
-		InsertHash(str, pHashInf->pHashTable, pHashInf->nTableSize);
+		if (FAILED == InsertString(pHashInf, str))
+		{
+			DeleteHashInf(&pHashInf);
+		}
 	}
 
 	return pHashInf;
@@ -42,23 +515,535 @@ HashInf *HashFromList(int itemNum, char *(GetNextStr)(void **), void *list)
  *
  * @param itemNum Number of items in array.
  * @param pArray Pointer pointed to array which will create hash information.
- * @return Pointer to created hash information.
+ * @return Pointer to created hash information, or NULL if no memory.
  */
 HashInf *HashFromArray(int itemNum, char **pArray)
 {
-	PrepareCryptTable();
-	HashInf *pHashInf = (HashInf *)malloc(sizeof(HashInf));
-	pHashInf->pHashTable = InitHashTable(itemNum * ZOOM_TIMES_PREVENT_CONFLICT);
-	pHashInf->nTableSize = itemNum * ZOOM_TIMES_PREVENT_CONFLICT;
+	HashInf *pHashInf = CreateHashInf(itemNum);
 
 	// Add each string to hash table.
-	for (int i=0; i<itemNum; ++i)
+	for (int i=0; IS_NOT_NULL(pHashInf) && (i<itemNum); ++i)
+	{
+		if (FAILED == InsertString(pHashInf, pArray[i]))
+		{
+			DeleteHashInf(&pHashInf);
+		}
+	}
+	return pHashInf;
+}
+
+/**
+ * @brief Create hash information from keys with known length, keys need no terminating '\0'.
+ *
+ * @param itemNum Number of keys.
+ * @param pKeys Address of each key, saved in hash table as it is, not copied, see SetKeyCheck().
+ * @param pLens Length of each key.
+ * @return Pointer to created hash information, or NULL if no memory.
+ */
+HashInf *HashFromKeys(int itemNum, const void **pKeys, const size_t *pLens)
+{
+	HashInf *pHashInf = CreateHashInf(itemNum);
+
+	// Add each key to hash table.
+	for (int i=0; IS_NOT_NULL(pHashInf) && (i<itemNum); ++i)
 	{
-		InsertHash(pArray[i], pHashInf->pHashTable, pHashInf->nTableSize);
+		if (FAILED == InsertKey(pHashInf, pKeys[i], pLens[i]))
+		{
+			DeleteHashInf(&pHashInf);
+		}
 	}
 	return pHashInf;
 }
 
+/**
+ * @brief Thread function of HashFromArrayParallel(), hash a part of array and insert it.
+ *
+ * @param pArg Pointer to BuildTask of this thread.
+ * @return Always NULL.
+ */
+static void *BuildWorker(void *pArg)
+{
+	BuildTask *pTask = (BuildTask *)pArg;
+	HashInf *pHashInf = pTask->pHashInf;
+	unsigned int nHash, nHashA, nHashB;
+
+	for (int i=pTask->nStart; i<pTask->nEnd; ++i)
+	{
+		HashString3(pTask->pArray[i], &nHash, &nHashA, &nHashB);
+		InsertHashItemAtomic(pHashInf->pHashTable, pHashInf->nTableSize, nHash, nHashA, nHashB,
+				pTask->pArray[i]);
+	}
+	return NULL;
+}
+
+/**
+ * @brief Create hash information from a array, strings are hashed and inserted by many threads.
+ *
+ *   Array is cut into one part for each thread, each thread hashes it's part and claims items of the
+ * shared hash table with compare-and-swap. Link with -lpthread.
+ *
+ * @param itemNum Number of items in array.
+ * @param pArray Pointer pointed to array which will create hash information.
+ * @param nThreads Number of threads, 0 to use one for each online CPU, at most 4 for each online CPU.
+ * @return Pointer to created hash information, or NULL if no memory or threads can not be created.
+ */
+HashInf *HashFromArrayParallel(int itemNum, char **pArray, int nThreads)
+{
+	HashInf *pHashInf = CreateHashInf(itemNum);
+	int nCreated = 0;
+
+	if (IS_NULL(pHashInf))
+	{
+		return NULL;
+	}
+	// More threads than CPUs only wait, tasks and threads are on stack.
+	int nCpus = MAX((int)sysconf(_SC_NPROCESSORS_ONLN), 1);
+	nThreads = (nThreads <= 0) ? nCpus : MIN(nThreads, nCpus * MAX_BUILD_THREADS_PER_CPU);
+	pthread_t threads[nThreads];
+	BuildTask tasks[nThreads];
+
+	// Table is sized for itemNum, it never grows while threads insert.
+	for (int i=0; i<nThreads; ++i)
+	{
+		tasks[i].pHashInf = pHashInf;
+		tasks[i].pArray = pArray;
+		tasks[i].nStart = (int)((long long)itemNum * i / nThreads);
+		tasks[i].nEnd = (int)((long long)itemNum * (i + 1) / nThreads);
+		if (SUCCEED != pthread_create(&threads[i], NULL, BuildWorker, &tasks[i]))
+		{
+			break;
+		}
+		++nCreated;
+	}
+	for (int i=0; i<nCreated; ++i)
+	{
+		pthread_join(threads[i], NULL);
+	}
+
+	if (nCreated != nThreads)
+	{
+		DeleteHashInf(&pHashInf);
+		return NULL;
+	}
+	pHashInf->nItemNum = itemNum;
+	// Threads claim items in any order, longest probe and order are known only when all finish.
+	pHashInf->nMaxProbe = ScanProbeOrder(pHashInf->pHashTable, pHashInf->nTableSize, &(pHashInf->bRobinHood));
+	return pHashInf;
+}
+
+/**
+ * @brief Intern keys before the first key with a length is put in while HASH_CHECK_KEY is set, a key cut
+ * out of a buffer has no '\0' after it and only a copy in key pool keeps its length.
+ *
+ *   Without HASH_CHECK_KEY no length is read, key is kept as it is and only marked lost.
+ *
+ * @param pHashInf Which hash information key is put in.
+ * @param len Length of key, or STRING_KEY_LEN.
+ * @return SUCCEED, or FAILED if no memory to copy keys.
+ */
+static inline int KeepKeyLen(HashInf *pHashInf, size_t len)
+{
+	if ((STRING_KEY_LEN == len) || (YES == pHashInf->bInternKeys))
+	{
+		return SUCCEED;
+	}
+	if (HASH_CHECK_KEY != pHashInf->nKeyCheck)
+	{
+		pHashInf->bKeyLenLost = YES;
+		return SUCCEED;
+	}
+	return InternKeys(pHashInf);
+}
+
+/**
+ * @brief Insert an item with known hash values, hash table grows if needed.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param nHash Offset hash.
+ * @param nHashA Hash A.
+ * @param nHashB Hash B.
+ * @param pAddr Address of item, copied into key pool after InternKeys(), see KeepKeyLen().
+ * @param len Length of key, or STRING_KEY_LEN.
+ * @param pValue Value of item, only kept with HASH_MAP_VALUES.
+ * @return SUCCEED, or FAILED if no memory to grow hash table or copy key.
+ */
+static int InsertHashed(HashInf *pHashInf, unsigned int nHash, unsigned int nHashA, unsigned int nHashB,
+		void *pAddr, size_t len, void *pValue)
+{
+	// A loaded file is read only.
+	if (IS_NOT_NULL(pHashInf->pMapping) || (FAILED == KeepKeyLen(pHashInf, len))
+			|| (FAILED == ReserveOneItem(pHashInf)))
+	{
+		return FAILED;
+	}
+	if (YES == pHashInf->bInternKeys)
+	{
+		pAddr = StringPoolAdd(&(pHashInf->keyPool), pAddr, (STRING_KEY_LEN == len) ? strlen((char *)pAddr) : len);
+		if (IS_NULL(pAddr))
+		{
+			return FAILED;
+		}
+	}
+	PutHashItem(pHashInf, nHash, nHashA, nHashB, pAddr, pValue);
+	KeyFilterAdd(&(pHashInf->keyFilter), nHash);
+	++pHashInf->nItemNum;
+	return SUCCEED;
+}
+
+/**
+ * @brief Remove an item with known hash values, it's item is marked deleted.
+ *
+ * @param pHashInf Which hash information to remove from.
+ * @param nHash Offset hash.
+ * @param nHashA Hash A.
+ * @param nHashB Hash B.
+ * @param key Which key want to remove, only read with HASH_CHECK_KEY.
+ * @param len Length of key, or STRING_KEY_LEN.
+ * @return SUCCEED, or FAILED if item is not in hash table.
+ */
+static int RemoveHashed(HashInf *pHashInf, unsigned int nHash, unsigned int nHashA, unsigned int nHashB,
+		const void *key, size_t len)
+{
+	bool_t bInOldTable = NO;
+	HashItem *pItem = IS_NULL(pHashInf->pMapping)
+			? FindItem(pHashInf, nHash, nHashA, nHashB, key, len, &bInOldTable) : NULL;
+
+	if (IS_NULL(pItem))
+	{
+		return FAILED;
+	}
+	pItem->HASH_ITEM_STATE = HASH_ITEM_DELETED;
+	// Deleted items in old table are dropped when it is moved.
+	if (NO == bInOldTable)
+	{
+		++pHashInf->nDeletedNum;
+	}
+	--pHashInf->nItemNum;
+	return SUCCEED;
+}
+
+/**
+ * @brief Insert an item with known hash values, or replace the one with same hash values.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param nHash Offset hash.
+ * @param nHashA Hash A.
+ * @param nHashB Hash B.
+ * @param pAddr Address of item, copied into key pool after InternKeys(), see KeepKeyLen().
+ * @param len Length of key, or STRING_KEY_LEN.
+ * @param pValue Value of item, only kept with HASH_MAP_VALUES.
+ * @return SUCCEED, or FAILED if no memory to grow hash table or copy key.
+ */
+static int UpsertHashed(HashInf *pHashInf, unsigned int nHash, unsigned int nHashA, unsigned int nHashB,
+		void *pAddr, size_t len, void *pValue)
+{
+	if (IS_NOT_NULL(pHashInf->pMapping) || (FAILED == KeepKeyLen(pHashInf, len)))
+	{
+		return FAILED;
+	}
+	HashItem *pItem = FindItem(pHashInf, nHash, nHashA, nHashB, pAddr, len, NULL);
+
+	if (IS_NOT_NULL(pItem))
+	{
+		// Copy in key pool already holds the same key.
+		if (NO == pHashInf->bInternKeys)
+		{
+			pItem->pAddr = pAddr;
+		}
+		SetHashItemValue(pItem, pValue);
+		return SUCCEED;
+	}
+	return InsertHashed(pHashInf, nHash, nHashA, nHashB, pAddr, len, pValue);
+}
+
+/**
+ * @brief Whether hash information can keep values, built with HASH_MAP_VALUES and not loaded from a file.
+ *
+ * @param pHashInf Which hash information to check.
+ * @return YES if values can be set and got.
+ */
+static inline bool_t CanMapValues(const HashInf *pHashInf)
+{
+#ifdef HASH_MAP_VALUES
+	return IS_NULL(pHashInf->pMapping) ? YES : NO;
+#else
+	(void)pHashInf;
+	return NO;
+#endif
+}
+
+/**
+ * @brief Insert a string into created hash information, hash table grows if needed.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param str Which string want to insert, it is not checked whether already in hash table.
+ * @return SUCCEED, or FAILED if no memory to grow hash table.
+ */
+int InsertString(HashInf *pHashInf, const char *str)
+{
+	unsigned int nHash, nHashA, nHashB;
+
+	HashString3(str, &nHash, &nHashA, &nHashB);
+	return InsertHashed(pHashInf, nHash, nHashA, nHashB, (char *)str, STRING_KEY_LEN, NULL);
+}
+
+/**
+ * @brief Remove a string from created hash information, it's item is marked deleted.
+ *
+ * @param pHashInf Which hash information to remove from.
+ * @param str Which string want to remove.
+ * @return SUCCEED, or FAILED if string is not in hash table.
+ */
+int RemoveString(HashInf *pHashInf, const char *str)
+{
+	unsigned int nHash, nHashA, nHashB;
+
+	HashString3(str, &nHash, &nHashA, &nHashB);
+	return RemoveHashed(pHashInf, nHash, nHashA, nHashB, str, STRING_KEY_LEN);
+}
+
+/**
+ * @brief Insert a string into created hash information, or replace same string already in it.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param str Which string want to insert, GetStringAddress() returns this address afterwards.
+ * @return SUCCEED, or FAILED if no memory to grow hash table.
+ */
+int UpsertString(HashInf *pHashInf, const char *str)
+{
+	unsigned int nHash, nHashA, nHashB;
+
+	HashString3(str, &nHash, &nHashA, &nHashB);
+	return UpsertHashed(pHashInf, nHash, nHashA, nHashB, (char *)str, STRING_KEY_LEN, NULL);
+}
+
+/**
+ * @brief Insert a key with known length into created hash information, hash table grows if needed.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param key Which key want to insert, it is not checked whether already in hash table. It is not copied,
+ *            unless HASH_CHECK_KEY is set, then it is copied into key pool with it's length.
+ * @param len Length of key.
+ * @return SUCCEED, or FAILED if no memory to grow hash table or copy key.
+ */
+int InsertKey(HashInf *pHashInf, const void *key, size_t len)
+{
+	unsigned int nHash, nHashA, nHashB;
+
+	HashString3Len(key, len, &nHash, &nHashA, &nHashB);
+	return InsertHashed(pHashInf, nHash, nHashA, nHashB, (void *)key, len, NULL);
+}
+
+/**
+ * @brief Remove a key with known length from created hash information, it's item is marked deleted.
+ *
+ * @param pHashInf Which hash information to remove from.
+ * @param key Which key want to remove.
+ * @param len Length of key.
+ * @return SUCCEED, or FAILED if key is not in hash table.
+ */
+int RemoveKey(HashInf *pHashInf, const void *key, size_t len)
+{
+	unsigned int nHash, nHashA, nHashB;
+
+	HashString3Len(key, len, &nHash, &nHashA, &nHashB);
+	return RemoveHashed(pHashInf, nHash, nHashA, nHashB, key, len);
+}
+
+/**
+ * @brief Insert a key with known length into created hash information, or replace same key already in it.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param key Which key want to insert, GetKeyAddress() returns this address afterwards, or it's copy
+ *            in key pool with HASH_CHECK_KEY.
+ * @param len Length of key.
+ * @return SUCCEED, or FAILED if no memory to grow hash table or copy key.
+ */
+int UpsertKey(HashInf *pHashInf, const void *key, size_t len)
+{
+	unsigned int nHash, nHashA, nHashB;
+
+	HashString3Len(key, len, &nHash, &nHashA, &nHashB);
+	return UpsertHashed(pHashInf, nHash, nHashA, nHashB, (void *)key, len, NULL);
+}
+
+/**
+ * @brief Insert a string with a value into created hash information, hash table grows if needed.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param str Which string want to insert, it is not checked whether already in hash table.
+ * @param pValue Value of string, GetStringValue() returns it.
+ * @return SUCCEED, or FAILED if no memory to grow hash table or built without HASH_MAP_VALUES.
+ */
+int InsertStringValue(HashInf *pHashInf, const char *str, void *pValue)
+{
+	unsigned int nHash, nHashA, nHashB;
+
+	if (NO == CanMapValues(pHashInf))
+	{
+		return FAILED;
+	}
+	HashString3(str, &nHash, &nHashA, &nHashB);
+	return InsertHashed(pHashInf, nHash, nHashA, nHashB, (char *)str, STRING_KEY_LEN, pValue);
+}
+
+/**
+ * @brief Insert a string with a value into created hash information, or replace value of same string.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param str Which string want to insert.
+ * @param pValue Value of string, GetStringValue() returns it.
+ * @return SUCCEED, or FAILED if no memory to grow hash table or built without HASH_MAP_VALUES.
+ */
+int UpsertStringValue(HashInf *pHashInf, const char *str, void *pValue)
+{
+	unsigned int nHash, nHashA, nHashB;
+
+	if (NO == CanMapValues(pHashInf))
+	{
+		return FAILED;
+	}
+	HashString3(str, &nHash, &nHashA, &nHashB);
+	return UpsertHashed(pHashInf, nHash, nHashA, nHashB, (char *)str, STRING_KEY_LEN, pValue);
+}
+
+/**
+ * @brief Insert a key with known length and a value into created hash information.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param key Which key want to insert, it is not checked whether already in hash table. It is not copied,
+ *            unless HASH_CHECK_KEY is set, then it is copied into key pool with it's length.
+ * @param len Length of key.
+ * @param pValue Value of key, GetKeyValue() returns it.
+ * @return SUCCEED, or FAILED if no memory to grow hash table or copy key, or built without HASH_MAP_VALUES.
+ */
+int InsertKeyValue(HashInf *pHashInf, const void *key, size_t len, void *pValue)
+{
+	unsigned int nHash, nHashA, nHashB;
+
+	if (NO == CanMapValues(pHashInf))
+	{
+		return FAILED;
+	}
+	HashString3Len(key, len, &nHash, &nHashA, &nHashB);
+	return InsertHashed(pHashInf, nHash, nHashA, nHashB, (void *)key, len, pValue);
+}
+
+/**
+ * @brief Insert a key with known length and a value into created hash information, or replace value of
+ * same key.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param key Which key want to insert.
+ * @param len Length of key.
+ * @param pValue Value of key, GetKeyValue() returns it.
+ * @return SUCCEED, or FAILED if no memory to grow hash table or built without HASH_MAP_VALUES.
+ */
+int UpsertKeyValue(HashInf *pHashInf, const void *key, size_t len, void *pValue)
+{
+	unsigned int nHash, nHashA, nHashB;
+
+	if (NO == CanMapValues(pHashInf))
+	{
+		return FAILED;
+	}
+	HashString3Len(key, len, &nHash, &nHashA, &nHashB);
+	return UpsertHashed(pHashInf, nHash, nHashA, nHashB, (void *)key, len, pValue);
+}
+
+/**
+ * @brief Copy every key into a string pool owned by hash information, keys of later inserts are copied too.
+ *
+ * @param pHashInf Which hash information to intern keys of.
+ * @return SUCCEED, or FAILED if no memory or length of a key is lost, nothing is changed then.
+ */
+int InternKeys(HashInf *pHashInf)
+{
+	HashItem *tables[2] = {pHashInf->pHashTable, pHashInf->pOldTable};
+	int nSizes[2] = {pHashInf->nTableSize, pHashInf->nOldTableSize};
+	size_t nBytes = 0;
+
+	if (IS_NOT_NULL(pHashInf->pMapping) || (YES == pHashInf->bInternKeys))
+	{
+		return SUCCEED;
+	}
+	// Key cut out of a buffer can not be measured by strlen().
+	if (YES == pHashInf->bKeyLenLost)
+	{
+		return FAILED;
+	}
+
+	// One block for all keys, so they are contiguous.
+	for (int t=0; t<2; ++t)
+	{
+		for (int i=0; IS_NOT_NULL(tables[t]) && (i<nSizes[t]); ++i)
+		{
+			if (HASH_ITEM_EXISTS == HashItemState(&tables[t][i]))
+			{
+				nBytes += StringPoolEntrySize(strlen((const char *)tables[t][i].pAddr));
+			}
+		}
+	}
+	if (FAILED == StringPoolReserve(&(pHashInf->keyPool), nBytes))
+	{
+		return FAILED;
+	}
+
+	for (int t=0; t<2; ++t)
+	{
+		for (int i=0; IS_NOT_NULL(tables[t]) && (i<nSizes[t]); ++i)
+		{
+			HashItem *pItem = &tables[t][i];
+			if (HASH_ITEM_EXISTS == HashItemState(pItem))
+			{
+				pItem->pAddr = StringPoolAdd(&(pHashInf->keyPool), pItem->pAddr, strlen((const char *)pItem->pAddr));
+			}
+		}
+	}
+	pHashInf->bInternKeys = YES;
+	return SUCCEED;
+}
+
+/**
+ * @brief Build a key filter from offset hashes of keys in hash information, checked before each search.
+ *
+ * @param pHashInf Which hash information to build filter of.
+ * @return SUCCEED, or FAILED if no memory, hash information has no filter then.
+ */
+int BuildKeyFilter(HashInf *pHashInf)
+{
+	return FillKeyFilter(pHashInf);
+}
+
+/**
+ * @brief Set max load factor of hash table, takes effect on next insert.
+ *
+ * @param pHashInf Which hash information to set.
+ * @param fMaxLoadFactor Max part of hash table items can take, between 0 and 1.
+ */
+void SetMaxLoadFactor(HashInf *pHashInf, double fMaxLoadFactor)
+{
+	pHashInf->fMaxLoadFactor = CLAMP(fMaxLoadFactor, 0.05, 1.0);
+}
+
+/**
+ * @brief Set how a lookup decides an item with matching hash values holds the key.
+ *
+ * @param pHashInf Which hash information to set.
+ * @param nKeyCheck HASH_CHECK_FINGERPRINT or HASH_CHECK_KEY.
+ * @return SUCCEED, or FAILED if HASH_CHECK_KEY is asked for and length of a key is lost.
+ */
+int SetKeyCheck(HashInf *pHashInf, int nKeyCheck)
+{
+	// Key cut out of a buffer would be measured past it's end.
+	if ((HASH_CHECK_KEY == nKeyCheck) && (YES == pHashInf->bKeyLenLost))
+	{
+		return FAILED;
+	}
+	pHashInf->nKeyCheck = (HASH_CHECK_KEY == nKeyCheck) ? HASH_CHECK_KEY : HASH_CHECK_FINGERPRINT;
+	return SUCCEED;
+}
+
 /**
  * @brief Delete created hash information.
  *
@@ -68,7 +1053,19 @@ void DeleteHashInf(HashInf **pHashInf)
 {
 	if (IS_NOT_FREED(*pHashInf))
 	{
+		if (IS_NOT_NULL((*pHashInf)->pMapping))
+		{
+			// Hash table is in the mapped file.
+			munmap((*pHashInf)->pMapping, (*pHashInf)->nMappingSize);
+			(*pHashInf)->pHashTable = NULL;
+		}
 		SECURE_FREE((*pHashInf)->pHashTable);
+		SECURE_FREE((*pHashInf)->pOldTable);
+		StringPoolDestroy(&((*pHashInf)->keyPool));
+		KeyFilterDestroy(&((*pHashInf)->keyFilter));
+#ifdef HASH_STATS
+		SECURE_FREE((*pHashInf)->statsSlots);
+#endif
 		FREE(*pHashInf);
 	}
 }
@@ -82,13 +1079,351 @@ void DeleteHashInf(HashInf **pHashInf)
  */
 void *GetStringAddress(HashInf *pHashInf, const char *str)
 {
-	int position = GetHashTablePos(str, pHashInf->pHashTable, pHashInf->nTableSize);
-	if (-1 != position)
+	unsigned int nHash, nHashA, nHashB;
+	HashItem *pItem;
+
+	HashString3(str, &nHash, &nHashA, &nHashB);
+	pItem = FindItem(pHashInf, nHash, nHashA, nHashB, str, STRING_KEY_LEN, NULL);
+	return ItemAddress(pHashInf, pItem);
+}
+
+/**
+ * @brief Get real key address, key has known length and needs no terminating '\0'.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param key Which key you want to find.
+ * @param len Length of key.
+ * @return Real key address, or NULL if not found.
+ */
+void *GetKeyAddress(HashInf *pHashInf, const void *key, size_t len)
+{
+	unsigned int nHash, nHashA, nHashB;
+	HashItem *pItem;
+
+	HashString3Len(key, len, &nHash, &nHashA, &nHashB);
+	pItem = FindItem(pHashInf, nHash, nHashA, nHashB, key, len, NULL);
+	return ItemAddress(pHashInf, pItem);
+}
+
+/**
+ * @brief Get value of a string, read from the same item GetStringAddress() finds.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param str Which string you want to find.
+ * @return Value of string, or NULL if not found, built without HASH_MAP_VALUES or loaded from a file.
+ */
+void *GetStringValue(HashInf *pHashInf, const char *str)
+{
+	unsigned int nHash, nHashA, nHashB;
+	HashItem *pItem;
+
+	if (NO == CanMapValues(pHashInf))
 	{
-		return ((pHashInf->pHashTable)[position].pAddr);
+		return NULL;
 	}
-	else
+	HashString3(str, &nHash, &nHashA, &nHashB);
+	pItem = FindItem(pHashInf, nHash, nHashA, nHashB, str, STRING_KEY_LEN, NULL);
+	return IS_NOT_NULL(pItem) ? HashItemValue(pItem) : NULL;
+}
+
+/**
+ * @brief Get value of a key with known length.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param key Which key you want to find.
+ * @param len Length of key.
+ * @return Value of key, or NULL if not found, built without HASH_MAP_VALUES or loaded from a file.
+ */
+void *GetKeyValue(HashInf *pHashInf, const void *key, size_t len)
+{
+	unsigned int nHash, nHashA, nHashB;
+	HashItem *pItem;
+
+	if (NO == CanMapValues(pHashInf))
 	{
 		return NULL;
 	}
+	HashString3Len(key, len, &nHash, &nHashA, &nHashB);
+	pItem = FindItem(pHashInf, nHash, nHashA, nHashB, key, len, NULL);
+	return IS_NOT_NULL(pItem) ? HashItemValue(pItem) : NULL;
+}
+
+/**
+ * @brief Get real string address of many strings at once.
+ *
+ *   Strings are handled in groups of BATCH_GROUP_SIZE, all of a group are hashed and their buckets are
+ * prefetched before any is searched, so cache misses of the group overlap.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param keys Strings you want to find.
+ * @param n Number of strings.
+ * @param out Save real string address of each string, NULL if not found.
+ */
+void GetStringAddressBatch(HashInf *pHashInf, const char **keys, size_t n, void **out)
+{
+	unsigned int nHash[BATCH_GROUP_SIZE], nHashA[BATCH_GROUP_SIZE], nHashB[BATCH_GROUP_SIZE];
+	HashItem *pItem;
+
+	for (size_t nStart=0; nStart<n; nStart+=BATCH_GROUP_SIZE)
+	{
+		size_t nGroup = MIN(n - nStart, (size_t)BATCH_GROUP_SIZE);
+
+		// Hash whole group, ask for each start bucket.
+		for (size_t i=0; i<nGroup; ++i)
+		{
+			HashString3(keys[nStart+i], &nHash[i], &nHashA[i], &nHashB[i]);
+			// No need to fetch bucket of a key filter already knows is missing.
+			if (YES == KeyFilterMayContain(&(pHashInf->keyFilter), nHash[i]))
+			{
+				PREFETCH(&(pHashInf->pHashTable[nHash[i] % pHashInf->nTableSize]));
+			}
+		}
+
+		// Buckets are on the way or in cache, search them.
+		for (size_t i=0; i<nGroup; ++i)
+		{
+			pItem = FindItem(pHashInf, nHash[i], nHashA[i], nHashB[i], keys[nStart+i], STRING_KEY_LEN, NULL);
+			out[nStart+i] = ItemAddress(pHashInf, pItem);
+		}
+	}
+}
+
+/**
+ * @brief Get search counters of hash information, counted by all threads since it was created or reset.
+ *
+ * @param pHashInf Which hash information to query.
+ * @param pStats Save counters, all zero if built without HASH_STATS.
+ * @return SUCCEED, or FAILED if built without HASH_STATS.
+ */
+int GetHashStats(HashInf *pHashInf, HashStats *pStats)
+{
+#ifdef HASH_STATS
+	SumHashStats(pHashInf->statsSlots, pStats);
+	return SUCCEED;
+#else
+	(void)pHashInf;
+	memset(pStats, 0, sizeof(HashStats));
+	return FAILED;
+#endif
+}
+
+/**
+ * @brief Set search counters of hash information to zero.
+ *
+ * @param pHashInf Which hash information to reset.
+ */
+void ResetHashStats(HashInf *pHashInf)
+{
+#ifdef HASH_STATS
+	memset(pHashInf->statsSlots, 0, sizeof(HashStatsSlot) * HASH_STATS_THREADS);
+#else
+	(void)pHashInf;
+#endif
+}
+
+/**
+ * @brief Save hash information into a file, LoadHashInf() maps it back.
+ *
+ * @param pHashInf Which hash information to save.
+ * @param path Where to save.
+ * @return SUCCEED, or FAILED if no memory or file can not be written.
+ */
+int SaveHashInf(HashInf *pHashInf, const char *path)
+{
+	HashItem *pItems = MALLOC(HashItem, pHashInf->nTableSize);
+	char *tmpPath = MALLOC(char, strlen(path) + sizeof(".tmp"));
+	char *pBlob = NULL;
+	unsigned long long nBlobSize = 0;
+	unsigned long long nDeletedNum = pHashInf->nDeletedNum;
+	unsigned int nMaxProbe = pHashInf->nMaxProbe;
+	bool_t bCorrupt = NO;
+	MappedHeader header;
+	FILE *fp;
+	int ret = FAILED;
+
+	if (IS_NULL(pItems) || IS_NULL(tmpPath))
+	{
+		SECURE_FREE(pItems);
+		SECURE_FREE(tmpPath);
+		return FAILED;
+	}
+
+	// Table is copied, items still in old table are put into the copy, so saving does not change it.
+	memcpy(pItems, pHashInf->pHashTable, sizeof(HashItem) * pHashInf->nTableSize);
+	for (int i=0; IS_NOT_NULL(pHashInf->pOldTable) && (i<pHashInf->nOldTableSize); ++i)
+	{
+		HashItem oldItem = pHashInf->pOldTable[i];
+		if (HASH_ITEM_EXISTS == HashItemState(&oldItem))
+		{
+			PutItemInOrder(pItems, pHashInf->nTableSize, pHashInf->bRobinHood, &oldItem, &nMaxProbe);
+			if (HASH_ITEM_DELETED == HashItemState(&oldItem))
+			{
+				--nDeletedNum;
+			}
+		}
+	}
+
+	// Size key blob, then copy keys into it and turn addresses into offsets.
+	for (int i=0; i<pHashInf->nTableSize; ++i)
+	{
+		if (HASH_ITEM_EXISTS == HashItemState(&pItems[i]))
+		{
+			const char *key = (const char *)ItemAddress(pHashInf, &pItems[i]);
+			// Corrupt item of a loaded file, nothing is written.
+			if (IS_NULL(key))
+			{
+				bCorrupt = YES;
+				break;
+			}
+			nBlobSize += strlen(key) + 1;
+		}
+	}
+	pBlob = (YES == bCorrupt) ? NULL : MALLOC(char, nBlobSize + 1);
+	nBlobSize = 0;
+	for (int i=0; IS_NOT_NULL(pBlob) && (i<pHashInf->nTableSize); ++i)
+	{
+		if (HASH_ITEM_EXISTS == HashItemState(&pItems[i]))
+		{
+			const char *key = (const char *)ItemAddress(pHashInf, &pItems[i]);
+			size_t nKeySize = strlen(key) + 1;
+			memcpy(pBlob + nBlobSize, key, nKeySize);
+			pItems[i].pAddr = (void *)(size_t)nBlobSize;
+			nBlobSize += nKeySize;
+		}
+		else
+		{
+			pItems[i].pAddr = NULL;
+		}
+	}
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, HASH_FILE_MAGIC, sizeof(header.magic));
+	header.nVersion = HASH_FILE_VERSION;
+	header.nItemSize = sizeof(HashItem);
+	header.nMaxProbe = nMaxProbe;
+	header.bRobinHood = pHashInf->bRobinHood;
+	header.nTableSize = pHashInf->nTableSize;
+	header.nItemNum = pHashInf->nItemNum;
+	header.nDeletedNum = nDeletedNum;
+	header.nBlobSize = nBlobSize;
+
+	// Written beside, then renamed over path in one step.
+	sprintf(tmpPath, "%s.tmp", path);
+	if (IS_NOT_NULL(pBlob) && IS_NOT_NULL(fp = fopen(tmpPath, "wb")))
+	{
+		if ((1 == fwrite(&header, sizeof(header), 1, fp))
+				&& ((size_t)pHashInf->nTableSize == fwrite(pItems, sizeof(HashItem), pHashInf->nTableSize, fp))
+				&& (nBlobSize == fwrite(pBlob, 1, nBlobSize, fp))
+				&& (0 == fflush(fp)) && (0 == fsync(fileno(fp))))
+		{
+			ret = SUCCEED;
+		}
+		if ((0 != fclose(fp)) || (SUCCEED != ret) || (0 != rename(tmpPath, path)))
+		{
+			unlink(tmpPath);
+			ret = FAILED;
+		}
+	}
+
+	SECURE_FREE(pBlob);
+	FREE(pItems);
+	FREE(tmpPath);
+	return ret;
+}
+
+/**
+ * @brief Check head of a mapped file.
+ *
+ * @param pHeader Head of file, whole file is mapped after it.
+ * @param nFileSize Size of whole file.
+ * @return YES if file is a hash file of this machine, it's size matches and key blob ends with '\0'.
+ */
+static bool_t IsValidMappedHeader(const MappedHeader *pHeader, size_t nFileSize)
+{
+	if ((0 != memcmp(pHeader->magic, HASH_FILE_MAGIC, sizeof(pHeader->magic)))
+			|| (HASH_FILE_VERSION != pHeader->nVersion)
+			|| (sizeof(HashItem) != pHeader->nItemSize)
+			|| (pHeader->nTableSize < 1) || (pHeader->nTableSize > 0x7FFFFFFF)
+			|| (pHeader->nMaxProbe >= pHeader->nTableSize)
+			|| ((YES != pHeader->bRobinHood) && (NO != pHeader->bRobinHood))
+			|| (pHeader->nItemNum + pHeader->nDeletedNum > pHeader->nTableSize))
+	{
+		return NO;
+	}
+	if ((pHeader->nBlobSize > nFileSize)
+			|| (nFileSize != sizeof(MappedHeader) + sizeof(HashItem) * pHeader->nTableSize + pHeader->nBlobSize))
+	{
+		return NO;
+	}
+	// Every key ends inside key blob, see ItemAddress().
+	return ((0 == pHeader->nBlobSize) || ('\0' == ((const char *)pHeader)[nFileSize - 1])) ? YES : NO;
+}
+
+/**
+ * @brief Map a file saved by SaveHashInf() read only, search it where it is, without reading it first.
+ *
+ * @param path File to load.
+ * @return Pointer to loaded hash information, delete it by DeleteHashInf(), or NULL if file can not be
+ *         read or is not a valid hash file of this machine.
+ */
+HashInf *LoadHashInf(const char *path)
+{
+	struct stat fileStat;
+	void *pMapping;
+	int fd = open(path, O_RDONLY);
+
+	if (-1 == fd)
+	{
+		return NULL;
+	}
+	if ((0 != fstat(fd, &fileStat)) || ((size_t)fileStat.st_size < sizeof(MappedHeader)))
+	{
+		close(fd);
+		return NULL;
+	}
+	pMapping = mmap(NULL, fileStat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (MAP_FAILED == pMapping)
+	{
+		return NULL;
+	}
+
+	const MappedHeader *pHeader = (const MappedHeader *)pMapping;
+	HashInf *pHashInf = IsValidMappedHeader(pHeader, fileStat.st_size) ? (HashInf *)malloc(sizeof(HashInf)) : NULL;
+	if (IS_NULL(pHashInf))
+	{
+		munmap(pMapping, fileStat.st_size);
+		return NULL;
+	}
+	// Items are only read, insert, remove and upsert check pMapping before writing.
+	pHashInf->pHashTable = (HashItem *)(pHeader + 1);
+	pHashInf->nTableSize = (int)pHeader->nTableSize;
+	pHashInf->nItemNum = (int)pHeader->nItemNum;
+	pHashInf->nDeletedNum = (int)pHeader->nDeletedNum;
+	pHashInf->fMaxLoadFactor = DEFAULT_MAX_LOAD_FACTOR;
+	pHashInf->nKeyCheck = HASH_CHECK_FINGERPRINT;
+	// Saved with the table, loading reads no item.
+	pHashInf->nMaxProbe = pHeader->nMaxProbe;
+	pHashInf->bRobinHood = (bool_t)pHeader->bRobinHood;
+	pHashInf->pOldTable = NULL;
+	pHashInf->nOldTableSize = 0;
+	pHashInf->nOldMaxProbe = 0;
+	pHashInf->bOldRobinHood = YES;
+	pHashInf->nRehashPos = 0;
+	pHashInf->pBlob = (const char *)(pHashInf->pHashTable + pHashInf->nTableSize);
+	pHashInf->nBlobSize = (size_t)pHeader->nBlobSize;
+	pHashInf->pMapping = pMapping;
+	pHashInf->nMappingSize = fileStat.st_size;
+	pHashInf->bInternKeys = NO;
+	pHashInf->bKeyLenLost = NO;
+	StringPoolInit(&(pHashInf->keyPool));
+	KeyFilterInit(&(pHashInf->keyFilter));
+#ifdef HASH_STATS
+	pHashInf->statsSlots = CreateHashStatsSlots();
+	if (IS_NULL(pHashInf->statsSlots))
+	{
+		DeleteHashInf(&pHashInf);
+	}
+#endif
+	return pHashInf;
 }
@@ -12,6 +12,9 @@
 #define HASH_H_
 
 #include "../CProjectDfn.h"
+#include "../HashStats.h"
+#include "../KeyFilter.h"
+#include "../StringPool.h"
 #include "MPQHash.h"
 
 /**
@@ -20,15 +23,110 @@
  */
 #define ZOOM_TIMES_PREVENT_CONFLICT 1.5
 
+/**
+ * @brief Default max load factor, hash table grows before items take more than this part of it.
+ */
+#define DEFAULT_MAX_LOAD_FACTOR 0.75
+
+/**
+ * @brief Hash table is never smaller than this.
+ */
+#define MIN_HASH_TABLE_SIZE 16
+
+/**
+ * @brief Number of buckets moved from old table to new table on each insert while hash table grows.
+ * @note Must be at least 2, so old table is empty before new table needs to grow again.
+ */
+#define REHASH_BUCKETS_PER_INSERT 16
+
+/**
+ * @brief Number of strings hashed and prefetched together by GetStringAddressBatch().
+ */
+#define BATCH_GROUP_SIZE 16
+
+/**
+ * @brief How a lookup decides an item with matching hash values holds the key, see SetKeyCheck().
+ */
+#define HASH_CHECK_FINGERPRINT 0    ///< Hash A and B match, key is never read, default.
+#define HASH_CHECK_KEY         1    ///< Hash A and B match, then key length and bytes are compared.
+
+/**
+ * @brief Build every file with -DHASH_MAP_VALUES to keep a value in each item beside key address.
+ *
+ *   InsertStringValue() and friends then map a key to any pointer, and GetStringValue() returns it from
+ * the item the probe ends on, without reading anything the key points to. Each item is 8 bytes bigger,
+ * so it is not built by default. Without it the value functions return FAILED or NULL.
+ */
+
 typedef struct HashItem HashItem;
 
+/**
+ * @brief File saved by SaveHashInf(), mapped by LoadHashInf().
+ *
+ * +--------------+-----------------------------+------------------------------+
+ * | MappedHeader | HashItem x nTableSize       | keys, each followed by '\0'   |
+ * +--------------+-----------------------------+------------------------------+
+ *
+ *   Items are the hash table as it is in memory, except pAddr holds offset of key in key blob, so
+ * loaded table is searched where it is mapped without any change.
+ */
+#define HASH_FILE_MAGIC "MPQHASH1"           ///< First 8 bytes of file.
+#define HASH_FILE_VERSION 2
+
+/**
+ * @brief Head of file, all fields in byte order of machine writing it.
+ */
+typedef struct MappedHeader
+{
+	char magic[8];                ///< HASH_FILE_MAGIC.
+	unsigned int nVersion;        ///< HASH_FILE_VERSION.
+	unsigned int nItemSize;       ///< sizeof(HashItem) of machine writing it.
+	unsigned int nMaxProbe;       ///< Biggest HashItemProbeLen() of items, so loading reads no item.
+	unsigned int bRobinHood;      ///< YES if hash table is in Robin Hood order.
+	unsigned long long nTableSize;///< Number of items in hash table.
+	unsigned long long nItemNum;  ///< Number of keys.
+	unsigned long long nDeletedNum; ///< Number of deleted items.
+	unsigned long long nBlobSize; ///< Bytes of key blob.
+}MappedHeader;
+
 /**
  * @brief Hash information, including hash table and it's size.
+ *
+ *   When hash table is full enough, a table twice bigger is created and items are moved into it
+ * REHASH_BUCKETS_PER_INSERT buckets on each insert, so no insert pays for moving the whole table.
+ * While moving, an item is either in new table or old table, search looks in both.
+ *
+ *   Items are put by Robin Hood order, see PutHashItemRobinHood(), so a search for a missing key ends at
+ * the first item nearer to it's start than the probe is long, instead of running to an empty item, which
+ * is far away when table is nearly full. Each table keeps the longest probe of it's items as well, a table
+ * not in that order, e.g. built in parallel, is searched no further than that.
  */
 typedef struct HashTableInf
 {
 	HashItem *pHashTable;
 	int nTableSize;
+	int nItemNum;              ///< Number of items, in both tables while growing.
+	int nDeletedNum;           ///< Number of deleted items in pHashTable.
+	double fMaxLoadFactor;     ///< Hash table grows when items would take more than this part of it.
+	int nKeyCheck;             ///< HASH_CHECK_*.
+	unsigned int nMaxProbe;    ///< Biggest HashItemProbeLen() of items put into pHashTable.
+	bool_t bRobinHood;         ///< YES if pHashTable is in Robin Hood order, a missing key ends early.
+	HashItem *pOldTable;       ///< Table whose items are moving to pHashTable, NULL if not growing.
+	int nOldTableSize;         ///< Size of old table.
+	unsigned int nOldMaxProbe; ///< Biggest HashItemProbeLen() of items in old table.
+	bool_t bOldRobinHood;      ///< YES if old table is in Robin Hood order.
+	int nRehashPos;            ///< Buckets in old table before it are moved.
+	const char *pBlob;         ///< Keys of a loaded file, pAddr of items are offsets in it, NULL if built in memory.
+	size_t nBlobSize;          ///< Bytes of key blob, an offset past it is never turned into an address.
+	void *pMapping;            ///< Whole loaded file, NULL if built in memory.
+	size_t nMappingSize;       ///< Size of loaded file.
+	bool_t bInternKeys;        ///< YES after InternKeys(), pAddr of items point into keyPool.
+	bool_t bKeyLenLost;        ///< YES if a key with a length was kept without copying, see SetKeyCheck().
+	StringPool keyPool;        ///< Copies of keys, see InternKeys().
+	KeyFilter keyFilter;       ///< Checked before tables, no blocks until BuildKeyFilter().
+#ifdef HASH_STATS
+	HashStatsSlot *statsSlots; ///< Search counters of each thread, see HashStats.h.
+#endif
 }HashInf;
 
 /**
@@ -37,7 +135,7 @@ typedef struct HashTableInf
  * @param itemNum Number of items in array.
  * @param list Pointer pointed to list which will create hash information.
  * @param GetNextStr Method of how to get string from list.
- * @return Pointer to created hash information.
+ * @return Pointer to created hash information, or NULL if no memory.
  */
 HashInf *HashFromList(int itemNum, char *(GetNextStr)(void **), void *list);
 
@@ -46,10 +144,200 @@ HashInf *HashFromList(int itemNum, char *(GetNextStr)(void **), void *list);
  *
  * @param itemNum Number of items in array.
  * @param pArray Pointer pointed to array which will create hash information.
- * @return Pointer to created hash information.
+ * @return Pointer to created hash information, or NULL if no memory.
  */
 HashInf *HashFromArray(int itemNum, char **pArray);
 
+/**
+ * @brief Create hash information from a array, strings are hashed and inserted by many threads.
+ *
+ *   Array is cut into one part for each thread, each thread hashes it's part and claims items of the
+ * shared hash table with compare-and-swap. Link with -lpthread.
+ *
+ * @param itemNum Number of items in array.
+ * @param pArray Pointer pointed to array which will create hash information.
+ * @param nThreads Number of threads, 0 to use one for each online CPU, at most 4 for each online CPU.
+ * @return Pointer to created hash information, or NULL if threads can not be created.
+ */
+HashInf *HashFromArrayParallel(int itemNum, char **pArray, int nThreads);
+
+/**
+ * @brief Create hash information from keys with known length, keys need no terminating '\0'.
+ *
+ *   Keys are not copied, so their length is not kept and SetKeyCheck() can not set HASH_CHECK_KEY on it.
+ * To compare keys, set HASH_CHECK_KEY on an empty one and insert them by InsertKey().
+ *
+ * @param itemNum Number of keys.
+ * @param pKeys Address of each key, saved in hash table as it is, not copied.
+ * @param pLens Length of each key.
+ * @return Pointer to created hash information, or NULL if no memory.
+ */
+HashInf *HashFromKeys(int itemNum, const void **pKeys, const size_t *pLens);
+
+/**
+ * @brief Insert a string into created hash information, hash table grows if needed.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param str Which string want to insert, it is not checked whether already in hash table.
+ * @return SUCCEED, or FAILED if no memory to grow hash table.
+ */
+int InsertString(HashInf *pHashInf, const char *str);
+
+/**
+ * @brief Remove a string from created hash information, it's item is marked deleted.
+ *
+ * @param pHashInf Which hash information to remove from.
+ * @param str Which string want to remove.
+ * @return SUCCEED, or FAILED if string is not in hash table.
+ */
+int RemoveString(HashInf *pHashInf, const char *str);
+
+/**
+ * @brief Insert a string into created hash information, or replace same string already in it.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param str Which string want to insert, GetStringAddress() returns this address afterwards,
+ *            value of the string is set to NULL.
+ * @return SUCCEED, or FAILED if no memory to grow hash table.
+ */
+int UpsertString(HashInf *pHashInf, const char *str);
+
+/**
+ * @brief Insert a key with known length into created hash information, hash table grows if needed.
+ *
+ *   Keys are hashed by HashString3Len(), same bytes as a string inserted by InsertString() give the
+ * same item. Like strings, keys are matched by hash A and B, not compared byte by byte.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param key Which key want to insert, it is not checked whether already in hash table. It is not copied,
+ *            unless HASH_CHECK_KEY is set, then it is copied into key pool with it's length.
+ * @param len Length of key.
+ * @return SUCCEED, or FAILED if no memory to grow hash table or copy key.
+ */
+int InsertKey(HashInf *pHashInf, const void *key, size_t len);
+
+/**
+ * @brief Remove a key with known length from created hash information, it's item is marked deleted.
+ *
+ * @param pHashInf Which hash information to remove from.
+ * @param key Which key want to remove.
+ * @param len Length of key.
+ * @return SUCCEED, or FAILED if key is not in hash table.
+ */
+int RemoveKey(HashInf *pHashInf, const void *key, size_t len);
+
+/**
+ * @brief Insert a key with known length into created hash information, or replace same key already in it.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param key Which key want to insert, GetKeyAddress() returns this address afterwards, or it's copy
+ *            in key pool with HASH_CHECK_KEY, value of the key is set to NULL.
+ * @param len Length of key.
+ * @return SUCCEED, or FAILED if no memory to grow hash table or copy key.
+ */
+int UpsertKey(HashInf *pHashInf, const void *key, size_t len);
+
+/**
+ * @brief Insert a string with a value into created hash information, hash table grows if needed.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param str Which string want to insert, it is not checked whether already in hash table.
+ * @param pValue Value of string, GetStringValue() returns it.
+ * @return SUCCEED, or FAILED if no memory to grow hash table or built without HASH_MAP_VALUES.
+ */
+int InsertStringValue(HashInf *pHashInf, const char *str, void *pValue);
+
+/**
+ * @brief Insert a string with a value into created hash information, or replace value of same string.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param str Which string want to insert.
+ * @param pValue Value of string, GetStringValue() returns it.
+ * @return SUCCEED, or FAILED if no memory to grow hash table or built without HASH_MAP_VALUES.
+ */
+int UpsertStringValue(HashInf *pHashInf, const char *str, void *pValue);
+
+/**
+ * @brief Insert a key with known length and a value into created hash information.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param key Which key want to insert, it is not checked whether already in hash table. It is not copied,
+ *            unless HASH_CHECK_KEY is set, then it is copied into key pool with it's length.
+ * @param len Length of key.
+ * @param pValue Value of key, GetKeyValue() returns it.
+ * @return SUCCEED, or FAILED if no memory to grow hash table or copy key, or built without HASH_MAP_VALUES.
+ */
+int InsertKeyValue(HashInf *pHashInf, const void *key, size_t len, void *pValue);
+
+/**
+ * @brief Insert a key with known length and a value into created hash information, or replace value of
+ * same key.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param key Which key want to insert.
+ * @param len Length of key.
+ * @param pValue Value of key, GetKeyValue() returns it.
+ * @return SUCCEED, or FAILED if no memory to grow hash table or copy key, or built without HASH_MAP_VALUES.
+ */
+int UpsertKeyValue(HashInf *pHashInf, const void *key, size_t len, void *pValue);
+
+/**
+ * @brief Copy every key into a string pool owned by hash information, keys of later inserts are copied too.
+ *
+ *   Keys are copied in order of hash table, so keys next to each other in table are next to each other
+ * in memory. Afterwards lookups return address of the copy, and array, list or keys hash information is
+ * created from can be freed. MPQ items keep no key length, each key already in hash information must be
+ * a string ending with '\0', keys inserted later by InsertKey() are copied by their length. The first key
+ * inserted with a length while HASH_CHECK_KEY is set calls it, as a key cut out of a buffer has no '\0'
+ * to be measured by. Bytes of a
+ * removed key stay in pool until hash information is deleted.
+ *
+ * @param pHashInf Which hash information to intern keys of.
+ * @return SUCCEED, or FAILED if no memory or a key with a length was kept without it, see SetKeyCheck(),
+ *         nothing is changed then. A loaded file owns it's keys already,
+ *         SUCCEED is returned without copying.
+ */
+int InternKeys(HashInf *pHashInf);
+
+/**
+ * @brief Build a key filter from offset hashes of keys in hash information, checked before each search.
+ *
+ *   A key the filter has never seen is a miss without probing any table, see KeyFilter.h. No key is
+ * hashed again, items keep their offset hash. Filter is sized for keys hash table holds before it
+ * grows, later inserts are added to it, and it is built again each time hash table grows. A loaded
+ * file gets a filter as well, it is kept in memory only.
+ *
+ * @param pHashInf Which hash information to build filter of.
+ * @return SUCCEED, or FAILED if no memory, hash information has no filter then.
+ */
+int BuildKeyFilter(HashInf *pHashInf);
+
+/**
+ * @brief Set max load factor of hash table, takes effect on next insert.
+ *
+ * @param pHashInf Which hash information to set.
+ * @param fMaxLoadFactor Max part of hash table items can take, between 0 and 1.
+ */
+void SetMaxLoadFactor(HashInf *pHashInf, double fMaxLoadFactor);
+
+/**
+ * @brief Set how a lookup decides an item with matching hash values holds the key, takes effect on next call.
+ *
+ *   With HASH_CHECK_FINGERPRINT a key is matched by 64 bits of hash A and B (offset hash and 31 bits of
+ * hash A with MPQ_COMPACT_ITEMS), two keys with the same ones give the address of each other. With
+ * HASH_CHECK_KEY the key an item points to is compared by length and memcmp(), a colliding item is
+ * skipped and probe goes on, it costs a read of the key on every hit. Lookup, remove and upsert all use
+ * it. Strings are measured up to '\0'. A key with a length inserted while HASH_CHECK_KEY is set is copied
+ * into key pool by InternKeys(), which keeps it's length. A key with a length inserted before is kept
+ * without it, HASH_CHECK_KEY can not be set then.
+ *
+ * @param pHashInf Which hash information to set.
+ * @param nKeyCheck HASH_CHECK_FINGERPRINT or HASH_CHECK_KEY.
+ * @return SUCCEED, or FAILED if HASH_CHECK_KEY is asked for and a key with a length was kept without
+ *         it, nothing is changed then.
+ */
+int SetKeyCheck(HashInf *pHashInf, int nKeyCheck);
+
 /**
  * @brief Delete created hash information.
  *
@@ -66,4 +354,96 @@ void DeleteHashInf(HashInf **pHashTable);
  */
 void *GetStringAddress(HashInf *pHashTable, const char *str);
 
+/**
+ * @brief Get real key address, key has known length and needs no terminating '\0'.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param key Which key you want to find.
+ * @param len Length of key.
+ * @return Real key address, or NULL if not found.
+ */
+void *GetKeyAddress(HashInf *pHashInf, const void *key, size_t len);
+
+/**
+ * @brief Get value of a string, read from the same item GetStringAddress() finds.
+ *
+ *   Strings inserted without a value, by InsertString() or while building, have value NULL.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param str Which string you want to find.
+ * @return Value of string, or NULL if not found, built without HASH_MAP_VALUES or hash information is
+ *         loaded from a file, values are not saved.
+ */
+void *GetStringValue(HashInf *pHashInf, const char *str);
+
+/**
+ * @brief Get value of a key with known length.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param key Which key you want to find.
+ * @param len Length of key.
+ * @return Value of key, or NULL if not found, built without HASH_MAP_VALUES or hash information is
+ *         loaded from a file.
+ */
+void *GetKeyValue(HashInf *pHashInf, const void *key, size_t len);
+
+/**
+ * @brief Get real string address of many strings at once.
+ *
+ *   Strings are handled in groups of BATCH_GROUP_SIZE, all of a group are hashed and their buckets are
+ * prefetched before any is searched, so cache misses of the group overlap.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param keys Strings you want to find.
+ * @param n Number of strings.
+ * @param out Save real string address of each string, NULL if not found.
+ */
+void GetStringAddressBatch(HashInf *pHashInf, const char **keys, size_t n, void **out);
+
+/**
+ * @brief Get search counters of hash information, counted by all threads since it was created or reset.
+ *
+ *   Compares count pairs of hash A and B compared, mismatches count items with the same offset hash
+ * but different hash A or B.
+ *
+ * @param pHashInf Which hash information to query.
+ * @param pStats Save counters, all zero if built without HASH_STATS.
+ * @return SUCCEED, or FAILED if built without HASH_STATS.
+ * @see HashStats.h
+ */
+int GetHashStats(HashInf *pHashInf, HashStats *pStats);
+
+/**
+ * @brief Set search counters of hash information to zero.
+ *
+ * @param pHashInf Which hash information to reset.
+ */
+void ResetHashStats(HashInf *pHashInf);
+
+/**
+ * @brief Save hash information into a file, LoadHashInf() maps it back.
+ *
+ *   Keys are copied into the file, so it does not depend on memory of this process. MPQ items keep no
+ * key length, each key must be a string ending with '\0'. File is written beside path first and
+ * renamed, processes which mapped an older file keep reading it.
+ *
+ * @param pHashInf Which hash information to save.
+ * @param path Where to save.
+ * @return SUCCEED, or FAILED if no memory or file can not be written.
+ */
+int SaveHashInf(HashInf *pHashInf, const char *path);
+
+/**
+ * @brief Map a file saved by SaveHashInf() read only, search it where it is, without reading it first.
+ *
+ *   Addresses returned by lookups point into the mapped file. A loaded hash information can not be
+ * changed, insert, remove and upsert return FAILED. Processes loading the same file share one copy of
+ * it in page cache.
+ *
+ * @param path File to load.
+ * @return Pointer to loaded hash information, delete it by DeleteHashInf(), or NULL if file can not be
+ *         read or is not a valid hash file of this machine.
+ */
+HashInf *LoadHashInf(const char *path);
+
 #endif /* HASH_H_ */
@@ -11,40 +11,352 @@
 #ifndef MPQHASH_H_
 #define MPQHASH_H_
 
+#include <stddef.h>
+
+//! State of hash item, saved in it's state word, see HASH_ITEM_STATE.
+#define HASH_ITEM_EMPTY 0      ///< Never used, ends a probe.
+#define HASH_ITEM_EXISTS 1     ///< Holds an item.
+#define HASH_ITEM_DELETED 2    ///< Item removed, probe goes on, can be reused by insert.
+
+#ifdef MPQ_COMPACT_ITEMS
+
+//! Set in state word of an existing compact item, the other bits are hash A.
+#define HASH_ITEM_EXISTS_BIT 0x80000000U
+
+/**
+ * @brief Compact item, build every file with -DMPQ_COMPACT_ITEMS, 16 bytes instead of 24.
+ *
+ *   Hash B is not kept and existence is folded into hash A, so a key is checked by offset hash and 31
+ * bits of hash A. Offset hash stays, items are placed again by it when table grows. Files saved by
+ * SaveHashInf() are only loaded by programs with the same item layout.
+ */
+struct HashItem
+{
+	unsigned int HashKey;      ///< Offset hash, places item and checks key with hash A.
+	unsigned int nState;       ///< Hash A | HASH_ITEM_EXISTS_BIT, or HASH_ITEM_EMPTY or HASH_ITEM_DELETED.
+	void *pAddr;
+#ifdef HASH_MAP_VALUES
+	void *pValue;              ///< Value of key, see HASH_MAP_VALUES in Hash.h.
+#endif
+};
+
+//! Field of item holding it's state, changed atomically by concurrent and parallel inserts.
+#define HASH_ITEM_STATE nState
+
+#else
+
 struct HashItem
 {
-	int bExists;
-	unsigned int HashKey;
+	int bExists;               ///< HASH_ITEM_*.
+	unsigned int HashKey;      ///< Offset hash, used to place item again when table grows.
 	unsigned int nHashA;
 	unsigned int nHashB;
 	void *pAddr;
+#ifdef HASH_MAP_VALUES
+	void *pValue;              ///< Value of key, see HASH_MAP_VALUES in Hash.h.
+#endif
 };
 
+#define HASH_ITEM_STATE bExists
+
+#endif
+
+/**
+ * @brief State word of an existing item with hash A.
+ */
+static inline unsigned int HashItemWord(unsigned int nHashA)
+{
+#ifdef MPQ_COMPACT_ITEMS
+	return nHashA | HASH_ITEM_EXISTS_BIT;
+#else
+	(void)nHashA;
+	return HASH_ITEM_EXISTS;
+#endif
+}
+
+/**
+ * @brief HASH_ITEM_* of a state word.
+ */
+static inline int HashItemStateOf(unsigned int nWord)
+{
+#ifdef MPQ_COMPACT_ITEMS
+	return (nWord & HASH_ITEM_EXISTS_BIT) ? HASH_ITEM_EXISTS : (int)nWord;
+#else
+	return (int)nWord;
+#endif
+}
+
+static inline int HashItemState(const struct HashItem *pItem)
+{
+	return HashItemStateOf(pItem->HASH_ITEM_STATE);
+}
+
 /**
- * @brief Create crypt table, call it before initialize hash table.
+ * @brief Whether an item holds the key with these hash values.
+ *
+ * @param pItem Item to check.
+ * @param nWord State word of item, read by caller, atomically if needed.
+ * @return Non-zero if item exists and it's hash values match.
  */
-void PrepareCryptTable();
+static inline int IsHashItemOf(const struct HashItem *pItem, unsigned int nWord,
+		unsigned int nHash, unsigned int nHashA, unsigned int nHashB)
+{
+#ifdef MPQ_COMPACT_ITEMS
+	(void)nHashB;
+	return (nWord == HashItemWord(nHashA)) && (pItem->HashKey == nHash);
+#else
+	(void)nHash;
+	return (HASH_ITEM_EXISTS == nWord) && (pItem->nHashA == nHashA) && (pItem->nHashB == nHashB);
+#endif
+}
+
+/**
+ * @brief Hash A and B kept in an item, to place it again, compact items keep no hash B and give 0.
+ */
+static inline unsigned int HashItemA(const struct HashItem *pItem)
+{
+#ifdef MPQ_COMPACT_ITEMS
+	return pItem->nState & ~HASH_ITEM_EXISTS_BIT;
+#else
+	return pItem->nHashA;
+#endif
+}
+
+static inline unsigned int HashItemB(const struct HashItem *pItem)
+{
+#ifdef MPQ_COMPACT_ITEMS
+	(void)pItem;
+	return 0;
+#else
+	return pItem->nHashB;
+#endif
+}
+
+/**
+ * @brief Value kept in an item, always NULL without HASH_MAP_VALUES.
+ */
+static inline void *HashItemValue(const struct HashItem *pItem)
+{
+#ifdef HASH_MAP_VALUES
+	return pItem->pValue;
+#else
+	(void)pItem;
+	return NULL;
+#endif
+}
+
+static inline void SetHashItemValue(struct HashItem *pItem, void *pValue)
+{
+#ifdef HASH_MAP_VALUES
+	pItem->pValue = pValue;
+#else
+	(void)pItem;
+	(void)pValue;
+#endif
+}
+
+/**
+ * @brief Fill everything of an item but it's state word, caller sets it to HashItemWord(nHashA) after.
+ *
+ *   Value is set to NULL, SetHashItemValue() gives it one.
+ */
+static inline void FillHashItem(struct HashItem *pItem, unsigned int nHash, unsigned int nHashA,
+		unsigned int nHashB, void *pAddr)
+{
+	pItem->HashKey = nHash;
+#ifdef MPQ_COMPACT_ITEMS
+	(void)nHashA;
+	(void)nHashB;
+#else
+	pItem->nHashA = nHashA;
+	pItem->nHashB = nHashB;
+#endif
+	pItem->pAddr = pAddr;
+	SetHashItemValue(pItem, NULL);
+}
 
 /**
  * @brief Hash a string.
  */
 unsigned int HashString(const char *lpszFileName, unsigned int dwHashType);
 
+/**
+ * @brief Hash a string with offset, A and B hash types in one pass.
+ *
+ *   Same result as calling HashString() with hash type 0, 1 and 2, but the string is walked only once.
+ *
+ * @param lpszString String want to hash.
+ * @param pHash Save offset hash, decide start position in hash table.
+ * @param pHashA Save hash A, used to verify string.
+ * @param pHashB Save hash B, used to verify string.
+ */
+void HashString3(const char *lpszString, unsigned int *pHash, unsigned int *pHashA, unsigned int *pHashB);
+
+/**
+ * @brief Hash a key of known length, it needs no terminating '\0'.
+ *
+ *   Same result as HashString() on a string of the same bytes, letters are folded to upper case too.
+ */
+unsigned int HashStringLen(const void *key, size_t len, unsigned int dwHashType);
+
+/**
+ * @brief Hash a key of known length with offset, A and B hash types in one pass.
+ *
+ *   Same result as HashString3() on a string of the same bytes.
+ *
+ * @param key Key want to hash, needs no terminating '\0'.
+ * @param len Length of key.
+ * @param pHash Save offset hash, decide start position in hash table.
+ * @param pHashA Save hash A, used to verify key.
+ * @param pHashB Save hash B, used to verify key.
+ */
+void HashString3Len(const void *key, size_t len, unsigned int *pHash, unsigned int *pHashA, unsigned int *pHashB);
+
 /**
  * @brief Initialize hash table.
  * @param size Size of hash table.
- * return Created hash table.
+ * return Created hash table, or NULL if no memory.
  */
 struct HashItem* InitHashTable(int size);
 
+/**
+ * @brief Search where an item with known offset hash can be inserted, an empty or deleted item.
+ * @return Position of item, or -1 if hash table is full.
+ */
+int FindFreeHashItem(const struct HashItem *lpTable, unsigned int nTableSize, unsigned int nHash);
+
+/**
+ * @brief Insert an item with known hash values into hash table.
+ * @return Position of item, or -1 if hash table is full.
+ */
+int InsertHashItem(struct HashItem *lpTable, unsigned int nTableSize,
+		unsigned int nHash, unsigned int nHashA, unsigned int nHashB, void *pAddr);
+
+/**
+ * @brief Insert an item with known hash values into hash table, many threads can insert at the same time.
+ * @note No one may search hash table or use other insert functions until all inserting threads finish.
+ * @return Position of item, or -1 if hash table is full.
+ */
+int InsertHashItemAtomic(struct HashItem *lpTable, unsigned int nTableSize,
+		unsigned int nHash, unsigned int nHashA, unsigned int nHashB, void *pAddr);
+
+/**
+ * @brief Search an item with known hash values in hash table.
+ * @return Position of item, or -1 if not found.
+ */
+int FindHashItem(const struct HashItem *lpTable, unsigned int nTableSize,
+		unsigned int nHash, unsigned int nHashA, unsigned int nHashB);
+
+/**
+ * @brief Number of items an item is after the one it's probe starts from, 0 if it got it's first choice.
+ *
+ *   Insert functions return the position, keep the biggest of these as max probe length of a table, then
+ * FindHashItemBounded() gives up on a missing key after that many more items. Deleted items keep their
+ * offset hash, so they have a probe length as well.
+ *
+ * @param nHashPos Position of item.
+ * @param nHash Offset hash of item.
+ * @param nTableSize Size of hash table.
+ * @return Probe length of item.
+ */
+static inline unsigned int HashItemProbeLen(unsigned int nHashPos, unsigned int nHash, unsigned int nTableSize)
+{
+	unsigned int nHashStart = nHash % nTableSize;
+	return (nHashPos >= nHashStart) ? (nHashPos - nHashStart) : (nHashPos + nTableSize - nHashStart);
+}
+
+/**
+ * @brief Search an item with known hash values, probe no further than max probe length of table.
+ *
+ *   No item of table is further than nMaxProbe from it's start, so a missing key ends after nMaxProbe + 1
+ * items even if no empty item comes, e.g. in a full table. Max probe length only grows, removing items
+ * leaves it as it is.
+ *
+ * @param nMaxProbe Biggest HashItemProbeLen() of items in table, nTableSize - 1 if not known.
+ * @return Position of item, or -1 if not found.
+ */
+int FindHashItemBounded(const struct HashItem *lpTable, unsigned int nTableSize,
+		unsigned int nHash, unsigned int nHashA, unsigned int nHashB, unsigned int nMaxProbe);
+
+/**
+ * @brief Put a filled item into hash table by Robin Hood order, an item further from it's start takes the
+ * place of one nearer to it's start, which moves on.
+ *
+ *   When every item of a table is put by Robin Hood order, probe lengths along a probe never drop by more
+ * than one from an item to the next, so FindHashItemRobinHood() ends a missing key as soon as it meets an
+ * item nearer to it's start than the probe is long. A deleted item is reused only if it was no further
+ * from it's start, which keeps that order. Other items of table may move, keep no position across inserts.
+ *
+ * @param lpTable Table to put in, must have an empty item.
+ * @param nTableSize Size of hash table.
+ * @param pItem Item to put, on return it holds the empty or deleted item it's probe ended on.
+ * @param pMaxProbe Raised to probe length of each item placed, can be NULL.
+ * @return Position of new item, or -1 if no item can take it.
+ */
+int PutHashItemRobinHood(struct HashItem *lpTable, unsigned int nTableSize, struct HashItem *pItem,
+		unsigned int *pMaxProbe);
+
+/**
+ * @brief Insert an item with known hash values into hash table by Robin Hood order, see PutHashItemRobinHood().
+ * @return Position of item, or -1 if hash table has no empty item.
+ */
+int InsertHashItemRobinHood(struct HashItem *lpTable, unsigned int nTableSize,
+		unsigned int nHash, unsigned int nHashA, unsigned int nHashB, void *pAddr);
+
+/**
+ * @brief Search an item with known hash values in a table filled by Robin Hood order.
+ *
+ *   Probe ends at an empty item, or at an item nearer to it's start than the probe is long, the key would
+ * have taken that place, so a missing key costs about as many items as an average probe.
+ *
+ * @return Position of item, or -1 if not found.
+ */
+int FindHashItemRobinHood(const struct HashItem *lpTable, unsigned int nTableSize,
+		unsigned int nHash, unsigned int nHashA, unsigned int nHashB);
+
 /**
  * @brief Insert a string into hash table.
+ * @return Position of string, or -1 if hash table is full.
  */
 int InsertHash(const char *lpszString, struct HashItem *lpTable, unsigned int nTableSize);
 
 /**
  * @brief Search a string in hash table.
+ * @return Position of string, or -1 if not found.
  */
 int GetHashTablePos(const char *lpszString,struct HashItem* lpTable, unsigned int nTableSize);
 
+/**
+ * @brief Search a string in hash table, probe no further than max probe length of table.
+ * @param nMaxProbe Biggest HashItemProbeLen() of items in table, see FindHashItemBounded().
+ * @return Position of string, or -1 if not found.
+ */
+int GetHashTablePosBounded(const char *lpszString, struct HashItem *lpTable, unsigned int nTableSize,
+		unsigned int nMaxProbe);
+
+/**
+ * @brief Insert a string into hash table by Robin Hood order, other strings may move.
+ * @return Position of string, or -1 if hash table has no empty item.
+ */
+int InsertHashRobinHood(const char *lpszString, struct HashItem *lpTable, unsigned int nTableSize);
+
+/**
+ * @brief Search a string in hash table filled by InsertHashRobinHood(), a missing string ends early.
+ * @return Position of string, or -1 if not found.
+ */
+int GetHashTablePosRobinHood(const char *lpszString, struct HashItem *lpTable, unsigned int nTableSize);
+
+/**
+ * @brief Search a key with known length in hash table, an item with matching hash values must also point to
+ * the same bytes.
+ *
+ *   Items with the same hash values but another key are skipped, so a collision of hash A and B never
+ * gives a wrong position. Length is compared first, then bytes by memcmp(), so key needs no terminating
+ * '\0' and may be cut out of a buffer. Items must point to strings, as InsertHash() leaves them, their
+ * length is found by strnlen().
+ *
+ * @return Position of key, or -1 if not found.
+ */
+int GetHashTablePosVerified(const void *key, size_t len, struct HashItem *lpTable, unsigned int nTableSize);
+
 #endif /* MPQHASH_H_ */
@@ -34,16 +34,71 @@
  *                                                NULL
  */
 
+#include <pthread.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "Hash.h"
+#include "HashMethodInline.h"
+
+//! Most threads of HashFromArrayParallel() for each online CPU.
+#define MAX_BUILD_THREADS_PER_CPU 4
+
+/**
+ * @brief Data shared by all threads of HashFromArrayParallel().
+ *
+ *   Chained layout is built in phases, threads are joined between phases:
+ *   1. Each thread hashes it's part of array into pItems, and counts how many fall in each bucket range.
+ *   2. Each thread copies indexes of it's part into pOrder, grouped by bucket range.
+ *   3. Each thread links strings of one bucket range, no other thread touches these buckets.
+ * Open addressing layout has only phase 1, each thread claims slots with compare-and-swap.
+ */
+typedef struct BuildShared
+{
+	HashInf *hashInf;          ///< Hash information being built.
+	char **pArray;             ///< Array of all strings.
+	int itemNum;               ///< Number of strings.
+	int nThreads;              ///< Number of threads, also number of bucket ranges.
+	int nPhase;                ///< Which phase to run.
+	unsigned int *pOrder;      ///< Indexes of strings grouped by bucket range.
+	unsigned int *pCount;      ///< [thread * nThreads + range], counted in phase 1, then write offset.
+	unsigned int *pRangeStart; ///< First index in pOrder of each range, and total at the end.
+	HashItem *pItems;          ///< One hash item for each string, chained layout.
+}BuildShared;
+
+/**
+ * @brief Slot table and key blob being filled by SaveHashInf().
+ */
+typedef struct SaveContext
+{
+	MappedSlot *pSlots;        ///< Slot table, NULL while only counting key bytes.
+	unsigned int nSlotBits;    ///< Number of slots is 2^nSlotBits.
+	char *pBlob;               ///< Key blob.
+	unsigned long long nBlobSize; ///< Bytes of key blob used.
+	bool_t bFull;              ///< YES if a key found no empty slot, more keys than counted items.
+}SaveContext;
+
+/**
+ * @brief Work of one thread in HashFromArrayParallel().
+ */
+typedef struct BuildTask
+{
+	BuildShared *pShared;      ///< Shared by all threads.
+	int nThread;               ///< Index of this thread, also of the bucket range it links.
+}BuildTask;
 
 /**
  * @brief Create hash table.
  * @param size Size of hash table.
- * @return created hash table, nothing in table.
+ * @return created hash table, nothing in table, or NULL if no memory.
  */
 static HashTable *InitHashTable(int size)
 {
 	HashTable *hashTable = (HashTable *)malloc(sizeof(HashItem *) * size);
+	if (IS_NULL(hashTable))
+	{
+		return NULL;
+	}
 	for (int i=0; i<size ;i++ )
 	{
 		hashTable[i] = NULL;
@@ -52,22 +107,15 @@ static HashTable *InitHashTable(int size)
 }
 
 /**
- * @brief Insert a string to hash table.
+ * @brief Link a hash item into list of it's bucket.
  *
- * @param hashTable Which hash table to insert.
+ * @param hashTable Which hash table to link.
  * @param nTableSize Size of hash table.
- * @param HashMethod Which hash method is going to use to add hash table.
- * @param str Which string want to insert into hash table.
+ * @param pHashItem Hash item with hash key set.
  */
-static void InsertHash(HashTable *hashTable, unsigned int nTableSize,
-		               unsigned int (*HashMethod)(const char *), const char *str)
+static void LinkHashItem(HashTable *hashTable, unsigned int nTableSize, HashItem *pHashItem)
 {
-	unsigned int nHash = (*HashMethod)(str);
-	unsigned int position = nHash % nTableSize;
-
-	HashItem *pHashItem = (HashItem *)malloc(sizeof(HashItem));
-	pHashItem->item = (char *)str;
-	pHashItem->HashKey = nHash;
+	unsigned int position = pHashItem->HashKey % nTableSize;
 
 	if (NULL == hashTable[position])
 	{
@@ -81,130 +129,1850 @@ static void InsertHash(HashTable *hashTable, unsigned int nTableSize,
 }
 
 /**
- * @brief Create hash information from a array.
+ * @brief Unlink a hash item from list of it's bucket, next item becomes head if it was the head.
  *
- * @param itemNum Number of items in array.
- * @param pArray Pointer pointed to array which will create hash information.
- * @param HashMethod Which hash method will be used to create hash table, method listed in HashMethod.h.
- * @see HashMethod.h
- * @return Pointer to created hash information.
+ * @param hashTable Which hash table to unlink.
+ * @param nTableSize Size of hash table.
+ * @param pHashItem Hash item in hash table.
  */
-HashInf *HashFromArray(int itemNum, char **pArray,
-		               unsigned int (*HashMethod)(const char *))
+static void UnlinkHashItem(HashTable *hashTable, unsigned int nTableSize, HashItem *pHashItem)
 {
-	HashInf *hashInf = (HashInf *)malloc(sizeof(HashInf));
-	hashInf->pHashTable = InitHashTable(itemNum);
-	hashInf->nTableSize = itemNum;
-	hashInf->HashMethod = HashMethod;
+	unsigned int position = pHashItem->HashKey % nTableSize;
 
-	// Add each string to hash table.
-	for (int i=0; i<itemNum; ++i)
+	if (pHashItem == hashTable[position])
 	{
-		InsertHash(hashInf->pHashTable, hashInf->nTableSize, hashInf->HashMethod, pArray[i]);
+		hashTable[position] = list_empty(&(pHashItem->node)) ? NULL
+				: list_entry(pHashItem->node.next, HashItem, node);
 	}
-	return hashInf;
+	list_del(&(pHashItem->node));
 }
 
 /**
- * @brief Create hash information from list.
- *
- * @param itemNum Number of items in array.
- * @param list Pointer pointed to list which will create hash information.
- * @param GetNextStr Method of how to get string from list.
- * @param HashMethod Which hash method will be used to create hash table, method listed in HashMethod.h.
- * @see HashMethod.h
- * @return Pointer to created hash information.
+ * @brief Value kept in a hash item, always NULL without HASH_MAP_VALUES.
  */
-HashInf *HashFromList(int itemNum, void *list,
-		              char *(GetNextStr)(void **),
-		              unsigned int (*HashMethod)(const char *))
+static inline void *ItemValue(const HashItem *pHashItem)
 {
-	char *str = NULL;
-	int hashTableIndex;
+#ifdef HASH_MAP_VALUES
+	return pHashItem->pValue;
+#else
+	(void)pHashItem;
+	return NULL;
+#endif
+}
 
-	HashInf *hashInf = (HashInf *)malloc(sizeof(HashInf));
-	hashInf->pHashTable = InitHashTable(itemNum);
-	hashInf->nTableSize = itemNum;
-	hashInf->HashMethod = HashMethod;
+static inline void SetItemValue(HashItem *pHashItem, void *pValue)
+{
+#ifdef HASH_MAP_VALUES
+	pHashItem->pValue = pValue;
+#else
+	(void)pHashItem;
+	(void)pValue;
+#endif
+}
 
-	// Get every string in list and add them to hash table.
-	while(NULL != (str = (*GetNextStr)(&list)))
+/**
+ * @brief Insert a key to hash table.
+ *
+ * @param hashTable Which hash table to insert.
+ * @param nTableSize Size of hash table.
+ * @param pSlab Where to allocate hash item from.
+ * @param nHash Hash key of key.
+ * @param key Which key want to insert into hash table.
+ * @param len Length of key.
+ * @param pValue Value of key, only kept with HASH_MAP_VALUES.
+ * @return SUCCEED, or FAILED if no memory.
+ */
+static int InsertHash(HashTable *hashTable, unsigned int nTableSize, Slab *pSlab,
+		              unsigned int nHash, const void *key, size_t len, void *pValue)
+{
+	HashItem *pHashItem = (HashItem *)SlabAlloc(pSlab);
+	if (IS_NULL(pHashItem))
 	{
-		InsertHash(hashInf->pHashTable, hashInf->nTableSize, hashInf->HashMethod, str);
+		return FAILED;
 	}
-
-	return hashInf;
+	pHashItem->item = (void *)key;
+	pHashItem->HashKey = nHash;
+	pHashItem->nKeyLen = (unsigned int)len;
+	SetItemValue(pHashItem, pValue);
+	LinkHashItem(hashTable, nTableSize, pHashItem);
+	return SUCCEED;
 }
 
 /**
- * @brief Delete created hash information.
+ * @brief Check whether a hash item holds a key, hash key is compared before bytes.
  *
- * @param pHashInf Pointer to which hash information you want to delete.
+ * @param pHashItem Which hash item to check.
+ * @param nHash Hash key of key.
+ * @param key Which key you want to find.
+ * @param len Length of key.
+ * @param pStats Counters of calling thread, only used with HASH_STATS.
+ * @return YES if hash item holds the key.
  */
-void DeleteHashInf(HashInf **pHashInf)
+static inline bool_t IsHashItemOf(const HashItem *pHashItem, unsigned int nHash, const void *key, size_t len,
+		HashStats *pStats)
 {
-	struct list_head *currNode, *nextNode;
-	HashItem *pHashItem;
-
-	if (IS_NOT_FREED(*pHashInf))
+	if (nHash != pHashItem->HashKey)
 	{
-		HashTable *pHashTable = (*pHashInf)->pHashTable;
-
-		// Free each list in hash table.
-		for (int i=0; i< (*pHashInf)->nTableSize; ++i)
-		{
-			if (IS_NOT_NULL(pHashTable[i]))
-			{
-				list_for_each_safe(currNode, nextNode, &(pHashTable[i]->node))
-				{
-					pHashItem = list_entry(currNode, struct HashItem, node);
-					list_del(currNode);
-					FREE(pHashItem);
-				}
-				// Free list head in hash table.
-				FREE(pHashTable[i]);
-			}
-		}
-		SECURE_FREE((*pHashInf)->pHashTable);
-		FREE(*pHashInf);
+		return NO;
+	}
+	HASH_STATS_ADD(pStats, nCompares, 1);
+	if (IS_SAME_KEY(key, len, pHashItem->item, pHashItem->nKeyLen))
+	{
+		return YES;
 	}
+	HASH_STATS_ADD(pStats, nHashMismatches, 1);
+	return NO;
 }
 
 /**
- * @brief Get real string address, the string must be in array or list which created hash information.
+ * @brief Search a key in chained hash table.
  *
- * @param pHashInf Pointer to which hash information you want to delete.
- * @param str Which string you want to find.
- * @return Real string address you want to search.
+ * @param pHashInf Which hash information to search.
+ * @param nHash Hash key of key.
+ * @param key Which key you want to find.
+ * @param len Length of key.
+ * @return Hash item of key, or NULL if not found.
  */
-void *GetStringAddress(HashInf *pHashInf, const char *str)
+static inline HashItem *FindHashItem(HashInf *pHashInf, unsigned int nHash, const void *key, size_t len)
 {
-	unsigned int nHash = (*(pHashInf->HashMethod))(str);
 	unsigned int position = nHash % pHashInf->nTableSize;
+	HashStats *pStats = HASH_STATS_OF(pHashInf);
 
 	// Check if there is a list.
 	if (NULL == pHashInf->pHashTable[position])
 	{
+		CountHashSearch(pStats, NO, 0);
 		return NULL;
 	}
 
 	// Check if the head is the string you want to search.
 	HashItem *pHashItem = pHashInf->pHashTable[position];
-	if ((nHash == pHashItem->HashKey) && (0 == strcmp(str, (char *)pHashItem->item)))
+	if (IsHashItemOf(pHashItem, nHash, key, len, pStats))
 	{
-		return pHashItem->item;
+		CountHashSearch(pStats, YES, 1);
+		return pHashItem;
 	}
 
 	// Read the whole list and find out where is the string.
 	struct list_head *pos;
+	unsigned int nProbes = 1;
 	list_for_each(pos, &(pHashInf->pHashTable[position]->node))
 	{
+		++nProbes;
 		pHashItem= list_entry(pos, HashItem, node);
-		if ((nHash == pHashItem->HashKey) && (0 == strcmp(str, (char *)pHashItem->item)))
+		if (IsHashItemOf(pHashItem, nHash, key, len, pStats))
 		{
-			return pHashItem->item;
+			CountHashSearch(pStats, YES, nProbes);
+			return pHashItem;
 		}
 	}
 
+	CountHashSearch(pStats, NO, nProbes);
+	return NULL;
+}
+
+/**
+ * @brief Count a key rejected by key filter, as a miss without probes.
+ * @param pStats Counters of current thread, NULL if not counted.
+ */
+static inline void CountFilterReject(HashStats *pStats)
+{
+	HASH_STATS_ADD(pStats, nFilterRejects, 1);
+	CountHashSearch(pStats, NO, 0);
+}
+
+/**
+ * @brief Check key filter of hash information before a search.
+ *
+ * @param pHashInf Which hash information to check.
+ * @param nHash Hash key of key.
+ * @return YES if key is surely not in hash table, NO if it has to be searched.
+ */
+static inline bool_t IsFilteredOut(HashInf *pHashInf, unsigned int nHash)
+{
+	if (YES == KeyFilterMayContain(&(pHashInf->keyFilter), nHash))
+	{
+		return NO;
+	}
+	CountFilterReject(HASH_STATS_OF(pHashInf));
+	return YES;
+}
+
+/**
+ * @brief Get real key address from it's hash key, no matter which layout it is.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param nHash Hash key of key.
+ * @param key Which key you want to find.
+ * @param len Length of key.
+ * @return Real key address, or NULL if not found.
+ */
+static inline void *FindAddress(HashInf *pHashInf, unsigned int nHash, const void *key, size_t len)
+{
+	if (IsFilteredOut(pHashInf, nHash))
+	{
+		return NULL;
+	}
+
+	// Open addressing layout, probe slots.
+	if (IS_NOT_NULL(pHashInf->pSlots))
+	{
+		HashSlot *pSlot = FindSlot(pHashInf->pSlots, pHashInf->nSlotBits, nHash, key, len, HASH_STATS_OF(pHashInf));
+		return IS_NOT_NULL(pSlot) ? pSlot->item : NULL;
+	}
+
+	HashItem *pHashItem = FindHashItem(pHashInf, nHash, key, len);
+	return IS_NOT_NULL(pHashItem) ? pHashItem->item : NULL;
+}
+
+/**
+ * @brief Hash a string of known length with hash method of hash information.
+ *
+ * @param pHashInf Which hash information the string is for.
+ * @param str String to hash.
+ * @param len Length of string.
+ * @return Hash key of string.
+ */
+static inline unsigned int HashOfString(HashInf *pHashInf, const char *str, size_t len)
+{
+	return IS_NOT_NULL(pHashInf->HashMethodLen) ? (*(pHashInf->HashMethodLen))(str, len)
+			: (*(pHashInf->HashMethod))(str);
+}
+
+/**
+ * @brief Get real string address, hash method is called through pointer, used for methods not in HashMethod.h.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param str Which string you want to find.
+ * @return Real string address, or NULL if not found.
+ */
+static void *GetStringAddressAnyMethod(HashInf *pHashInf, const char *str)
+{
+	size_t len = strlen(str);
+	return FindAddress(pHashInf, HashOfString(pHashInf, str, len), str, len);
+}
+
+/**
+ * @brief Get real key address, hash method is called through pointer, used for methods not in HashMethod.h.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param key Which key you want to find.
+ * @param len Length of key.
+ * @return Real key address, or NULL if not found or hash method has no length version.
+ */
+static void *GetKeyAddressAnyMethod(HashInf *pHashInf, const void *key, size_t len)
+{
+	if (IS_NULL(pHashInf->HashMethodLen))
+	{
+		return NULL;
+	}
+	return FindAddress(pHashInf, (*(pHashInf->HashMethodLen))(key, len), key, len);
+}
+
+/**
+ * @brief Define lookup functions of a hash method in HashMethod.h, hash method is compiled into probe.
+ *
+ *   String is measured once, then hashed and compared by it's length, no byte is checked for '\0' again.
+ */
+#define DEFINE_METHOD_LOOKUP(method) \
+	void *GetStringAddress##method(HashInf *pHashInf, const char *str) \
+	{ \
+		size_t len = strlen(str); \
+		return FindAddress(pHashInf, method##LenInline(str, len), str, len); \
+	} \
+	static void *GetKeyAddress##method(HashInf *pHashInf, const void *key, size_t len) \
+	{ \
+		return FindAddress(pHashInf, method##LenInline(key, len), key, len); \
+	}
+
+DEFINE_METHOD_LOOKUP(SDBMHash)
+DEFINE_METHOD_LOOKUP(RSHash)
+DEFINE_METHOD_LOOKUP(JSHash)
+DEFINE_METHOD_LOOKUP(PJWHash)
+DEFINE_METHOD_LOOKUP(ELFHash)
+DEFINE_METHOD_LOOKUP(BKDRHash)
+DEFINE_METHOD_LOOKUP(DJBHash)
+DEFINE_METHOD_LOOKUP(APHash)
+DEFINE_METHOD_LOOKUP(WordHash)
+
+/**
+ * @brief Length version and lookup functions compiled for each hash method in HashMethod.h.
+ */
+static const struct
+{
+	unsigned int (*HashMethod)(const char *);
+	unsigned int (*HashMethodLen)(const void *, size_t);
+	LookupMethod Lookup;
+	LookupKeyMethod LookupKey;
+}methodLookups[] =
+{
+	{SDBMHash, SDBMHashLen, GetStringAddressSDBMHash, GetKeyAddressSDBMHash},
+	{RSHash, RSHashLen, GetStringAddressRSHash, GetKeyAddressRSHash},
+	{JSHash, JSHashLen, GetStringAddressJSHash, GetKeyAddressJSHash},
+	{PJWHash, PJWHashLen, GetStringAddressPJWHash, GetKeyAddressPJWHash},
+	{ELFHash, ELFHashLen, GetStringAddressELFHash, GetKeyAddressELFHash},
+	{BKDRHash, BKDRHashLen, GetStringAddressBKDRHash, GetKeyAddressBKDRHash},
+	{DJBHash, DJBHashLen, GetStringAddressDJBHash, GetKeyAddressDJBHash},
+	{APHash, APHashLen, GetStringAddressAPHash, GetKeyAddressAPHash},
+	{WordHash, WordHashLen, GetStringAddressWordHash, GetKeyAddressWordHash},
+	{VectorHash, VectorHashLen, GetStringAddressAnyMethod, GetKeyAddressAnyMethod},
+};
+
+/**
+ * @brief Get key of a slot in a loaded file.
+ *
+ *   Slots are not read when a file is loaded, so offset and length are checked here, a corrupt slot never
+ * gives a key outside key blob.
+ *
+ * @param pHashInf Loaded hash information.
+ * @param pSlot Used slot.
+ * @return Address of key, followed by '\0', or NULL if slot points outside key blob.
+ */
+static inline const char *MappedKey(const HashInf *pHashInf, const MappedSlot *pSlot)
+{
+	if ((pSlot->nOffset >= pHashInf->nBlobSize) || (pSlot->nKeyLen >= pHashInf->nBlobSize - pSlot->nOffset)
+			|| ('\0' != pHashInf->pBlob[pSlot->nOffset + pSlot->nKeyLen]))
+	{
+		return NULL;
+	}
+	return pHashInf->pBlob + pSlot->nOffset;
+}
+
+/**
+ * @brief Search a key in slots of a loaded file.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param nHash Hash key of key.
+ * @param key Which key you want to find.
+ * @param len Length of key.
+ * @return Address of key in mapped file, or NULL if not found.
+ */
+static inline void *FindMapped(HashInf *pHashInf, unsigned int nHash, const void *key, size_t len)
+{
+	const MappedSlot *pSlots = pHashInf->pMappedSlots;
+	unsigned int nMask = (1U << pHashInf->nSlotBits) - 1;
+	unsigned int nPos = SlotIndex(nHash, pHashInf->nSlotBits);
+	unsigned int nProbes = 0;
+	HashStats *pStats = HASH_STATS_OF(pHashInf);
+
+	if (IsFilteredOut(pHashInf, nHash))
+	{
+		return NULL;
+	}
+	// A corrupt file may have no empty slot, no probe goes past every slot once.
+	while ((nProbes <= nMask) && (MAPPED_SLOT_EMPTY != pSlots[nPos].nOffset))
+	{
+		++nProbes;
+		if (nHash == pSlots[nPos].HashKey)
+		{
+			const char *item = MappedKey(pHashInf, &pSlots[nPos]);
+			HASH_STATS_ADD(pStats, nCompares, 1);
+			if (IS_NOT_NULL(item) && IS_SAME_KEY(key, len, item, pSlots[nPos].nKeyLen))
+			{
+				CountHashSearch(pStats, YES, nProbes);
+				return (void *)item;
+			}
+			HASH_STATS_ADD(pStats, nHashMismatches, 1);
+		}
+		nPos = (nPos + 1) & nMask;
+	}
+	CountHashSearch(pStats, NO, nProbes);
 	return NULL;
 }
+
+/**
+ * @brief Get real string address in a loaded file.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param str Which string you want to find.
+ * @return Address of string in mapped file, or NULL if not found.
+ */
+static void *GetStringAddressMapped(HashInf *pHashInf, const char *str)
+{
+	size_t len = strlen(str);
+	return FindMapped(pHashInf, (*(pHashInf->HashMethodLen))(str, len), str, len);
+}
+
+/**
+ * @brief Get real key address in a loaded file.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param key Which key you want to find.
+ * @param len Length of key.
+ * @return Address of key in mapped file, or NULL if not found.
+ */
+static void *GetKeyAddressMapped(HashInf *pHashInf, const void *key, size_t len)
+{
+	return FindMapped(pHashInf, (*(pHashInf->HashMethodLen))(key, len), key, len);
+}
+
+/**
+ * @brief Select hash methods and lookup functions of hash information, from either version of hash method.
+ *
+ * @param hashInf Which hash information to set.
+ * @param HashMethod String version of hash method, or NULL.
+ * @param HashMethodLen Length version of hash method, or NULL.
+ */
+static void SelectMethods(HashInf *hashInf, unsigned int (*HashMethod)(const char *),
+		                  unsigned int (*HashMethodLen)(const void *, size_t))
+{
+	hashInf->HashMethod = HashMethod;
+	hashInf->HashMethodLen = HashMethodLen;
+	hashInf->Lookup = GetStringAddressAnyMethod;
+	hashInf->LookupKey = GetKeyAddressAnyMethod;
+
+	for (unsigned int i=0; i<ARRAY_SIZE(methodLookups); ++i)
+	{
+		if ((IS_NOT_NULL(HashMethod) && (HashMethod == methodLookups[i].HashMethod))
+				|| (IS_NOT_NULL(HashMethodLen) && (HashMethodLen == methodLookups[i].HashMethodLen)))
+		{
+			hashInf->HashMethod = methodLookups[i].HashMethod;
+			hashInf->HashMethodLen = methodLookups[i].HashMethodLen;
+			hashInf->Lookup = methodLookups[i].Lookup;
+			hashInf->LookupKey = methodLookups[i].LookupKey;
+			return;
+		}
+	}
+}
+
+/**
+ * @brief Create key filter for keys hash table holds before it grows, add every key in it.
+ *
+ * @param pHashInf Which hash information to fill filter of.
+ * @return SUCCEED, or FAILED if no memory, HASH_KEY_FILTER is cleared then.
+ */
+static int FillKeyFilter(HashInf *pHashInf)
+{
+	struct list_head *pos;
+	unsigned long long nKeys = pHashInf->nItemNum;
+
+	if (IS_NOT_NULL(pHashInf->pSlots))
+	{
+		nKeys = MAX(nKeys, ((unsigned long long)OPEN_HASH_MAX_LOAD_PERCENT << pHashInf->nSlotBits) / 100);
+	}
+	else if (IS_NOT_NULL(pHashInf->pHashTable))
+	{
+		nKeys = MAX(nKeys, (unsigned long long)pHashInf->nTableSize * MAX_ITEMS_PER_BUCKET);
+	}
+	if (FAILED == KeyFilterCreate(&(pHashInf->keyFilter), nKeys))
+	{
+		pHashInf->flags &= ~HASH_KEY_FILTER;
+		return FAILED;
+	}
+
+	for (int i=0; IS_NOT_NULL(pHashInf->pMappedSlots) && (i<pHashInf->nTableSize); ++i)
+	{
+		if (MAPPED_SLOT_EMPTY != pHashInf->pMappedSlots[i].nOffset)
+		{
+			KeyFilterAdd(&(pHashInf->keyFilter), pHashInf->pMappedSlots[i].HashKey);
+		}
+	}
+	for (int i=0; IS_NOT_NULL(pHashInf->pSlots) && (i<pHashInf->nTableSize); ++i)
+	{
+		if (IS_NOT_NULL(pHashInf->pSlots[i].item))
+		{
+			KeyFilterAdd(&(pHashInf->keyFilter), pHashInf->pSlots[i].HashKey);
+		}
+	}
+	for (int i=0; IS_NOT_NULL(pHashInf->pHashTable) && (i<pHashInf->nTableSize); ++i)
+	{
+		HashItem *pHead = pHashInf->pHashTable[i];
+		if (IS_NOT_NULL(pHead))
+		{
+			KeyFilterAdd(&(pHashInf->keyFilter), pHead->HashKey);
+			list_for_each(pos, &(pHead->node))
+			{
+				HashItem *pHashItem = list_entry(pos, HashItem, node);
+				KeyFilterAdd(&(pHashInf->keyFilter), pHashItem->HashKey);
+			}
+		}
+	}
+	pHashInf->flags |= HASH_KEY_FILTER;
+	return SUCCEED;
+}
+
+/**
+ * @brief Double buckets of chained hash table, link every hash item again, no hash item is allocated.
+ *
+ * @param pHashInf Which hash information to grow.
+ * @return SUCCEED, or FAILED if no memory.
+ */
+static int GrowHashTable(HashInf *pHashInf)
+{
+	struct list_head *currNode, *nextNode;
+	unsigned int nNewSize = pHashInf->nTableSize * 2;
+	HashTable *pNewTable = InitHashTable(nNewSize);
+
+	if (IS_NULL(pNewTable))
+	{
+		return FAILED;
+	}
+	for (int i=0; i<pHashInf->nTableSize; ++i)
+	{
+		HashItem *pHead = pHashInf->pHashTable[i];
+		if (IS_NOT_NULL(pHead))
+		{
+			list_for_each_safe(currNode, nextNode, &(pHead->node))
+			{
+				LinkHashItem(pNewTable, nNewSize, list_entry(currNode, HashItem, node));
+			}
+			LinkHashItem(pNewTable, nNewSize, pHead);
+		}
+	}
+	FREE(pHashInf->pHashTable);
+	pHashInf->pHashTable = pNewTable;
+	pHashInf->nTableSize = nNewSize;
+
+	// Filter is sized for grown table, removed keys drop out of it.
+	if (pHashInf->flags & HASH_KEY_FILTER)
+	{
+		FillKeyFilter(pHashInf);
+	}
+	return SUCCEED;
+}
+
+/**
+ * @brief Make room for one more item, table grows if it is full enough, no matter which layout it is.
+ *
+ * @param hashInf Which hash information to check.
+ * @return SUCCEED, or FAILED if no memory.
+ */
+static int ReserveOneItem(HashInf *hashInf)
+{
+	if (IS_NOT_NULL(hashInf->pSlots))
+	{
+		if ((unsigned long long)(hashInf->nItemNum + 1) * 100
+				> (unsigned long long)OPEN_HASH_MAX_LOAD_PERCENT << hashInf->nSlotBits)
+		{
+			HashSlot *pNewSlots = ResizeSlotTable(hashInf->pSlots, hashInf->nSlotBits, hashInf->nSlotBits + 1);
+			if (IS_NULL(pNewSlots))
+			{
+				return FAILED;
+			}
+			hashInf->pSlots = pNewSlots;
+			++hashInf->nSlotBits;
+			hashInf->nTableSize = 1 << hashInf->nSlotBits;
+
+			// Filter is sized for grown table, removed keys drop out of it.
+			if (hashInf->flags & HASH_KEY_FILTER)
+			{
+				FillKeyFilter(hashInf);
+			}
+		}
+	}
+	else if (hashInf->nItemNum + 1 > hashInf->nTableSize * MAX_ITEMS_PER_BUCKET)
+	{
+		return GrowHashTable(hashInf);
+	}
+	return SUCCEED;
+}
+
+/**
+ * @brief Create empty hash information with selected layout.
+ *
+ * @param itemNum Number of items will be added.
+ * @param HashMethod Which hash method will be used to create hash table, or NULL if HashMethodLen given.
+ * @param HashMethodLen Length version of hash method, or NULL if HashMethod given.
+ * @param flags One of HASH_LAYOUT_*, may be or-ed with HASH_INTERN_KEYS and HASH_KEY_FILTER.
+ * @return Pointer to created hash information, or NULL if no memory.
+ */
+static HashInf *CreateHashInf(int itemNum, unsigned int (*HashMethod)(const char *),
+		                      unsigned int (*HashMethodLen)(const void *, size_t), unsigned int flags)
+{
+	HashInf *hashInf = (HashInf *)malloc(sizeof(HashInf));
+	if (IS_NULL(hashInf))
+	{
+		return NULL;
+	}
+	SelectMethods(hashInf, HashMethod, HashMethodLen);
+	hashInf->flags = flags;
+	hashInf->pHashTable = NULL;
+	hashInf->pSlots = NULL;
+	hashInf->nSlotBits = 0;
+	hashInf->nItemNum = 0;
+	hashInf->pMappedSlots = NULL;
+	hashInf->pBlob = NULL;
+	hashInf->nBlobSize = 0;
+	hashInf->pMapping = NULL;
+	hashInf->nMappingSize = 0;
+	StringPoolInit(&(hashInf->keyPool));
+	KeyFilterInit(&(hashInf->keyFilter));
+#ifdef HASH_STATS
+	hashInf->statsSlots = CreateHashStatsSlots();
+#endif
+	itemNum = MAX(itemNum, MIN_HASH_TABLE_SIZE);
+
+	if (HASH_LAYOUT_OPEN_ADDRESSING == (flags & HASH_LAYOUT_MASK))
+	{
+		hashInf->nSlotBits = SlotBitsForItems(itemNum);
+		hashInf->pSlots = InitSlotTable(hashInf->nSlotBits);
+		hashInf->nTableSize = 1 << hashInf->nSlotBits;
+	}
+	else
+	{
+		hashInf->pHashTable = InitHashTable(itemNum);
+		hashInf->nTableSize = itemNum;
+	}
+	SlabInit(&(hashInf->nodeSlab), sizeof(HashItem), itemNum);
+	if (IS_NULL(hashInf->pHashTable) && IS_NULL(hashInf->pSlots))
+	{
+		DeleteHashInf(&hashInf);
+		return NULL;
+	}
+#ifdef HASH_STATS
+	if (IS_NULL(hashInf->statsSlots))
+	{
+		DeleteHashInf(&hashInf);
+		return NULL;
+	}
+#endif
+	if (flags & HASH_KEY_FILTER)
+	{
+		FillKeyFilter(hashInf);
+	}
+	return hashInf;
+}
+
+/**
+ * @brief Add a key to hash table of hash information, no matter which layout it is.
+ *
+ * @param hashInf Which hash information to add.
+ * @param nHash Hash key of key.
+ * @param key Which key want to add.
+ * @param len Length of key.
+ * @param pValue Value of key, only kept with HASH_MAP_VALUES.
+ * @return SUCCEED, or FAILED if no memory or key is too long.
+ */
+static int AddToHashInf(HashInf *hashInf, unsigned int nHash, const void *key, size_t len, void *pValue)
+{
+	// Length is saved in 32 bits, a loaded file is read only.
+	if ((len > 0xFFFFFFFFU) || IS_NOT_NULL(hashInf->pMapping) || (FAILED == ReserveOneItem(hashInf)))
+	{
+		return FAILED;
+	}
+	if (hashInf->flags & HASH_INTERN_KEYS)
+	{
+		key = StringPoolAdd(&(hashInf->keyPool), key, len);
+		if (IS_NULL(key))
+		{
+			return FAILED;
+		}
+	}
+	if (IS_NOT_NULL(hashInf->pSlots))
+	{
+		unsigned int nPos = InsertSlot(hashInf->pSlots, hashInf->nSlotBits, nHash, key, len);
+		SetSlotValue(&(hashInf->pSlots[nPos]), pValue);
+	}
+	else if (FAILED == InsertHash(hashInf->pHashTable, hashInf->nTableSize, &(hashInf->nodeSlab),
+			nHash, key, len, pValue))
+	{
+		return FAILED;
+	}
+	KeyFilterAdd(&(hashInf->keyFilter), nHash);
+	++hashInf->nItemNum;
+	return SUCCEED;
+}
+
+/**
+ * @brief Create hash information from a array.
+ *
+ * @param itemNum Number of items in array.
+ * @param pArray Pointer pointed to array which will create hash information.
+ * @param HashMethod Which hash method will be used to create hash table, method listed in HashMethod.h.
+ * @see HashMethod.h
+ * @return Pointer to created hash information, or NULL if no memory.
+ */
+HashInf *HashFromArray(int itemNum, char **pArray,
+		               unsigned int (*HashMethod)(const char *))
+{
+	return HashFromArrayEx(itemNum, pArray, HashMethod, HASH_LAYOUT_CHAINED);
+}
+
+/**
+ * @brief Create hash information from a array, with a selected table layout.
+ *
+ * @param itemNum Number of items in array.
+ * @param pArray Pointer pointed to array which will create hash information.
+ * @param HashMethod Which hash method will be used to create hash table, method listed in HashMethod.h.
+ * @param flags One of HASH_LAYOUT_*, may be or-ed with HASH_INTERN_KEYS and HASH_KEY_FILTER.
+ * @see HashMethod.h
+ * @return Pointer to created hash information, or NULL if no memory.
+ */
+HashInf *HashFromArrayEx(int itemNum, char **pArray,
+		                 unsigned int (*HashMethod)(const char *), unsigned int flags)
+{
+	HashInf *hashInf = CreateHashInf(itemNum, HashMethod, NULL, flags);
+
+	// Add each string to hash table.
+	for (int i=0; IS_NOT_NULL(hashInf) && (i<itemNum); ++i)
+	{
+		size_t len = strlen(pArray[i]);
+		if (FAILED == AddToHashInf(hashInf, HashOfString(hashInf, pArray[i], len), pArray[i], len, NULL))
+		{
+			DeleteHashInf(&hashInf);
+		}
+	}
+	return hashInf;
+}
+
+/**
+ * @brief Create hash information from keys with known length, keys need no terminating '\0'.
+ *
+ * @param itemNum Number of keys.
+ * @param pKeys Address of each key, saved in hash table as it is, not copied.
+ * @param pLens Length of each key.
+ * @param HashMethodLen Which length hash method will be used, method listed in HashMethod.h.
+ * @param flags One of HASH_LAYOUT_*, may be or-ed with HASH_INTERN_KEYS and HASH_KEY_FILTER.
+ * @see HashMethod.h
+ * @return Pointer to created hash information, or NULL if no memory.
+ */
+HashInf *HashFromKeys(int itemNum, const void **pKeys, const size_t *pLens,
+		              unsigned int (*HashMethodLen)(const void *, size_t), unsigned int flags)
+{
+	HashInf *hashInf = CreateHashInf(itemNum, NULL, HashMethodLen, flags);
+
+	// Add each key to hash table.
+	for (int i=0; IS_NOT_NULL(hashInf) && (i<itemNum); ++i)
+	{
+		if (FAILED == AddToHashInf(hashInf, (*HashMethodLen)(pKeys[i], pLens[i]), pKeys[i], pLens[i], NULL))
+		{
+			DeleteHashInf(&hashInf);
+		}
+	}
+	return hashInf;
+}
+
+/**
+ * @brief Get which bucket range of parallel build a hash key belongs to.
+ *
+ * @param pShared Shared data of parallel build.
+ * @param nHash Hash key.
+ * @return Index of bucket range.
+ */
+static inline unsigned int BucketRange(const BuildShared *pShared, unsigned int nHash)
+{
+	unsigned int nTableSize = pShared->hashInf->nTableSize;
+	return (unsigned int)((unsigned long long)(nHash % nTableSize) * pShared->nThreads / nTableSize);
+}
+
+/**
+ * @brief Thread function of HashFromArrayParallel(), run current phase for one thread.
+ *
+ * @param pArg Pointer to BuildTask of this thread.
+ * @return Always NULL.
+ */
+static void *BuildWorker(void *pArg)
+{
+	BuildTask *pTask = (BuildTask *)pArg;
+	BuildShared *pShared = pTask->pShared;
+	HashInf *hashInf = pShared->hashInf;
+	unsigned int *pCount = NULL;
+	int nStart = (int)((long long)pShared->itemNum * pTask->nThread / pShared->nThreads);
+	int nEnd = (int)((long long)pShared->itemNum * (pTask->nThread + 1) / pShared->nThreads);
+
+	if (IS_NOT_NULL(pShared->pCount))
+	{
+		pCount = pShared->pCount + pTask->nThread * pShared->nThreads;
+	}
+
+	switch (pShared->nPhase)
+	{
+	case FIRST:
+		for (int i=nStart; i<nEnd; ++i)
+		{
+			size_t len = strlen(pShared->pArray[i]);
+			unsigned int nHash = HashOfString(hashInf, pShared->pArray[i], len);
+			if (IS_NOT_NULL(hashInf->pSlots))
+			{
+				InsertSlotAtomic(hashInf->pSlots, hashInf->nSlotBits, nHash, pShared->pArray[i], len);
+			}
+			else
+			{
+				HashItem *pHashItem = &(pShared->pItems[i]);
+				pHashItem->item = pShared->pArray[i];
+				pHashItem->HashKey = nHash;
+				pHashItem->nKeyLen = (unsigned int)len;
+				SetItemValue(pHashItem, NULL);
+				++pCount[BucketRange(pShared, nHash)];
+			}
+		}
+		break;
+	case SECOND:
+		for (int i=nStart; i<nEnd; ++i)
+		{
+			pShared->pOrder[pCount[BucketRange(pShared, pShared->pItems[i].HashKey)]++] = i;
+		}
+		break;
+	case THIRD:
+		for (unsigned int j=pShared->pRangeStart[pTask->nThread]; j<pShared->pRangeStart[pTask->nThread+1]; ++j)
+		{
+			LinkHashItem(hashInf->pHashTable, hashInf->nTableSize, &(pShared->pItems[pShared->pOrder[j]]));
+		}
+		break;
+	}
+	return NULL;
+}
+
+/**
+ * @brief Run current phase of parallel build on all threads, wait until all finish.
+ *
+ * @param pShared Shared data of parallel build, nPhase set.
+ * @param tasks One task for each thread.
+ * @return SUCCEED, or FAILED if threads can not be created.
+ */
+static int RunBuildPhase(BuildShared *pShared, BuildTask *tasks)
+{
+	pthread_t threads[pShared->nThreads];
+	int nCreated = 0;
+
+	for (int i=0; i<pShared->nThreads; ++i)
+	{
+		if (SUCCEED != pthread_create(&threads[i], NULL, BuildWorker, &tasks[i]))
+		{
+			break;
+		}
+		++nCreated;
+	}
+	for (int i=0; i<nCreated; ++i)
+	{
+		pthread_join(threads[i], NULL);
+	}
+	return (nCreated == pShared->nThreads) ? SUCCEED : FAILED;
+}
+
+/**
+ * @brief Run all phases of parallel build for chained layout.
+ *
+ * @param pShared Shared data of parallel build.
+ * @param tasks One task for each thread.
+ * @return SUCCEED, or FAILED if no memory or threads can not be created.
+ */
+static int BuildChainedParallel(BuildShared *pShared, BuildTask *tasks)
+{
+	int nThreads = pShared->nThreads;
+	int ret = FAILED;
+
+	pShared->pOrder = MALLOC(unsigned int, pShared->itemNum + 1);
+	pShared->pCount = (unsigned int *)calloc(nThreads * nThreads, sizeof(unsigned int));
+	pShared->pRangeStart = MALLOC(unsigned int, nThreads + 1);
+	pShared->pItems = (HashItem *)SlabAllocArray(&(pShared->hashInf->nodeSlab), pShared->itemNum + 1);
+
+	START_TRACK_EXCEPTION
+	if (IS_NULL(pShared->pOrder) || IS_NULL(pShared->pCount)
+			|| IS_NULL(pShared->pRangeStart) || IS_NULL(pShared->pItems))
+	{
+		THROW_EXCEPTION
+	}
+
+	pShared->nPhase = FIRST;
+	if (FAILED == RunBuildPhase(pShared, tasks))
+	{
+		THROW_EXCEPTION
+	}
+
+	// Turn counts into write offsets, range by range, thread by thread inside each range.
+	unsigned int nOffset = 0;
+	for (int nRange=0; nRange<nThreads; ++nRange)
+	{
+		pShared->pRangeStart[nRange] = nOffset;
+		for (int nThread=0; nThread<nThreads; ++nThread)
+		{
+			unsigned int nCount = pShared->pCount[nThread * nThreads + nRange];
+			pShared->pCount[nThread * nThreads + nRange] = nOffset;
+			nOffset += nCount;
+		}
+	}
+	pShared->pRangeStart[nThreads] = nOffset;
+
+	pShared->nPhase = SECOND;
+	if (FAILED == RunBuildPhase(pShared, tasks))
+	{
+		THROW_EXCEPTION
+	}
+	pShared->nPhase = THIRD;
+	ret = RunBuildPhase(pShared, tasks);
+	END_TRACK_EXCEPTION
+
+	SECURE_FREE(pShared->pOrder);
+	SECURE_FREE(pShared->pCount);
+	SECURE_FREE(pShared->pRangeStart);
+	return ret;
+}
+
+/**
+ * @brief Create hash information from a array, strings are hashed and inserted by many threads.
+ *
+ * @param itemNum Number of items in array.
+ * @param pArray Pointer pointed to array which will create hash information.
+ * @param HashMethod Which hash method will be used to create hash table, method listed in HashMethod.h.
+ * @param flags One of HASH_LAYOUT_*, may be or-ed with HASH_INTERN_KEYS and HASH_KEY_FILTER.
+ * @param nThreads Number of threads, 0 to use one for each online CPU, at most 4 for each online CPU.
+ * @return Pointer to created hash information, or NULL if no memory or threads can not be created.
+ */
+HashInf *HashFromArrayParallel(int itemNum, char **pArray,
+		                       unsigned int (*HashMethod)(const char *), unsigned int flags, int nThreads)
+{
+	BuildShared shared;
+	int ret;
+
+	// More threads than CPUs only wait, tasks and threads are on stack.
+	int nCpus = MAX((int)sysconf(_SC_NPROCESSORS_ONLN), 1);
+	nThreads = (nThreads <= 0) ? nCpus : MIN(nThreads, nCpus * MAX_BUILD_THREADS_PER_CPU);
+	BuildTask tasks[nThreads];
+
+	// Threads keep addresses of array, keys are copied and filtered together after they finish.
+	shared.hashInf = CreateHashInf(itemNum, HashMethod, NULL, flags & ~(HASH_INTERN_KEYS | HASH_KEY_FILTER));
+	if (IS_NULL(shared.hashInf))
+	{
+		return NULL;
+	}
+	shared.pArray = pArray;
+	shared.itemNum = itemNum;
+	shared.nThreads = nThreads;
+	shared.pOrder = NULL;
+	shared.pCount = NULL;
+	shared.pRangeStart = NULL;
+	shared.pItems = NULL;
+	for (int i=0; i<nThreads; ++i)
+	{
+		tasks[i].pShared = &shared;
+		tasks[i].nThread = i;
+	}
+
+	if (IS_NOT_NULL(shared.hashInf->pSlots))
+	{
+		shared.nPhase = FIRST;
+		ret = RunBuildPhase(&shared, tasks);
+	}
+	else
+	{
+		ret = BuildChainedParallel(&shared, tasks);
+	}
+
+	shared.hashInf->nItemNum = itemNum;
+	if ((SUCCEED == ret) && (flags & HASH_INTERN_KEYS))
+	{
+		ret = InternKeys(shared.hashInf);
+	}
+	if ((SUCCEED == ret) && (flags & HASH_KEY_FILTER))
+	{
+		ret = BuildKeyFilter(shared.hashInf);
+	}
+	if (FAILED == ret)
+	{
+		DeleteHashInf(&(shared.hashInf));
+		return NULL;
+	}
+	return shared.hashInf;
+}
+
+/**
+ * @brief Create hash information from list.
+ *
+ * @param itemNum Number of items in array.
+ * @param list Pointer pointed to list which will create hash information.
+ * @param GetNextStr Method of how to get string from list.
+ * @param HashMethod Which hash method will be used to create hash table, method listed in HashMethod.h.
+ * @see HashMethod.h
+ * @return Pointer to created hash information, or NULL if no memory.
+ */
+HashInf *HashFromList(int itemNum, void *list,
+		              char *(GetNextStr)(void **),
+		              unsigned int (*HashMethod)(const char *))
+{
+	return HashFromListEx(itemNum, list, GetNextStr, HashMethod, HASH_LAYOUT_CHAINED);
+}
+
+/**
+ * @brief Create hash information from list, with a selected table layout.
+ *
+ * @param itemNum Number of items in array.
+ * @param list Pointer pointed to list which will create hash information.
+ * @param GetNextStr Method of how to get string from list.
+ * @param HashMethod Which hash method will be used to create hash table, method listed in HashMethod.h.
+ * @param flags One of HASH_LAYOUT_*, may be or-ed with HASH_INTERN_KEYS and HASH_KEY_FILTER.
+ * @see HashMethod.h
+ * @return Pointer to created hash information, or NULL if no memory.
+ */
+HashInf *HashFromListEx(int itemNum, void *list,
+		                char *(GetNextStr)(void **),
+		                unsigned int (*HashMethod)(const char *), unsigned int flags)
+{
+	char *str = NULL;
+	HashInf *hashInf = CreateHashInf(itemNum, HashMethod, NULL, flags);
+
+	// Get every string in list and add them to hash table.
+	while(IS_NOT_NULL(hashInf) && (NULL != (str = (*GetNextStr)(&list))))
+	{
+		size_t len = strlen(str);
+		if (FAILED == AddToHashInf(hashInf, HashOfString(hashInf, str, len), str, len, NULL))
+		{
+			DeleteHashInf(&hashInf);
+		}
+	}
+
+	return hashInf;
+}
+
+/**
+ * @brief Delete created hash information.
+ *
+ * @param pHashInf Pointer to which hash information you want to delete.
+ */
+void DeleteHashInf(HashInf **pHashInf)
+{
+	if (IS_NOT_FREED(*pHashInf))
+	{
+		// All hash items are in slab blocks, no need to walk each list.
+		SlabDestroy(&((*pHashInf)->nodeSlab));
+		StringPoolDestroy(&((*pHashInf)->keyPool));
+		KeyFilterDestroy(&((*pHashInf)->keyFilter));
+		SECURE_FREE((*pHashInf)->pHashTable);
+		SECURE_FREE((*pHashInf)->pSlots);
+		if (IS_NOT_NULL((*pHashInf)->pMapping))
+		{
+			munmap((*pHashInf)->pMapping, (*pHashInf)->nMappingSize);
+		}
+#ifdef HASH_STATS
+		SECURE_FREE((*pHashInf)->statsSlots);
+#endif
+		FREE(*pHashInf);
+	}
+}
+
+/**
+ * @brief Get real string address, the string must be in array or list which created hash information.
+ *
+ * @param pHashInf Pointer to which hash information you want to delete.
+ * @param str Which string you want to find.
+ * @return Real string address you want to search.
+ */
+void *GetStringAddress(HashInf *pHashInf, const char *str)
+{
+	return (*(pHashInf->Lookup))(pHashInf, str);
+}
+
+/**
+ * @brief Get real key address, key has known length and needs no terminating '\0'.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param key Which key you want to find.
+ * @param len Length of key.
+ * @return Real key address, or NULL if not found or hash method has no length version.
+ */
+void *GetKeyAddress(HashInf *pHashInf, const void *key, size_t len)
+{
+	return (*(pHashInf->LookupKey))(pHashInf, key, len);
+}
+
+/**
+ * @brief Get real string address of many strings at once.
+ *
+ *   Strings are handled in groups of BATCH_GROUP_SIZE. All of a group are hashed and their buckets are
+ * prefetched, then what each bucket points to (head item or slot string) is prefetched, at last each
+ * string is searched, so cache misses of the group overlap.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param keys Strings you want to find.
+ * @param n Number of strings.
+ * @param out Save real string address of each string, NULL if not found.
+ */
+void GetStringAddressBatch(HashInf *pHashInf, const char **keys, size_t n, void **out)
+{
+	unsigned int nHash[BATCH_GROUP_SIZE], nPos[BATCH_GROUP_SIZE];
+	size_t nLen[BATCH_GROUP_SIZE];
+	bool_t bMayContain[BATCH_GROUP_SIZE];
+	bool_t bOpenAddressing = IS_NOT_NULL(pHashInf->pSlots);
+
+	// Loaded file has neither layout in memory, search one by one.
+	if (IS_NOT_NULL(pHashInf->pMapping))
+	{
+		for (size_t i=0; i<n; ++i)
+		{
+			out[i] = (*(pHashInf->Lookup))(pHashInf, keys[i]);
+		}
+		return;
+	}
+
+	for (size_t nStart=0; nStart<n; nStart+=BATCH_GROUP_SIZE)
+	{
+		size_t nGroup = MIN(n - nStart, (size_t)BATCH_GROUP_SIZE);
+
+		// Hash whole group, ask for each bucket or start slot of keys passing filter.
+		for (size_t i=0; i<nGroup; ++i)
+		{
+			nLen[i] = strlen(keys[nStart+i]);
+			nHash[i] = HashOfString(pHashInf, keys[nStart+i], nLen[i]);
+			bMayContain[i] = KeyFilterMayContain(&(pHashInf->keyFilter), nHash[i]);
+			if (NO == bMayContain[i])
+			{
+				continue;
+			}
+			if (bOpenAddressing)
+			{
+				nPos[i] = SlotIndex(nHash[i], pHashInf->nSlotBits);
+				PREFETCH(&(pHashInf->pSlots[nPos[i]]));
+			}
+			else
+			{
+				nPos[i] = nHash[i] % pHashInf->nTableSize;
+				PREFETCH(&(pHashInf->pHashTable[nPos[i]]));
+			}
+		}
+
+		// Ask for what buckets point to, the head item or the string in start slot.
+		for (size_t i=0; i<nGroup; ++i)
+		{
+			if (NO == bMayContain[i])
+			{
+				continue;
+			}
+			if (bOpenAddressing)
+			{
+				if (IS_NOT_NULL(pHashInf->pSlots[nPos[i]].item))
+				{
+					PREFETCH(pHashInf->pSlots[nPos[i]].item);
+				}
+			}
+			else if (IS_NOT_NULL(pHashInf->pHashTable[nPos[i]]))
+			{
+				PREFETCH(pHashInf->pHashTable[nPos[i]]);
+			}
+		}
+
+		// Search each string.
+		for (size_t i=0; i<nGroup; ++i)
+		{
+			if (NO == bMayContain[i])
+			{
+				CountFilterReject(HASH_STATS_OF(pHashInf));
+				out[nStart+i] = NULL;
+			}
+			else if (bOpenAddressing)
+			{
+				HashSlot *pSlot = FindSlot(pHashInf->pSlots, pHashInf->nSlotBits, nHash[i], keys[nStart+i], nLen[i],
+						HASH_STATS_OF(pHashInf));
+				out[nStart+i] = IS_NOT_NULL(pSlot) ? pSlot->item : NULL;
+			}
+			else
+			{
+				HashItem *pHashItem = FindHashItem(pHashInf, nHash[i], keys[nStart+i], nLen[i]);
+				out[nStart+i] = IS_NOT_NULL(pHashItem) ? pHashItem->item : NULL;
+			}
+		}
+	}
+}
+
+/**
+ * @brief Remove a key with known hash key from created hash information.
+ *
+ * @param pHashInf Which hash information to remove from.
+ * @param nHash Hash key of key.
+ * @param key Which key want to remove.
+ * @param len Length of key.
+ * @return SUCCEED, or FAILED if key is not in hash table.
+ */
+static int RemoveHashed(HashInf *pHashInf, unsigned int nHash, const void *key, size_t len)
+{
+	if (IS_NOT_NULL(pHashInf->pMapping))
+	{
+		return FAILED;
+	}
+	if (IS_NOT_NULL(pHashInf->pSlots))
+	{
+		HashSlot *pSlot = FindSlot(pHashInf->pSlots, pHashInf->nSlotBits, nHash, key, len, HASH_STATS_OF(pHashInf));
+		if (IS_NULL(pSlot))
+		{
+			return FAILED;
+		}
+		RemoveSlot(pHashInf->pSlots, pHashInf->nSlotBits, pSlot);
+	}
+	else
+	{
+		HashItem *pHashItem = FindHashItem(pHashInf, nHash, key, len);
+		if (IS_NULL(pHashItem))
+		{
+			return FAILED;
+		}
+		UnlinkHashItem(pHashInf->pHashTable, pHashInf->nTableSize, pHashItem);
+		SlabFree(&(pHashInf->nodeSlab), pHashItem);
+	}
+	--pHashInf->nItemNum;
+	return SUCCEED;
+}
+
+/**
+ * @brief Insert a key with known hash key into created hash information, or replace same key already in it.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param nHash Hash key of key.
+ * @param key Which key want to insert.
+ * @param len Length of key.
+ * @param pValue Value of key, only kept with HASH_MAP_VALUES.
+ * @return SUCCEED, or FAILED if no memory or key is too long.
+ */
+static int UpsertHashed(HashInf *pHashInf, unsigned int nHash, const void *key, size_t len, void *pValue)
+{
+	if (IS_NOT_NULL(pHashInf->pMapping))
+	{
+		return FAILED;
+	}
+	if (IS_NOT_NULL(pHashInf->pSlots))
+	{
+		HashSlot *pSlot = FindSlot(pHashInf->pSlots, pHashInf->nSlotBits, nHash, key, len, HASH_STATS_OF(pHashInf));
+		if (IS_NOT_NULL(pSlot))
+		{
+			// Copy in key pool already holds the same key.
+			if (!(pHashInf->flags & HASH_INTERN_KEYS))
+			{
+				pSlot->item = (void *)key;
+			}
+			SetSlotValue(pSlot, pValue);
+			return SUCCEED;
+		}
+	}
+	else
+	{
+		HashItem *pHashItem = FindHashItem(pHashInf, nHash, key, len);
+		if (IS_NOT_NULL(pHashItem))
+		{
+			if (!(pHashInf->flags & HASH_INTERN_KEYS))
+			{
+				pHashItem->item = (void *)key;
+			}
+			SetItemValue(pHashItem, pValue);
+			return SUCCEED;
+		}
+	}
+	return AddToHashInf(pHashInf, nHash, key, len, pValue);
+}
+
+/**
+ * @brief Whether hash information can keep values, built with HASH_MAP_VALUES and not loaded from a file.
+ *
+ * @param pHashInf Which hash information to check.
+ * @return YES if values can be set and got.
+ */
+static inline bool_t CanMapValues(const HashInf *pHashInf)
+{
+#ifdef HASH_MAP_VALUES
+	return IS_NULL(pHashInf->pMapping) ? YES : NO;
+#else
+	(void)pHashInf;
+	return NO;
+#endif
+}
+
+/**
+ * @brief Get value of a key from it's hash key, no matter which layout it is.
+ *
+ * @param pHashInf Which hash information to search, not loaded from a file.
+ * @param nHash Hash key of key.
+ * @param key Which key you want to find.
+ * @param len Length of key.
+ * @return Value of key, or NULL if not found.
+ */
+static void *FindValue(HashInf *pHashInf, unsigned int nHash, const void *key, size_t len)
+{
+	if (IsFilteredOut(pHashInf, nHash))
+	{
+		return NULL;
+	}
+	if (IS_NOT_NULL(pHashInf->pSlots))
+	{
+		HashSlot *pSlot = FindSlot(pHashInf->pSlots, pHashInf->nSlotBits, nHash, key, len, HASH_STATS_OF(pHashInf));
+		return IS_NOT_NULL(pSlot) ? SlotValue(pSlot) : NULL;
+	}
+
+	HashItem *pHashItem = FindHashItem(pHashInf, nHash, key, len);
+	return IS_NOT_NULL(pHashItem) ? ItemValue(pHashItem) : NULL;
+}
+
+/**
+ * @brief Insert a string into created hash information, hash table grows if needed.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param str Which string want to insert, it is not checked whether already in hash table.
+ * @return SUCCEED, or FAILED if no memory.
+ */
+int InsertString(HashInf *pHashInf, const char *str)
+{
+	size_t len = strlen(str);
+	return AddToHashInf(pHashInf, HashOfString(pHashInf, str, len), str, len, NULL);
+}
+
+/**
+ * @brief Remove a string from created hash information.
+ *
+ * @param pHashInf Which hash information to remove from.
+ * @param str Which string want to remove.
+ * @return SUCCEED, or FAILED if string is not in hash table.
+ */
+int RemoveString(HashInf *pHashInf, const char *str)
+{
+	size_t len = strlen(str);
+	return RemoveHashed(pHashInf, HashOfString(pHashInf, str, len), str, len);
+}
+
+/**
+ * @brief Insert a string into created hash information, or replace same string already in it.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param str Which string want to insert, GetStringAddress() returns this address afterwards.
+ * @return SUCCEED, or FAILED if no memory.
+ */
+int UpsertString(HashInf *pHashInf, const char *str)
+{
+	size_t len = strlen(str);
+	return UpsertHashed(pHashInf, HashOfString(pHashInf, str, len), str, len, NULL);
+}
+
+/**
+ * @brief Insert a key with known length into created hash information, hash table grows if needed.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param key Which key want to insert, it is not copied or checked whether already in hash table.
+ * @param len Length of key.
+ * @return SUCCEED, or FAILED if no memory, key is 4G or longer, or hash method has no length version.
+ */
+int InsertKey(HashInf *pHashInf, const void *key, size_t len)
+{
+	if (IS_NULL(pHashInf->HashMethodLen))
+	{
+		return FAILED;
+	}
+	return AddToHashInf(pHashInf, (*(pHashInf->HashMethodLen))(key, len), key, len, NULL);
+}
+
+/**
+ * @brief Remove a key with known length from created hash information.
+ *
+ * @param pHashInf Which hash information to remove from.
+ * @param key Which key want to remove.
+ * @param len Length of key.
+ * @return SUCCEED, or FAILED if key is not in hash table.
+ */
+int RemoveKey(HashInf *pHashInf, const void *key, size_t len)
+{
+	if (IS_NULL(pHashInf->HashMethodLen))
+	{
+		return FAILED;
+	}
+	return RemoveHashed(pHashInf, (*(pHashInf->HashMethodLen))(key, len), key, len);
+}
+
+/**
+ * @brief Insert a key with known length into created hash information, or replace same key already in it.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param key Which key want to insert, GetKeyAddress() returns this address afterwards.
+ * @param len Length of key.
+ * @return SUCCEED, or FAILED if no memory, key is 4G or longer, or hash method has no length version.
+ */
+int UpsertKey(HashInf *pHashInf, const void *key, size_t len)
+{
+	if (IS_NULL(pHashInf->HashMethodLen))
+	{
+		return FAILED;
+	}
+	return UpsertHashed(pHashInf, (*(pHashInf->HashMethodLen))(key, len), key, len, NULL);
+}
+
+/**
+ * @brief Insert a string with a value into created hash information, hash table grows if needed.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param str Which string want to insert, it is not checked whether already in hash table.
+ * @param pValue Value of string, GetStringValue() returns it.
+ * @return SUCCEED, or FAILED if no memory or built without HASH_MAP_VALUES.
+ */
+int InsertStringValue(HashInf *pHashInf, const char *str, void *pValue)
+{
+	size_t len = strlen(str);
+
+	if (NO == CanMapValues(pHashInf))
+	{
+		return FAILED;
+	}
+	return AddToHashInf(pHashInf, HashOfString(pHashInf, str, len), str, len, pValue);
+}
+
+/**
+ * @brief Insert a string with a value into created hash information, or replace value of same string.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param str Which string want to insert.
+ * @param pValue Value of string, GetStringValue() returns it.
+ * @return SUCCEED, or FAILED if no memory or built without HASH_MAP_VALUES.
+ */
+int UpsertStringValue(HashInf *pHashInf, const char *str, void *pValue)
+{
+	size_t len = strlen(str);
+
+	if (NO == CanMapValues(pHashInf))
+	{
+		return FAILED;
+	}
+	return UpsertHashed(pHashInf, HashOfString(pHashInf, str, len), str, len, pValue);
+}
+
+/**
+ * @brief Insert a key with known length and a value into created hash information.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param key Which key want to insert, it is not copied or checked whether already in hash table.
+ * @param len Length of key.
+ * @param pValue Value of key, GetKeyValue() returns it.
+ * @return SUCCEED, or FAILED if no memory, key is 4G or longer, hash method has no length version or built
+ *         without HASH_MAP_VALUES.
+ */
+int InsertKeyValue(HashInf *pHashInf, const void *key, size_t len, void *pValue)
+{
+	if (IS_NULL(pHashInf->HashMethodLen) || (NO == CanMapValues(pHashInf)))
+	{
+		return FAILED;
+	}
+	return AddToHashInf(pHashInf, (*(pHashInf->HashMethodLen))(key, len), key, len, pValue);
+}
+
+/**
+ * @brief Insert a key with known length and a value into created hash information, or replace value of
+ * same key.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param key Which key want to insert.
+ * @param len Length of key.
+ * @param pValue Value of key, GetKeyValue() returns it.
+ * @return SUCCEED, or FAILED if no memory, key is 4G or longer, hash method has no length version or built
+ *         without HASH_MAP_VALUES.
+ */
+int UpsertKeyValue(HashInf *pHashInf, const void *key, size_t len, void *pValue)
+{
+	if (IS_NULL(pHashInf->HashMethodLen) || (NO == CanMapValues(pHashInf)))
+	{
+		return FAILED;
+	}
+	return UpsertHashed(pHashInf, (*(pHashInf->HashMethodLen))(key, len), key, len, pValue);
+}
+
+/**
+ * @brief Get value of a string, read from the hash item or slot GetStringAddress() finds.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param str Which string you want to find.
+ * @return Value of string, or NULL if not found, built without HASH_MAP_VALUES or loaded from a file.
+ */
+void *GetStringValue(HashInf *pHashInf, const char *str)
+{
+	size_t len = strlen(str);
+
+	if (NO == CanMapValues(pHashInf))
+	{
+		return NULL;
+	}
+	return FindValue(pHashInf, HashOfString(pHashInf, str, len), str, len);
+}
+
+/**
+ * @brief Get value of a key with known length.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param key Which key you want to find.
+ * @param len Length of key.
+ * @return Value of key, or NULL if not found, hash method has no length version, built without
+ *         HASH_MAP_VALUES or loaded from a file.
+ */
+void *GetKeyValue(HashInf *pHashInf, const void *key, size_t len)
+{
+	if (IS_NULL(pHashInf->HashMethodLen) || (NO == CanMapValues(pHashInf)))
+	{
+		return NULL;
+	}
+	return FindValue(pHashInf, (*(pHashInf->HashMethodLen))(key, len), key, len);
+}
+
+/**
+ * @brief Copy every key into a string pool owned by hash information, keys of later inserts are copied too.
+ *
+ * @param pHashInf Which hash information to intern keys of.
+ * @return SUCCEED, or FAILED if no memory, nothing is changed then.
+ */
+int InternKeys(HashInf *pHashInf)
+{
+	struct list_head *pos;
+	size_t nBytes = 0;
+
+	if (IS_NOT_NULL(pHashInf->pMapping) || (pHashInf->flags & HASH_INTERN_KEYS))
+	{
+		return SUCCEED;
+	}
+
+	// One block for all keys, so they are contiguous.
+	for (int i=0; IS_NOT_NULL(pHashInf->pSlots) && (i<pHashInf->nTableSize); ++i)
+	{
+		if (IS_NOT_NULL(pHashInf->pSlots[i].item))
+		{
+			nBytes += StringPoolEntrySize(pHashInf->pSlots[i].nKeyLen);
+		}
+	}
+	for (int i=0; IS_NOT_NULL(pHashInf->pHashTable) && (i<pHashInf->nTableSize); ++i)
+	{
+		HashItem *pHead = pHashInf->pHashTable[i];
+		if (IS_NOT_NULL(pHead))
+		{
+			nBytes += StringPoolEntrySize(pHead->nKeyLen);
+			list_for_each(pos, &(pHead->node))
+			{
+				HashItem *pHashItem = list_entry(pos, HashItem, node);
+				nBytes += StringPoolEntrySize(pHashItem->nKeyLen);
+			}
+		}
+	}
+	if (FAILED == StringPoolReserve(&(pHashInf->keyPool), nBytes))
+	{
+		return FAILED;
+	}
+
+	for (int i=0; IS_NOT_NULL(pHashInf->pSlots) && (i<pHashInf->nTableSize); ++i)
+	{
+		HashSlot *pSlot = &(pHashInf->pSlots[i]);
+		if (IS_NOT_NULL(pSlot->item))
+		{
+			pSlot->item = StringPoolAdd(&(pHashInf->keyPool), pSlot->item, pSlot->nKeyLen);
+		}
+	}
+	for (int i=0; IS_NOT_NULL(pHashInf->pHashTable) && (i<pHashInf->nTableSize); ++i)
+	{
+		HashItem *pHead = pHashInf->pHashTable[i];
+		if (IS_NOT_NULL(pHead))
+		{
+			pHead->item = StringPoolAdd(&(pHashInf->keyPool), pHead->item, pHead->nKeyLen);
+			list_for_each(pos, &(pHead->node))
+			{
+				HashItem *pHashItem = list_entry(pos, HashItem, node);
+				pHashItem->item = StringPoolAdd(&(pHashInf->keyPool), pHashItem->item, pHashItem->nKeyLen);
+			}
+		}
+	}
+	pHashInf->flags |= HASH_INTERN_KEYS;
+	return SUCCEED;
+}
+
+/**
+ * @brief Build a key filter from hash keys in hash information, checked before each search.
+ *
+ * @param pHashInf Which hash information to build filter of.
+ * @return SUCCEED, or FAILED if no memory, hash information has no filter then.
+ */
+int BuildKeyFilter(HashInf *pHashInf)
+{
+	return FillKeyFilter(pHashInf);
+}
+
+/**
+ * @brief Get search counters of hash information, counted by all threads since it was created or reset.
+ *
+ * @param pHashInf Which hash information to query.
+ * @param pStats Save counters, all zero if built without HASH_STATS.
+ * @return SUCCEED, or FAILED if built without HASH_STATS.
+ */
+int GetHashStats(HashInf *pHashInf, HashStats *pStats)
+{
+#ifdef HASH_STATS
+	SumHashStats(pHashInf->statsSlots, pStats);
+	return SUCCEED;
+#else
+	(void)pHashInf;
+	memset(pStats, 0, sizeof(HashStats));
+	return FAILED;
+#endif
+}
+
+/**
+ * @brief Set search counters of hash information to zero.
+ *
+ * @param pHashInf Which hash information to reset.
+ */
+void ResetHashStats(HashInf *pHashInf)
+{
+#ifdef HASH_STATS
+	memset(pHashInf->statsSlots, 0, sizeof(HashStatsSlot) * HASH_STATS_THREADS);
+#else
+	(void)pHashInf;
+#endif
+}
+
+/**
+ * @brief Count bytes of a key in key blob, or put it into slot table and blob being saved.
+ *
+ * @param pContext Slot table and blob being filled, only blob size grows while pSlots is NULL.
+ * @param nHash Hash key of key.
+ * @param key Key to save.
+ * @param nKeyLen Length of key.
+ */
+static void SaveOneKey(SaveContext *pContext, unsigned int nHash, const void *key, unsigned int nKeyLen)
+{
+	if (IS_NOT_NULL(pContext->pSlots))
+	{
+		unsigned int nMask = (1U << pContext->nSlotBits) - 1;
+		unsigned int nPos = SlotIndex(nHash, pContext->nSlotBits);
+		unsigned int nProbes = 0;
+
+		// Slots are sized by item number, a corrupt loaded file may hold more keys than that.
+		while ((nProbes <= nMask) && (MAPPED_SLOT_EMPTY != pContext->pSlots[nPos].nOffset))
+		{
+			++nProbes;
+			nPos = (nPos + 1) & nMask;
+		}
+		if (nProbes > nMask)
+		{
+			pContext->bFull = YES;
+			return;
+		}
+		pContext->pSlots[nPos].HashKey = nHash;
+		pContext->pSlots[nPos].nKeyLen = nKeyLen;
+		pContext->pSlots[nPos].nOffset = pContext->nBlobSize;
+		memcpy(pContext->pBlob + pContext->nBlobSize, key, nKeyLen);
+		pContext->pBlob[pContext->nBlobSize + nKeyLen] = '\0';
+	}
+	pContext->nBlobSize += nKeyLen + 1;
+}
+
+/**
+ * @brief Pass every key of hash information to SaveOneKey(), no matter which layout it is.
+ *
+ * @param pHashInf Which hash information to walk.
+ * @param pContext Passed to SaveOneKey().
+ */
+static void SaveAllKeys(HashInf *pHashInf, SaveContext *pContext)
+{
+	struct list_head *pos;
+
+	if (IS_NOT_NULL(pHashInf->pMapping))
+	{
+		for (int i=0; i<pHashInf->nTableSize; ++i)
+		{
+			const MappedSlot *pSlot = &(pHashInf->pMappedSlots[i]);
+			// Corrupt slot is not carried into new file.
+			if ((MAPPED_SLOT_EMPTY != pSlot->nOffset) && IS_NOT_NULL(MappedKey(pHashInf, pSlot)))
+			{
+				SaveOneKey(pContext, pSlot->HashKey, MappedKey(pHashInf, pSlot), pSlot->nKeyLen);
+			}
+		}
+	}
+	else if (IS_NOT_NULL(pHashInf->pSlots))
+	{
+		for (int i=0; i<pHashInf->nTableSize; ++i)
+		{
+			const HashSlot *pSlot = &(pHashInf->pSlots[i]);
+			if (IS_NOT_NULL(pSlot->item))
+			{
+				SaveOneKey(pContext, pSlot->HashKey, pSlot->item, pSlot->nKeyLen);
+			}
+		}
+	}
+	else
+	{
+		for (int i=0; i<pHashInf->nTableSize; ++i)
+		{
+			HashItem *pHead = pHashInf->pHashTable[i];
+			if (IS_NULL(pHead))
+			{
+				continue;
+			}
+			SaveOneKey(pContext, pHead->HashKey, pHead->item, pHead->nKeyLen);
+			list_for_each(pos, &(pHead->node))
+			{
+				HashItem *pHashItem = list_entry(pos, HashItem, node);
+				SaveOneKey(pContext, pHashItem->HashKey, pHashItem->item, pHashItem->nKeyLen);
+			}
+		}
+	}
+}
+
+/**
+ * @brief Find index of a hash method in methodLookups.
+ *
+ * @param HashMethodLen Length version of hash method.
+ * @return Index, or -1 if hash method is not in HashMethod.h.
+ */
+static int MethodIndex(unsigned int (*HashMethodLen)(const void *, size_t))
+{
+	for (unsigned int i=0; i<ARRAY_SIZE(methodLookups); ++i)
+	{
+		if (IS_NOT_NULL(HashMethodLen) && (HashMethodLen == methodLookups[i].HashMethodLen))
+		{
+			return (int)i;
+		}
+	}
+	return -1;
+}
+
+/**
+ * @brief Save hash information into a file, LoadHashInf() maps it back.
+ *
+ * @param pHashInf Which hash information to save, built with a hash method in HashMethod.h.
+ * @param path Where to save.
+ * @return SUCCEED, or FAILED if hash method is not in HashMethod.h, no memory or file can not be written.
+ */
+int SaveHashInf(HashInf *pHashInf, const char *path)
+{
+	int nMethod = MethodIndex(pHashInf->HashMethodLen);
+	MappedHeader header;
+	SaveContext context;
+	char *tmpPath;
+	FILE *fp;
+	int ret = FAILED;
+
+	if (-1 == nMethod)
+	{
+		return FAILED;
+	}
+
+	// First pass only sizes the blob.
+	memset(&context, 0, sizeof(context));
+	SaveAllKeys(pHashInf, &context);
+	context.nSlotBits = SlotBitsForItems(MAX(pHashInf->nItemNum, 1));
+	context.pSlots = MALLOC(MappedSlot, 1U << context.nSlotBits);
+	context.pBlob = MALLOC(char, context.nBlobSize + 1);
+	tmpPath = MALLOC(char, strlen(path) + sizeof(".tmp"));
+	if (IS_NULL(context.pSlots) || IS_NULL(context.pBlob) || IS_NULL(tmpPath))
+	{
+		SECURE_FREE(context.pSlots);
+		SECURE_FREE(context.pBlob);
+		SECURE_FREE(tmpPath);
+		return FAILED;
+	}
+	for (unsigned int i=0; i<(1U << context.nSlotBits); ++i)
+	{
+		context.pSlots[i].HashKey = 0;
+		context.pSlots[i].nKeyLen = 0;
+		context.pSlots[i].nOffset = MAPPED_SLOT_EMPTY;
+	}
+	context.nBlobSize = 0;
+	SaveAllKeys(pHashInf, &context);
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, HASH_FILE_MAGIC, sizeof(header.magic));
+	header.nVersion = HASH_FILE_VERSION;
+	header.nMethod = nMethod;
+	header.nMethodCheck = (*(methodLookups[nMethod].HashMethodLen))(HASH_FILE_CHECK_STRING,
+			sizeof(HASH_FILE_CHECK_STRING) - 1);
+	header.nSlotBits = context.nSlotBits;
+	header.nItemNum = pHashInf->nItemNum;
+	header.nBlobSize = context.nBlobSize;
+
+	// Written beside, then renamed over path in one step.
+	sprintf(tmpPath, "%s.tmp", path);
+	if ((NO == context.bFull) && IS_NOT_NULL(fp = fopen(tmpPath, "wb")))
+	{
+		if ((1 == fwrite(&header, sizeof(header), 1, fp))
+				&& ((1U << context.nSlotBits) == fwrite(context.pSlots, sizeof(MappedSlot), 1U << context.nSlotBits, fp))
+				&& (context.nBlobSize == fwrite(context.pBlob, 1, context.nBlobSize, fp))
+				&& (0 == fflush(fp)) && (0 == fsync(fileno(fp))))
+		{
+			ret = SUCCEED;
+		}
+		if ((0 != fclose(fp)) || (SUCCEED != ret) || (0 != rename(tmpPath, path)))
+		{
+			unlink(tmpPath);
+			ret = FAILED;
+		}
+	}
+
+	FREE(context.pSlots);
+	FREE(context.pBlob);
+	FREE(tmpPath);
+	return ret;
+}
+
+/**
+ * @brief Check head of a mapped file.
+ *
+ * @param pHeader Head of file.
+ * @param nFileSize Size of whole file.
+ * @return YES if file is a hash file of this machine and it's size matches.
+ */
+static bool_t IsValidMappedHeader(const MappedHeader *pHeader, size_t nFileSize)
+{
+	if ((0 != memcmp(pHeader->magic, HASH_FILE_MAGIC, sizeof(pHeader->magic)))
+			|| (HASH_FILE_VERSION != pHeader->nVersion)
+			|| (pHeader->nMethod >= ARRAY_SIZE(methodLookups))
+			|| (pHeader->nSlotBits < 1) || (pHeader->nSlotBits > 30)
+			|| (pHeader->nItemNum >= (1ULL << pHeader->nSlotBits)))
+	{
+		return NO;
+	}
+	// Hash method changed since file was saved, keys would be searched in wrong slots.
+	if (pHeader->nMethodCheck != (*(methodLookups[pHeader->nMethod].HashMethodLen))(HASH_FILE_CHECK_STRING,
+			sizeof(HASH_FILE_CHECK_STRING) - 1))
+	{
+		return NO;
+	}
+	return ((pHeader->nBlobSize <= nFileSize)
+			&& (nFileSize == sizeof(MappedHeader) + (sizeof(MappedSlot) << pHeader->nSlotBits) + pHeader->nBlobSize))
+			? YES : NO;
+}
+
+/**
+ * @brief Map a file saved by SaveHashInf() read only, search it where it is, without reading it first.
+ *
+ * @param path File to load.
+ * @return Pointer to loaded hash information, delete it by DeleteHashInf(), or NULL if file can not be
+ *         read or is not a valid hash file of this machine.
+ */
+HashInf *LoadHashInf(const char *path)
+{
+	struct stat fileStat;
+	void *pMapping;
+	int fd = open(path, O_RDONLY);
+
+	if (-1 == fd)
+	{
+		return NULL;
+	}
+	if ((0 != fstat(fd, &fileStat)) || ((size_t)fileStat.st_size < sizeof(MappedHeader)))
+	{
+		close(fd);
+		return NULL;
+	}
+	pMapping = mmap(NULL, fileStat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (MAP_FAILED == pMapping)
+	{
+		return NULL;
+	}
+
+	const MappedHeader *pHeader = (const MappedHeader *)pMapping;
+	HashInf *hashInf = IsValidMappedHeader(pHeader, fileStat.st_size) ? (HashInf *)malloc(sizeof(HashInf)) : NULL;
+	if (IS_NULL(hashInf))
+	{
+		munmap(pMapping, fileStat.st_size);
+		return NULL;
+	}
+	SelectMethods(hashInf, NULL, methodLookups[pHeader->nMethod].HashMethodLen);
+	hashInf->Lookup = GetStringAddressMapped;
+	hashInf->LookupKey = GetKeyAddressMapped;
+	hashInf->flags = HASH_LAYOUT_OPEN_ADDRESSING;
+	StringPoolInit(&(hashInf->keyPool));
+	KeyFilterInit(&(hashInf->keyFilter));
+	hashInf->pHashTable = NULL;
+	hashInf->pSlots = NULL;
+	hashInf->nSlotBits = pHeader->nSlotBits;
+	hashInf->nTableSize = 1 << pHeader->nSlotBits;
+	hashInf->nItemNum = (int)pHeader->nItemNum;
+	hashInf->pMappedSlots = (const MappedSlot *)(pHeader + 1);
+	hashInf->pBlob = (const char *)(hashInf->pMappedSlots + hashInf->nTableSize);
+	hashInf->nBlobSize = (size_t)pHeader->nBlobSize;
+	hashInf->pMapping = pMapping;
+	hashInf->nMappingSize = fileStat.st_size;
+	SlabInit(&(hashInf->nodeSlab), sizeof(HashItem), 0);
+#ifdef HASH_STATS
+	hashInf->statsSlots = CreateHashStatsSlots();
+	if (IS_NULL(hashInf->statsSlots))
+	{
+		DeleteHashInf(&hashInf);
+	}
+#endif
+	return hashInf;
+}
@@ -38,8 +38,54 @@
  */
 
 #include "../CProjectDfn.h"
+#include "../HashStats.h"
+#include "../KeyFilter.h"
+#include "../StringPool.h"
 #include "HashMethod.h"
 #include "list.h"
+#include "OpenHash.h"
+#include "Slab.h"
+
+/**
+ * @brief Layout of hash table, pass to HashFromArrayEx() or HashFromListEx() as flags.
+ */
+#define HASH_LAYOUT_CHAINED          0x00    ///< Bucket heads point to list nodes, see data structure above.
+#define HASH_LAYOUT_OPEN_ADDRESSING  0x01    ///< One flat slot array, see OpenHash.h.
+#define HASH_LAYOUT_MASK             0x01    ///< Bits of flags used by layout.
+
+/**
+ * @brief Or with layout in flags to copy keys into a string pool owned by hash information, see InternKeys().
+ */
+#define HASH_INTERN_KEYS             0x02
+
+/**
+ * @brief Or with layout in flags to check a key filter before hash table, see BuildKeyFilter().
+ */
+#define HASH_KEY_FILTER              0x04
+
+/**
+ * @brief Hash table is never smaller than this.
+ */
+#define MIN_HASH_TABLE_SIZE 16
+
+/**
+ * @brief Chained hash table doubles it's buckets when average list is longer than this.
+ */
+#define MAX_ITEMS_PER_BUCKET 2
+
+/**
+ * @brief Number of strings hashed and prefetched together by GetStringAddressBatch().
+ */
+#define BATCH_GROUP_SIZE 16
+
+/**
+ * @brief Build every file with -DHASH_MAP_VALUES to keep a value in each hash item and slot beside key
+ * address.
+ *
+ *   InsertStringValue() and friends then map a key to any pointer, and GetStringValue() returns it from
+ * the hash item or slot holding the key, no second structure is searched. Hash items and slots are 8
+ * bytes bigger, so it is not built by default. Without it the value functions return FAILED or NULL.
+ */
 
 /**
  * @brief Hash information for each item.
@@ -48,20 +94,91 @@ typedef struct HashItem
 {
 	void *item;              ///< Address of item.
 	unsigned int HashKey;    ///< Hash key.
+	unsigned int nKeyLen;    ///< Length of key item points to, compared before the bytes.
 	struct list_head node;   ///< node pointer, next and previous node address.
+#ifdef HASH_MAP_VALUES
+	void *pValue;            ///< Value of key, see HASH_MAP_VALUES.
+#endif
 }HashItem;
 
 //! Hash table made up by many hash items.
 typedef HashItem* HashTable;
 
+/**
+ * @brief File saved by SaveHashInf(), mapped by LoadHashInf().
+ *
+ * +--------------+-------------------------------------+------------------------------+
+ * | MappedHeader | MappedSlot x 2^nSlotBits            | keys, each followed by '\0'   |
+ * +--------------+-------------------------------------+------------------------------+
+ *
+ *   Slots are an open addressing table like OpenHash.h, a slot holds offset of it's key in key blob
+ * instead of address, so file is used where it is mapped without any change.
+ */
+#define HASH_FILE_MAGIC "NHASHMAP"           ///< First 8 bytes of file.
+#define HASH_FILE_VERSION 1
+#define MAPPED_SLOT_EMPTY (~0ULL)           ///< Offset of an empty slot.
+
+//! Check string hashed when saving, loading checks hash method still gives the same value.
+#define HASH_FILE_CHECK_STRING "NormalHash"
+
+/**
+ * @brief Head of file, all fields in byte order of machine writing it.
+ */
+typedef struct MappedHeader
+{
+	char magic[8];                ///< HASH_FILE_MAGIC.
+	unsigned int nVersion;        ///< HASH_FILE_VERSION.
+	unsigned int nMethod;         ///< Index of hash method in built in methods of Hash.c.
+	unsigned int nMethodCheck;    ///< Hash of HASH_FILE_CHECK_STRING by the hash method.
+	unsigned int nSlotBits;       ///< Number of slots is 2^nSlotBits.
+	unsigned long long nItemNum;  ///< Number of keys.
+	unsigned long long nBlobSize; ///< Bytes of key blob.
+}MappedHeader;
+
+/**
+ * @brief Slot of a mapped table.
+ */
+typedef struct MappedSlot
+{
+	unsigned int HashKey;         ///< Hash key.
+	unsigned int nKeyLen;         ///< Length of key.
+	unsigned long long nOffset;   ///< Offset of key in key blob, MAPPED_SLOT_EMPTY if slot is empty.
+}MappedSlot;
+
+struct HashTableInf;
+
+//! Lookup function of hash table, see GetStringAddress().
+typedef void *(*LookupMethod)(struct HashTableInf *, const char *);
+
+//! Lookup function of hash table for keys with length, see GetKeyAddress().
+typedef void *(*LookupKeyMethod)(struct HashTableInf *, const void *, size_t);
+
 /**
  * @brief Hash information.
  */
 typedef struct HashTableInf
 {
-	unsigned int (*HashMethod)(const char *);   ///< Which hash method used in hash table.
+	unsigned int (*HashMethod)(const char *);   ///< Which hash method used in hash table, NULL if only HashMethodLen known.
+	unsigned int (*HashMethodLen)(const void *, size_t); ///< Length version of HashMethod, NULL if not in HashMethod.h.
+	LookupMethod Lookup;                        ///< Lookup compiled for HashMethod, see GetStringAddressBKDRHash().
+	LookupKeyMethod LookupKey;                  ///< Lookup compiled for HashMethodLen, see GetKeyAddress().
 	int nTableSize;                             ///< Size of hash table.
-	HashTable *pHashTable;                      ///< Pointer pointed to hash table.
+	HashTable *pHashTable;                      ///< Pointer pointed to hash table, chained layout.
+	unsigned int flags;                         ///< Layout and other options of hash table.
+	HashSlot *pSlots;                           ///< Slot table, open addressing layout.
+	unsigned int nSlotBits;                     ///< Number of slots is 2^nSlotBits.
+	Slab nodeSlab;                              ///< Hash items of chained layout are allocated from it.
+	int nItemNum;                               ///< Number of items in hash table.
+	const MappedSlot *pMappedSlots;             ///< Slots of a loaded file, NULL if built in memory.
+	const char *pBlob;                          ///< Keys of a loaded file.
+	size_t nBlobSize;                           ///< Bytes of key blob, a key past it is never read.
+	void *pMapping;                             ///< Whole loaded file, NULL if built in memory.
+	size_t nMappingSize;                        ///< Size of loaded file.
+	StringPool keyPool;                         ///< Copies of keys, used with HASH_INTERN_KEYS.
+	KeyFilter keyFilter;                        ///< Checked before hash table, used with HASH_KEY_FILTER.
+#ifdef HASH_STATS
+	HashStatsSlot *statsSlots;                  ///< Search counters of each thread, see HashStats.h.
+#endif
 }HashInf;
 
 /**
@@ -71,11 +188,24 @@ typedef struct HashTableInf
  * @param pArray Pointer pointed to array which will create hash information.
  * @param HashMethod Which hash method will be used to create hash table, method listed in HashMethod.h.
  * @see HashMethod.h
- * @return Pointer to created hash information.
+ * @return Pointer to created hash information, or NULL if no memory.
  */
 HashInf *HashFromArray(int itemNum, char **pArray,
 		               unsigned int (*HashMethod)(const char *));
 
+/**
+ * @brief Create hash information from a array, with a selected table layout.
+ *
+ * @param itemNum Number of items in array.
+ * @param pArray Pointer pointed to array which will create hash information.
+ * @param HashMethod Which hash method will be used to create hash table, method listed in HashMethod.h.
+ * @param flags One of HASH_LAYOUT_*, may be or-ed with HASH_INTERN_KEYS and HASH_KEY_FILTER.
+ * @see HashMethod.h
+ * @return Pointer to created hash information, or NULL if no memory.
+ */
+HashInf *HashFromArrayEx(int itemNum, char **pArray,
+		                 unsigned int (*HashMethod)(const char *), unsigned int flags);
+
 /**
  * @brief Create hash information from list.
  *
@@ -84,12 +214,59 @@ HashInf *HashFromArray(int itemNum, char **pArray,
  * @param GetNextStr Method of how to get string from list.
  * @param HashMethod Which hash method will be used to create hash table, method listed in HashMethod.h.
  * @see HashMethod.h
- * @return Pointer to created hash information.
+ * @return Pointer to created hash information, or NULL if no memory.
  */
 HashInf *HashFromList(int itemNum, void *list,
 		              char *(GetNextStr)(void **),
 		              unsigned int (*HashMethod)(const char *));
 
+/**
+ * @brief Create hash information from list, with a selected table layout.
+ *
+ * @param itemNum Number of items in array.
+ * @param list Pointer pointed to list which will create hash information.
+ * @param GetNextStr Method of how to get string from list.
+ * @param HashMethod Which hash method will be used to create hash table, method listed in HashMethod.h.
+ * @param flags One of HASH_LAYOUT_*, may be or-ed with HASH_INTERN_KEYS and HASH_KEY_FILTER.
+ * @see HashMethod.h
+ * @return Pointer to created hash information, or NULL if no memory.
+ */
+HashInf *HashFromListEx(int itemNum, void *list,
+		                char *(GetNextStr)(void **),
+		                unsigned int (*HashMethod)(const char *), unsigned int flags);
+
+/**
+ * @brief Create hash information from a array, strings are hashed and inserted by many threads.
+ *
+ *   Chained layout: threads hash their part of array, then hash items are grouped by bucket range and
+ * each thread links one range, so no lock is needed. Open addressing layout: threads claim slots with
+ * compare-and-swap. Link with -lpthread.
+ *
+ * @param itemNum Number of items in array.
+ * @param pArray Pointer pointed to array which will create hash information.
+ * @param HashMethod Which hash method will be used to create hash table, method listed in HashMethod.h.
+ * @param flags One of HASH_LAYOUT_*, may be or-ed with HASH_INTERN_KEYS and HASH_KEY_FILTER.
+ * @param nThreads Number of threads, 0 to use one for each online CPU, at most 4 for each online CPU.
+ * @see HashMethod.h
+ * @return Pointer to created hash information, or NULL if no memory or threads can not be created.
+ */
+HashInf *HashFromArrayParallel(int itemNum, char **pArray,
+		                       unsigned int (*HashMethod)(const char *), unsigned int flags, int nThreads);
+
+/**
+ * @brief Create hash information from keys with known length, keys need no terminating '\0'.
+ *
+ * @param itemNum Number of keys.
+ * @param pKeys Address of each key, saved in hash table as it is, not copied.
+ * @param pLens Length of each key.
+ * @param HashMethodLen Which length hash method will be used, method listed in HashMethod.h.
+ * @param flags One of HASH_LAYOUT_*, may be or-ed with HASH_INTERN_KEYS and HASH_KEY_FILTER.
+ * @see HashMethod.h
+ * @return Pointer to created hash information, or NULL if no memory.
+ */
+HashInf *HashFromKeys(int itemNum, const void **pKeys, const size_t *pLens,
+		              unsigned int (*HashMethodLen)(const void *, size_t), unsigned int flags);
+
 /**
  * @brief Delete created hash information.
  *
@@ -106,4 +283,247 @@ void DeleteHashInf(HashInf **pHashInf);
  */
 void *GetStringAddress(HashInf *pHashInf, const char *str);
 
+/**
+ * @brief Get real string address, lookup compiled for one hash method in HashMethod.h.
+ *
+ *   Hash method and probe loop are compiled together, no call through function pointer. Call the one
+ * of the hash method hash table was created with, GetStringAddress() calls it as well.
+ *
+ * @param pHashInf Pointer to which hash information you want to search.
+ * @param str Which string you want to find.
+ * @return Real string address you want to search.
+ */
+void *GetStringAddressSDBMHash(HashInf *pHashInf, const char *str);
+void *GetStringAddressRSHash(HashInf *pHashInf, const char *str);
+void *GetStringAddressJSHash(HashInf *pHashInf, const char *str);
+void *GetStringAddressPJWHash(HashInf *pHashInf, const char *str);
+void *GetStringAddressELFHash(HashInf *pHashInf, const char *str);
+void *GetStringAddressBKDRHash(HashInf *pHashInf, const char *str);
+void *GetStringAddressDJBHash(HashInf *pHashInf, const char *str);
+void *GetStringAddressAPHash(HashInf *pHashInf, const char *str);
+void *GetStringAddressWordHash(HashInf *pHashInf, const char *str);
+
+/**
+ * @brief Get real key address, key has known length and needs no terminating '\0'.
+ *
+ *   Key is hashed once with it's length, and compared by length then memcmp(), never scanned for '\0'.
+ * Same bytes as a string inserted by InsertString() are found as well.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param key Which key you want to find.
+ * @param len Length of key.
+ * @return Real key address, or NULL if not found or hash method has no length version.
+ */
+void *GetKeyAddress(HashInf *pHashInf, const void *key, size_t len);
+
+/**
+ * @brief Get real string address of many strings at once.
+ *
+ *   Strings are handled in groups of BATCH_GROUP_SIZE, all of a group are hashed and their buckets are
+ * prefetched before any is searched, so cache misses of the group overlap.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param keys Strings you want to find.
+ * @param n Number of strings.
+ * @param out Save real string address of each string, NULL if not found.
+ */
+void GetStringAddressBatch(HashInf *pHashInf, const char **keys, size_t n, void **out);
+
+/**
+ * @brief Insert a string into created hash information, hash table grows if needed.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param str Which string want to insert, it is not checked whether already in hash table.
+ * @return SUCCEED, or FAILED if no memory.
+ */
+int InsertString(HashInf *pHashInf, const char *str);
+
+/**
+ * @brief Remove a string from created hash information.
+ *
+ * @param pHashInf Which hash information to remove from.
+ * @param str Which string want to remove.
+ * @return SUCCEED, or FAILED if string is not in hash table.
+ */
+int RemoveString(HashInf *pHashInf, const char *str);
+
+/**
+ * @brief Insert a string into created hash information, or replace same string already in it.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param str Which string want to insert, GetStringAddress() returns this address afterwards,
+ *            value of the string is set to NULL.
+ * @return SUCCEED, or FAILED if no memory.
+ */
+int UpsertString(HashInf *pHashInf, const char *str);
+
+/**
+ * @brief Insert a key with known length into created hash information, hash table grows if needed.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param key Which key want to insert, it is not copied or checked whether already in hash table.
+ * @param len Length of key.
+ * @return SUCCEED, or FAILED if no memory, key is 4G or longer, or hash method has no length version.
+ */
+int InsertKey(HashInf *pHashInf, const void *key, size_t len);
+
+/**
+ * @brief Remove a key with known length from created hash information.
+ *
+ * @param pHashInf Which hash information to remove from.
+ * @param key Which key want to remove.
+ * @param len Length of key.
+ * @return SUCCEED, or FAILED if key is not in hash table.
+ */
+int RemoveKey(HashInf *pHashInf, const void *key, size_t len);
+
+/**
+ * @brief Insert a key with known length into created hash information, or replace same key already in it.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param key Which key want to insert, GetKeyAddress() returns this address afterwards, value
+ *            of the key is set to NULL.
+ * @param len Length of key.
+ * @return SUCCEED, or FAILED if no memory, key is 4G or longer, or hash method has no length version.
+ */
+int UpsertKey(HashInf *pHashInf, const void *key, size_t len);
+
+/**
+ * @brief Insert a string with a value into created hash information, hash table grows if needed.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param str Which string want to insert, it is not checked whether already in hash table.
+ * @param pValue Value of string, GetStringValue() returns it.
+ * @return SUCCEED, or FAILED if no memory or built without HASH_MAP_VALUES.
+ */
+int InsertStringValue(HashInf *pHashInf, const char *str, void *pValue);
+
+/**
+ * @brief Insert a string with a value into created hash information, or replace value of same string.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param str Which string want to insert.
+ * @param pValue Value of string, GetStringValue() returns it.
+ * @return SUCCEED, or FAILED if no memory or built without HASH_MAP_VALUES.
+ */
+int UpsertStringValue(HashInf *pHashInf, const char *str, void *pValue);
+
+/**
+ * @brief Insert a key with known length and a value into created hash information.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param key Which key want to insert, it is not copied or checked whether already in hash table.
+ * @param len Length of key.
+ * @param pValue Value of key, GetKeyValue() returns it.
+ * @return SUCCEED, or FAILED if no memory, key is 4G or longer, hash method has no length version or built
+ *         without HASH_MAP_VALUES.
+ */
+int InsertKeyValue(HashInf *pHashInf, const void *key, size_t len, void *pValue);
+
+/**
+ * @brief Insert a key with known length and a value into created hash information, or replace value of
+ * same key.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param key Which key want to insert.
+ * @param len Length of key.
+ * @param pValue Value of key, GetKeyValue() returns it.
+ * @return SUCCEED, or FAILED if no memory, key is 4G or longer, hash method has no length version or built
+ *         without HASH_MAP_VALUES.
+ */
+int UpsertKeyValue(HashInf *pHashInf, const void *key, size_t len, void *pValue);
+
+/**
+ * @brief Get value of a string, read from the hash item or slot GetStringAddress() finds.
+ *
+ *   Strings inserted without a value, by InsertString() or while building, have value NULL.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param str Which string you want to find.
+ * @return Value of string, or NULL if not found, built without HASH_MAP_VALUES or hash information is
+ *         loaded from a file, values are not saved.
+ */
+void *GetStringValue(HashInf *pHashInf, const char *str);
+
+/**
+ * @brief Get value of a key with known length.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param key Which key you want to find.
+ * @param len Length of key.
+ * @return Value of key, or NULL if not found, hash method has no length version, built without
+ *         HASH_MAP_VALUES or hash information is loaded from a file.
+ */
+void *GetKeyValue(HashInf *pHashInf, const void *key, size_t len);
+
+/**
+ * @brief Copy every key into a string pool owned by hash information, keys of later inserts are copied too.
+ *
+ *   Keys are copied in order of hash table, so keys of a chain or a probe are next to each other in memory.
+ * Each copy has it's length before it and '\0' after it. Afterwards lookups return address of the copy,
+ * and array, list or keys hash information is created from can be freed. Bytes of a removed key stay in
+ * pool until hash information is deleted. Same as creating hash information with HASH_INTERN_KEYS.
+ *
+ * @param pHashInf Which hash information to intern keys of.
+ * @return SUCCEED, or FAILED if no memory, nothing is changed then. A loaded file owns it's keys already,
+ *         SUCCEED is returned without copying.
+ */
+int InternKeys(HashInf *pHashInf);
+
+/**
+ * @brief Build a key filter from hash keys in hash information, checked before each search.
+ *
+ *   A key the filter has never seen is a miss without reading any bucket or slot, see KeyFilter.h.
+ * No key is hashed again, hash items and slots keep their hash key. Filter is sized for keys hash
+ * table holds before it grows, later inserts are added to it, and it is built again each time hash
+ * table grows. A loaded file gets a filter as well, it is kept in memory only. Same as creating hash
+ * information with HASH_KEY_FILTER.
+ *
+ * @param pHashInf Which hash information to build filter of.
+ * @return SUCCEED, or FAILED if no memory, hash information has no filter then.
+ */
+int BuildKeyFilter(HashInf *pHashInf);
+
+/**
+ * @brief Get search counters of hash information, counted by all threads since it was created or reset.
+ *
+ * @param pHashInf Which hash information to query.
+ * @param pStats Save counters, all zero if built without HASH_STATS.
+ * @return SUCCEED, or FAILED if built without HASH_STATS.
+ * @see HashStats.h
+ */
+int GetHashStats(HashInf *pHashInf, HashStats *pStats);
+
+/**
+ * @brief Set search counters of hash information to zero.
+ *
+ * @param pHashInf Which hash information to reset.
+ */
+void ResetHashStats(HashInf *pHashInf);
+
+/**
+ * @brief Save hash information into a file, LoadHashInf() maps it back.
+ *
+ *   Keys are copied into the file, so it does not depend on memory of this process. File is written
+ * beside path first and renamed, processes which mapped an older file keep reading it.
+ *
+ * @param pHashInf Which hash information to save, built with a hash method in HashMethod.h.
+ * @param path Where to save.
+ * @return SUCCEED, or FAILED if hash method is not in HashMethod.h, no memory or file can not be written.
+ */
+int SaveHashInf(HashInf *pHashInf, const char *path);
+
+/**
+ * @brief Map a file saved by SaveHashInf() read only, search it where it is, without reading it first.
+ *
+ *   Addresses returned by lookups point into the mapped file, keys are followed by '\0'. A loaded hash
+ * information can not be changed, insert, remove and upsert return FAILED. Processes loading the same
+ * file share one copy of it in page cache.
+ *
+ * @param path File to load.
+ * @return Pointer to loaded hash information, delete it by DeleteHashInf(), or NULL if file can not be
+ *         read or is not a valid hash file of this machine.
+ */
+HashInf *LoadHashInf(const char *path);
+
 #endif /* HASH2_H_ */
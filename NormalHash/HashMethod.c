@@ -9,135 +9,103 @@
  */
 
 #include "HashMethod.h"
+#include "HashMethodInline.h"
 
 // SDB Hash Function
 unsigned int SDBMHash(const char *str)
 {
-	unsigned int hash = 0;
-
-	while (*str)
-	{
-		// equivalent to: hash = 65599*hash + (*str++);
-		hash = (*str++) + (hash << 6) + (hash << 16) - hash;
-	}
+	return SDBMHashInline(str);
+}
 
-	return (hash & 0x7FFFFFFF);
+unsigned int SDBMHashLen(const void *key, size_t len)
+{
+	return SDBMHashLenInline(key, len);
 }
 
 // RS Hash Function
 unsigned int RSHash(const char *str)
 {
-	unsigned int b = 378551;
-	unsigned int a = 63689;
-	unsigned int hash = 0;
-
-	while (*str)
-	{
-		hash = hash * a + (*str++);
-		a *= b;
-	}
+	return RSHashInline(str);
+}
 
-	return (hash & 0x7FFFFFFF);
+unsigned int RSHashLen(const void *key, size_t len)
+{
+	return RSHashLenInline(key, len);
 }
 
 // JS Hash Function
 unsigned int JSHash(const char *str)
 {
-	unsigned int hash = 1315423911;
-
-	while (*str)
-	{
-		hash ^= ((hash << 5) + (*str++) + (hash >> 2));
-	}
+	return JSHashInline(str);
+}
 
-	return (hash & 0x7FFFFFFF);
+unsigned int JSHashLen(const void *key, size_t len)
+{
+	return JSHashLenInline(key, len);
 }
 
 // P. J. Weinberger Hash Function
 unsigned int PJWHash(const char *str)
 {
-	unsigned int BitsInUnignedInt = (unsigned int)(sizeof(unsigned int) * 8);
-	unsigned int ThreeQuarters    = (unsigned int)((BitsInUnignedInt  * 3) / 4);
-	unsigned int OneEighth        = (unsigned int)(BitsInUnignedInt / 8);
-	unsigned int HighBits         = (unsigned int)(0xFFFFFFFF) << (BitsInUnignedInt - OneEighth);
-	unsigned int hash             = 0;
-	unsigned int test             = 0;
-
-	while (*str)
-	{
-		hash = (hash << OneEighth) + (*str++);
-		if ((test = hash & HighBits) != 0)
-		{
-			hash = ((hash ^ (test >> ThreeQuarters)) & (~HighBits));
-		}
-	}
+	return PJWHashInline(str);
+}
 
-	return (hash & 0x7FFFFFFF);
+unsigned int PJWHashLen(const void *key, size_t len)
+{
+	return PJWHashLenInline(key, len);
 }
 
 // ELF Hash Function
 unsigned int ELFHash(const char *str)
 {
-	unsigned int hash = 0;
-	unsigned int x	= 0;
-
-	while (*str)
-	{
-		hash = (hash << 4) + (*str++);
-		if ((x = hash & 0xF0000000L) != 0)
-		{
-			hash ^= (x >> 24);
-			hash &= ~x;
-		}
-	}
+	return ELFHashInline(str);
+}
 
-	return (hash & 0x7FFFFFFF);
+unsigned int ELFHashLen(const void *key, size_t len)
+{
+	return ELFHashLenInline(key, len);
 }
 
 // BKDR Hash Function
 unsigned int BKDRHash(const char *str)
 {
-	unsigned int seed = 131; // 31 131 1313 13131 131313 etc..
-	unsigned int hash = 0;
-
-	while (*str)
-	{
-		hash = hash * seed + (*str++);
-	}
+	return BKDRHashInline(str);
+}
 
-	return (hash & 0x7FFFFFFF);
+unsigned int BKDRHashLen(const void *key, size_t len)
+{
+	return BKDRHashLenInline(key, len);
 }
 
 // DJB Hash Function
 unsigned int DJBHash(const char *str)
 {
-	unsigned int hash = 5381;
-
-	while (*str)
-	{
-		hash += (hash << 5) + (*str++);
-	}
+	return DJBHashInline(str);
+}
 
-	return (hash & 0x7FFFFFFF);
+unsigned int DJBHashLen(const void *key, size_t len)
+{
+	return DJBHashLenInline(key, len);
 }
 
 // AP Hash Function
 unsigned int APHash(const char *str)
 {
-	unsigned int hash = 0;
-	int i;
-
-	for (i=0; *str; i++)
-	{
-		if ((i & 1) == 0)
-		{
-			hash ^= ((hash << 7) ^ (*str++) ^ (hash >> 3));
-		}
-		else
-		{
-			hash ^= (~((hash << 11) ^ (*str++) ^ (hash >> 5)));
-		}
-	}
-
-	return (hash & 0x7FFFFFFF);
+	return APHashInline(str);
+}
+
+unsigned int APHashLen(const void *key, size_t len)
+{
+	return APHashLenInline(key, len);
+}
+
+// Word Hash Function
+unsigned int WordHash(const char *str)
+{
+	return WordHashInline(str);
+}
+
+unsigned int WordHashLen(const void *key, size_t len)
+{
+	return WordHashLenInline(key, len);
 }
@@ -11,28 +11,52 @@
 #ifndef SIMPLEHASHMETHOD_H_
 #define SIMPLEHASHMETHOD_H_
 
+#include <stddef.h>
+
+/**
+ * Each method has a string version and a length version, XxxHashLen(str, strlen(str)) gives the same
+ * hash value as XxxHash(str). Length version needs no terminating '\0', so binary keys and slices of
+ * a buffer can be hashed without copying.
+ */
+
 // SDB Hash Function
 unsigned int SDBMHash(const char *str);
+unsigned int SDBMHashLen(const void *key, size_t len);
 
 // RS Hash Function
 unsigned int RSHash(const char *str);
+unsigned int RSHashLen(const void *key, size_t len);
 
 // JS Hash Function
 unsigned int JSHash(const char *str);
+unsigned int JSHashLen(const void *key, size_t len);
 
 // P. J. Weinberger Hash Function
 unsigned int PJWHash(const char *str);
+unsigned int PJWHashLen(const void *key, size_t len);
 
 // ELF Hash Function
 unsigned int ELFHash(const char *str);
+unsigned int ELFHashLen(const void *key, size_t len);
 
 // BKDR Hash Function
 unsigned int BKDRHash(const char *str);
+unsigned int BKDRHashLen(const void *key, size_t len);
 
 // DJB Hash Function
 unsigned int DJBHash(const char *str);
+unsigned int DJBHashLen(const void *key, size_t len);
 
 // AP Hash Function
 unsigned int APHash(const char *str);
+unsigned int APHashLen(const void *key, size_t len);
+
+// Word Hash Function, 8 bytes each read, mixed by 64x64->128 bits multiply.
+unsigned int WordHash(const char *str);
+unsigned int WordHashLen(const void *key, size_t len);
+
+// Vector Hash Function, 32 bytes each step by AVX2, SSE2 or plain C, selected by CPU at run time.
+unsigned int VectorHash(const char *str);
+unsigned int VectorHashLen(const void *key, size_t len);
 
 #endif /* SIMPLEHASHMETHOD_H_ */
@@ -0,0 +1,313 @@
+/**
+ * @file   NormalHash/HashMethodInline.h
+ *
+ * @date   Oct 16, 2026
+ * @author WangLiang
+ * @email  liang.wang@elektrobit.com
+ *
+ * @brief  Bodies of frequently used hash method, inline so they can be compiled into their caller.
+ *
+ *   HashMethod.c builds the callable methods listed in HashMethod.h from these, Hash.c builds one
+ * lookup function for each of them, with hash method and probe loop compiled together. Each method
+ * walks a key of known length, the string version measures it with strlen() first, so both give the
+ * same hash value for the same bytes.
+ */
+
+#ifndef HASHMETHODINLINE_H_
+#define HASHMETHODINLINE_H_
+
+#include <string.h>
+
+// SDB Hash Function
+static inline unsigned int SDBMHashLenInline(const void *key, size_t len)
+{
+	const char *str = (const char *)key;
+	const char *end = str + len;
+	unsigned int hash = 0;
+
+	while (str < end)
+	{
+		// equivalent to: hash = 65599*hash + (*str++);
+		hash = (*str++) + (hash << 6) + (hash << 16) - hash;
+	}
+
+	return (hash & 0x7FFFFFFF);
+}
+
+static inline unsigned int SDBMHashInline(const char *str)
+{
+	return SDBMHashLenInline(str, strlen(str));
+}
+
+// RS Hash Function
+static inline unsigned int RSHashLenInline(const void *key, size_t len)
+{
+	const char *str = (const char *)key;
+	const char *end = str + len;
+	unsigned int b = 378551;
+	unsigned int a = 63689;
+	unsigned int hash = 0;
+
+	while (str < end)
+	{
+		hash = hash * a + (*str++);
+		a *= b;
+	}
+
+	return (hash & 0x7FFFFFFF);
+}
+
+static inline unsigned int RSHashInline(const char *str)
+{
+	return RSHashLenInline(str, strlen(str));
+}
+
+// JS Hash Function
+static inline unsigned int JSHashLenInline(const void *key, size_t len)
+{
+	const char *str = (const char *)key;
+	const char *end = str + len;
+	unsigned int hash = 1315423911;
+
+	while (str < end)
+	{
+		hash ^= ((hash << 5) + (*str++) + (hash >> 2));
+	}
+
+	return (hash & 0x7FFFFFFF);
+}
+
+static inline unsigned int JSHashInline(const char *str)
+{
+	return JSHashLenInline(str, strlen(str));
+}
+
+// P. J. Weinberger Hash Function
+static inline unsigned int PJWHashLenInline(const void *key, size_t len)
+{
+	const char *str = (const char *)key;
+	const char *end = str + len;
+	unsigned int BitsInUnignedInt = (unsigned int)(sizeof(unsigned int) * 8);
+	unsigned int ThreeQuarters    = (unsigned int)((BitsInUnignedInt  * 3) / 4);
+	unsigned int OneEighth        = (unsigned int)(BitsInUnignedInt / 8);
+	unsigned int HighBits         = (unsigned int)(0xFFFFFFFF) << (BitsInUnignedInt - OneEighth);
+	unsigned int hash             = 0;
+	unsigned int test             = 0;
+
+	while (str < end)
+	{
+		hash = (hash << OneEighth) + (*str++);
+		if ((test = hash & HighBits) != 0)
+		{
+			hash = ((hash ^ (test >> ThreeQuarters)) & (~HighBits));
+		}
+	}
+
+	return (hash & 0x7FFFFFFF);
+}
+
+static inline unsigned int PJWHashInline(const char *str)
+{
+	return PJWHashLenInline(str, strlen(str));
+}
+
+// ELF Hash Function
+static inline unsigned int ELFHashLenInline(const void *key, size_t len)
+{
+	const char *str = (const char *)key;
+	const char *end = str + len;
+	unsigned int hash = 0;
+	unsigned int x	= 0;
+
+	while (str < end)
+	{
+		hash = (hash << 4) + (*str++);
+		if ((x = hash & 0xF0000000L) != 0)
+		{
+			hash ^= (x >> 24);
+			hash &= ~x;
+		}
+	}
+
+	return (hash & 0x7FFFFFFF);
+}
+
+static inline unsigned int ELFHashInline(const char *str)
+{
+	return ELFHashLenInline(str, strlen(str));
+}
+
+// BKDR Hash Function
+static inline unsigned int BKDRHashLenInline(const void *key, size_t len)
+{
+	const char *str = (const char *)key;
+	const char *end = str + len;
+	unsigned int seed = 131; // 31 131 1313 13131 131313 etc..
+	unsigned int hash = 0;
+
+	while (str < end)
+	{
+		hash = hash * seed + (*str++);
+	}
+
+	return (hash & 0x7FFFFFFF);
+}
+
+static inline unsigned int BKDRHashInline(const char *str)
+{
+	return BKDRHashLenInline(str, strlen(str));
+}
+
+// DJB Hash Function
+static inline unsigned int DJBHashLenInline(const void *key, size_t len)
+{
+	const char *str = (const char *)key;
+	const char *end = str + len;
+	unsigned int hash = 5381;
+
+	while (str < end)
+	{
+		hash += (hash << 5) + (*str++);
+	}
+
+	return (hash & 0x7FFFFFFF);
+}
+
+static inline unsigned int DJBHashInline(const char *str)
+{
+	return DJBHashLenInline(str, strlen(str));
+}
+
+// AP Hash Function
+static inline unsigned int APHashLenInline(const void *key, size_t len)
+{
+	const char *str = (const char *)key;
+	const char *end = str + len;
+	unsigned int hash = 0;
+	int i;
+
+	for (i=0; str < end; i++)
+	{
+		if ((i & 1) == 0)
+		{
+			hash ^= ((hash << 7) ^ (*str++) ^ (hash >> 3));
+		}
+		else
+		{
+			hash ^= (~((hash << 11) ^ (*str++) ^ (hash >> 5)));
+		}
+	}
+
+	return (hash & 0x7FFFFFFF);
+}
+
+static inline unsigned int APHashInline(const char *str)
+{
+	return APHashLenInline(str, strlen(str));
+}
+
+/**
+ * @brief Secret numbers of word hash, odd and with bits well mixed.
+ */
+#define WORD_HASH_P0 0x2d358dccaa6c78a5ULL
+#define WORD_HASH_P1 0x8bb84b93962eacc9ULL
+#define WORD_HASH_P2 0x4b33a62ed433d4a3ULL
+#define WORD_HASH_P3 0x4d5a2da51de1aa47ULL
+
+// Multiply two 64 bits numbers, fold 128 bits result into 64 bits.
+static inline unsigned long long HashMum(unsigned long long a, unsigned long long b)
+{
+	unsigned __int128 r = (unsigned __int128)a * b;
+	return (unsigned long long)r ^ (unsigned long long)(r >> 64);
+}
+
+// Read 8 bytes, no matter how address is aligned.
+static inline unsigned long long HashRead64(const unsigned char *p)
+{
+	unsigned long long v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+// Read 4 bytes, no matter how address is aligned.
+static inline unsigned long long HashRead32(const unsigned char *p)
+{
+	unsigned int v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+// Word Hash Function, 64 bits result, 16 bytes each step, 48 bytes in three lanes for long key.
+static inline unsigned long long WordHash64(const void *key, size_t len, unsigned long long seed)
+{
+	const unsigned char *p = (const unsigned char *)key;
+	unsigned long long a, b;
+	unsigned __int128 r;
+
+	seed ^= HashMum(seed ^ WORD_HASH_P0, WORD_HASH_P1);
+	if (len <= 16)
+	{
+		if (len >= 4)
+		{
+			// Two overlapped reads from each end cover 4..16 bytes.
+			a = (HashRead32(p) << 32) | HashRead32(p + ((len >> 3) << 2));
+			b = (HashRead32(p + len - 4) << 32) | HashRead32(p + len - 4 - ((len >> 3) << 2));
+		}
+		else if (len > 0)
+		{
+			a = ((unsigned long long)p[0] << 16) | ((unsigned long long)p[len >> 1] << 8) | p[len - 1];
+			b = 0;
+		}
+		else
+		{
+			a = b = 0;
+		}
+	}
+	else
+	{
+		size_t i = len;
+		if (i > 48)
+		{
+			unsigned long long seed1 = seed, seed2 = seed;
+			do
+			{
+				seed = HashMum(HashRead64(p) ^ WORD_HASH_P1, HashRead64(p + 8) ^ seed);
+				seed1 = HashMum(HashRead64(p + 16) ^ WORD_HASH_P2, HashRead64(p + 24) ^ seed1);
+				seed2 = HashMum(HashRead64(p + 32) ^ WORD_HASH_P3, HashRead64(p + 40) ^ seed2);
+				p += 48;
+				i -= 48;
+			}while (i > 48);
+			seed ^= seed1 ^ seed2;
+		}
+		while (i > 16)
+		{
+			seed = HashMum(HashRead64(p) ^ WORD_HASH_P1, HashRead64(p + 8) ^ seed);
+			i -= 16;
+			p += 16;
+		}
+		a = HashRead64(p + i - 16);
+		b = HashRead64(p + i - 8);
+	}
+
+	r = (unsigned __int128)(a ^ WORD_HASH_P1) * (b ^ seed);
+	return HashMum((unsigned long long)r ^ WORD_HASH_P0 ^ len, (unsigned long long)(r >> 64) ^ WORD_HASH_P1);
+}
+
+// Fold 64 bits hash into 31 bits, same range as other hash methods.
+static inline unsigned int FoldHash64(unsigned long long hash)
+{
+	return (unsigned int)(hash ^ (hash >> 32)) & 0x7FFFFFFF;
+}
+
+// Word Hash Function
+static inline unsigned int WordHashLenInline(const void *key, size_t len)
+{
+	return FoldHash64(WordHash64(key, len, 0));
+}
+
+static inline unsigned int WordHashInline(const char *str)
+{
+	return WordHashLenInline(str, strlen(str));
+}
+
+#endif /* HASHMETHODINLINE_H_ */
@@ -0,0 +1,152 @@
+/**
+ * @file   NormalHash/OpenHash.c
+ *
+ * @date   Oct 16, 2026
+ * @author WangLiang
+ * @email  liang.wang@elektrobit.com
+ *
+ * @brief  Flat open addressing hash table, linear probing, hash key and item stored inline.
+ */
+
+#include "../CProjectDfn.h"
+#include "OpenHash.h"
+
+/**
+ * @brief Get how many bits of slots are needed for a number of items.
+ * @param itemNum Number of items want to put into table.
+ * @return Number of slots is 2^return value.
+ */
+unsigned int SlotBitsForItems(unsigned int itemNum)
+{
+	unsigned long long nNeed = (unsigned long long)itemNum * 100 / OPEN_HASH_MAX_LOAD_PERCENT + 1;
+	unsigned int nSlotBits = 3;
+
+	while ((1ULL << nSlotBits) < nNeed)
+	{
+		++nSlotBits;
+	}
+	return nSlotBits;
+}
+
+/**
+ * @brief Create slot table, all slots are empty.
+ * @param nSlotBits Number of slots is 2^nSlotBits.
+ * @return Created slot table.
+ */
+HashSlot *InitSlotTable(unsigned int nSlotBits)
+{
+	return (HashSlot *)calloc(1U << nSlotBits, sizeof(HashSlot));
+}
+
+/**
+ * @brief Insert a key into slot table, value of it's slot is NULL.
+ *
+ * @param pSlots Which slot table to insert.
+ * @param nSlotBits Number of slots is 2^nSlotBits.
+ * @param nHash Hash key.
+ * @param key Which key want to insert into slot table.
+ * @param len Length of key.
+ * @return Index of slot used.
+ */
+unsigned int InsertSlot(HashSlot *pSlots, unsigned int nSlotBits, unsigned int nHash, const void *key, size_t len)
+{
+	unsigned int nMask = (1U << nSlotBits) - 1;
+	unsigned int nPos = SlotIndex(nHash, nSlotBits);
+
+	// Table is never full, OPEN_HASH_MAX_LOAD_PERCENT keeps some slots empty.
+	while (NULL != pSlots[nPos].item)
+	{
+		nPos = (nPos + 1) & nMask;
+	}
+	pSlots[nPos].HashKey = nHash;
+	pSlots[nPos].nKeyLen = (unsigned int)len;
+	pSlots[nPos].item = (void *)key;
+	SetSlotValue(&pSlots[nPos], NULL);
+	return nPos;
+}
+
+/**
+ * @brief Insert a key into slot table, many threads can insert at the same time.
+ * @note No one may search slot table or use other insert functions until all inserting threads finish.
+ *
+ * @param pSlots Which slot table to insert.
+ * @param nSlotBits Number of slots is 2^nSlotBits.
+ * @param nHash Hash key.
+ * @param key Which key want to insert into slot table.
+ * @param len Length of key.
+ * @return Index of slot used.
+ */
+unsigned int InsertSlotAtomic(HashSlot *pSlots, unsigned int nSlotBits, unsigned int nHash,
+		                      const void *key, size_t len)
+{
+	unsigned int nMask = (1U << nSlotBits) - 1;
+	unsigned int nPos = SlotIndex(nHash, nSlotBits);
+
+	// Claim an empty slot, whoever sets item first owns it.
+	while (!__sync_bool_compare_and_swap(&(pSlots[nPos].item), NULL, (void *)key))
+	{
+		nPos = (nPos + 1) & nMask;
+	}
+	pSlots[nPos].HashKey = nHash;
+	pSlots[nPos].nKeyLen = (unsigned int)len;
+	return nPos;
+}
+
+/**
+ * @brief Remove a slot from slot table, later slots of same probe are shifted back to fill it.
+ *
+ *   No tombstone is left, so probe of other strings never gets longer after removing.
+ *
+ * @param pSlots Which slot table to remove from.
+ * @param nSlotBits Number of slots is 2^nSlotBits.
+ * @param pSlot Slot returned by FindSlot().
+ */
+void RemoveSlot(HashSlot *pSlots, unsigned int nSlotBits, HashSlot *pSlot)
+{
+	unsigned int nMask = (1U << nSlotBits) - 1;
+	unsigned int nHole = (unsigned int)(pSlot - pSlots);
+	unsigned int nPos = nHole;
+	unsigned int nHome;
+
+	for (nPos = (nPos + 1) & nMask; NULL != pSlots[nPos].item; nPos = (nPos + 1) & nMask)
+	{
+		// Slot can stay if it's start slot is cyclically in (nHole, nPos].
+		nHome = SlotIndex(pSlots[nPos].HashKey, nSlotBits);
+		if ((nHole <= nPos) ? ((nHole < nHome) && (nHome <= nPos)) : ((nHole < nHome) || (nHome <= nPos)))
+		{
+			continue;
+		}
+		pSlots[nHole] = pSlots[nPos];
+		nHole = nPos;
+	}
+	pSlots[nHole].item = NULL;
+}
+
+/**
+ * @brief Create a slot table of another size, move every used slot into it and free the old one.
+ *
+ * @param pSlots Old slot table.
+ * @param nSlotBits Number of slots in old table is 2^nSlotBits.
+ * @param nNewSlotBits Number of slots in new table is 2^nNewSlotBits.
+ * @return New slot table, or NULL if no memory, old table is kept then.
+ */
+HashSlot *ResizeSlotTable(HashSlot *pSlots, unsigned int nSlotBits, unsigned int nNewSlotBits)
+{
+	HashSlot *pNewSlots = InitSlotTable(nNewSlotBits);
+
+	if (IS_NULL(pNewSlots))
+	{
+		return NULL;
+	}
+	for (unsigned int i=0; i<(1U << nSlotBits); ++i)
+	{
+		if (NULL != pSlots[i].item)
+		{
+			// Whole slot is copied, value goes with it.
+			pNewSlots[InsertSlot(pNewSlots, nNewSlotBits, pSlots[i].HashKey, pSlots[i].item,
+					pSlots[i].nKeyLen)] = pSlots[i];
+		}
+	}
+	FREE(pSlots);
+	return pNewSlots;
+}
@@ -0,0 +1,188 @@
+/**
+ * @file   NormalHash/OpenHash.h
+ *
+ * @date   Oct 16, 2026
+ * @author WangLiang
+ * @email  liang.wang@elektrobit.com
+ *
+ * @brief  Flat open addressing hash table, linear probing, hash key and item stored inline.
+ */
+
+#ifndef OPENHASH_H_
+#define OPENHASH_H_
+
+#include "../CProjectDfn.h"
+#include "../HashStats.h"
+
+/**
+ * Data structure:
+ *
+ *    slot 0    slot 1    slot 2    slot 3    slot 4     ...   slot 2^bits-1
+ * +---------+---------+---------+---------+---------+-------+---------+
+ * | HashKey | HashKey |  NULL   | HashKey |  NULL   |  ...  | HashKey |
+ * | nKeyLen | nKeyLen |         | nKeyLen |         |       | nKeyLen |
+ * |  item   |  item   |         |  item   |         |       |  item   |
+ * +---------+---------+---------+---------+---------+-------+---------+
+ *
+ *   All slots are in one contiguous array, number of slots is power of 2. A key starts probing at
+ * SlotIndex() of it's hash key, and walks forward until it finds itself or an empty slot. Key length
+ * fills the padding between hash key and item, so a slot is still 16 bytes on 64 bits.
+ */
+
+/**
+ * @brief Max percent of slots used, table is sized from number of items to keep under it.
+ */
+#define OPEN_HASH_MAX_LOAD_PERCENT 75
+
+/**
+ * @brief Hash information for each slot.
+ */
+typedef struct HashSlot
+{
+	unsigned int HashKey;    ///< Hash key, only valid when item is not NULL.
+	unsigned int nKeyLen;    ///< Length of key item points to, only valid when item is not NULL.
+	void *item;              ///< Address of item, NULL means empty slot.
+#ifdef HASH_MAP_VALUES
+	void *pValue;            ///< Value of key, see HASH_MAP_VALUES in Hash.h.
+#endif
+}HashSlot;
+
+/**
+ * @brief Value kept in a slot, always NULL without HASH_MAP_VALUES.
+ */
+static inline void *SlotValue(const HashSlot *pSlot)
+{
+#ifdef HASH_MAP_VALUES
+	return pSlot->pValue;
+#else
+	(void)pSlot;
+	return NULL;
+#endif
+}
+
+static inline void SetSlotValue(HashSlot *pSlot, void *pValue)
+{
+#ifdef HASH_MAP_VALUES
+	pSlot->pValue = pValue;
+#else
+	(void)pSlot;
+	(void)pValue;
+#endif
+}
+
+/**
+ * @brief Get start slot of a hash key.
+ *
+ *   Hash key is multiplied by golden ratio and the high bits are taken, so simple hash methods whose
+ * low bits are poorly mixed still spread over all slots.
+ *
+ * @param nHash Hash key of string.
+ * @param nSlotBits Number of slots is 2^nSlotBits.
+ * @return Index of start slot.
+ */
+static inline unsigned int SlotIndex(unsigned int nHash, unsigned int nSlotBits)
+{
+	return (unsigned int)(((unsigned long long)(nHash * 2654435769U) << nSlotBits) >> 32);
+}
+
+/**
+ * @brief Get how many bits of slots are needed for a number of items.
+ * @param itemNum Number of items want to put into table.
+ * @return Number of slots is 2^return value.
+ */
+unsigned int SlotBitsForItems(unsigned int itemNum);
+
+/**
+ * @brief Create slot table, all slots are empty.
+ * @param nSlotBits Number of slots is 2^nSlotBits.
+ * @return Created slot table.
+ */
+HashSlot *InitSlotTable(unsigned int nSlotBits);
+
+/**
+ * @brief Insert a key into slot table, value of it's slot is NULL.
+ *
+ * @param pSlots Which slot table to insert.
+ * @param nSlotBits Number of slots is 2^nSlotBits.
+ * @param nHash Hash key.
+ * @param key Which key want to insert into slot table.
+ * @param len Length of key.
+ * @return Index of slot used.
+ */
+unsigned int InsertSlot(HashSlot *pSlots, unsigned int nSlotBits, unsigned int nHash, const void *key, size_t len);
+
+/**
+ * @brief Insert a key into slot table, many threads can insert at the same time.
+ * @note No one may search slot table or use other insert functions until all inserting threads finish.
+ *
+ * @param pSlots Which slot table to insert.
+ * @param nSlotBits Number of slots is 2^nSlotBits.
+ * @param nHash Hash key.
+ * @param key Which key want to insert into slot table.
+ * @param len Length of key.
+ * @return Index of slot used.
+ */
+unsigned int InsertSlotAtomic(HashSlot *pSlots, unsigned int nSlotBits, unsigned int nHash,
+		                      const void *key, size_t len);
+
+/**
+ * @brief Search a key in slot table.
+ *
+ *   Inline, so a lookup compiled with a known hash method has hash and probe loop in one function.
+ *
+ * @param pSlots Which slot table to search.
+ * @param nSlotBits Number of slots is 2^nSlotBits.
+ * @param nHash Hash key.
+ * @param key Which key want to search.
+ * @param len Length of key.
+ * @param pStats Counters of calling thread, only used with HASH_STATS.
+ * @return Slot holding the key, or NULL if not found.
+ */
+static inline HashSlot *FindSlot(HashSlot *pSlots, unsigned int nSlotBits, unsigned int nHash,
+		                         const void *key, size_t len, HashStats *pStats)
+{
+	unsigned int nMask = (1U << nSlotBits) - 1;
+	unsigned int nPos = SlotIndex(nHash, nSlotBits);
+	unsigned int nProbes = 0;
+
+	while (NULL != pSlots[nPos].item)
+	{
+		++nProbes;
+		if (nHash == pSlots[nPos].HashKey)
+		{
+			HASH_STATS_ADD(pStats, nCompares, 1);
+			if (IS_SAME_KEY(key, len, pSlots[nPos].item, pSlots[nPos].nKeyLen))
+			{
+				CountHashSearch(pStats, YES, nProbes);
+				return &pSlots[nPos];
+			}
+			HASH_STATS_ADD(pStats, nHashMismatches, 1);
+		}
+		nPos = (nPos + 1) & nMask;
+	}
+	CountHashSearch(pStats, NO, nProbes);
+	return NULL;
+}
+
+/**
+ * @brief Remove a slot from slot table, later slots of same probe are shifted back to fill it.
+ *
+ *   No tombstone is left, so probe of other strings never gets longer after removing.
+ *
+ * @param pSlots Which slot table to remove from.
+ * @param nSlotBits Number of slots is 2^nSlotBits.
+ * @param pSlot Slot returned by FindSlot().
+ */
+void RemoveSlot(HashSlot *pSlots, unsigned int nSlotBits, HashSlot *pSlot);
+
+/**
+ * @brief Create a slot table of another size, move every used slot into it and free the old one.
+ *
+ * @param pSlots Old slot table.
+ * @param nSlotBits Number of slots in old table is 2^nSlotBits.
+ * @param nNewSlotBits Number of slots in new table is 2^nNewSlotBits.
+ * @return New slot table, or NULL if no memory, old table is kept then.
+ */
+HashSlot *ResizeSlotTable(HashSlot *pSlots, unsigned int nSlotBits, unsigned int nNewSlotBits);
+
+#endif /* OPENHASH_H_ */
@@ -0,0 +1,129 @@
+/**
+ * @file   NormalHash/Slab.c
+ *
+ * @date   Oct 16, 2026
+ * @author WangLiang
+ * @email  liang.wang@elektrobit.com
+ *
+ * @brief  Allocate same size objects from large blocks, release all of them at once.
+ */
+
+#include "../CProjectDfn.h"
+#include "Slab.h"
+
+/**
+ * @brief Initialize a slab, no memory is allocated until first SlabAlloc().
+ *
+ * @param pSlab Which slab to initialize.
+ * @param nObjSize Size of each object.
+ * @param nExpectObjs How many objects expected, decides block size.
+ */
+void SlabInit(Slab *pSlab, unsigned int nObjSize, unsigned int nExpectObjs)
+{
+	// Round object size up, so every object in block is aligned as block header.
+	pSlab->nObjSize = (nObjSize + sizeof(SlabBlock) - 1) / sizeof(SlabBlock) * sizeof(SlabBlock);
+	pSlab->nBlockObjs = CLAMP(nExpectObjs, SLAB_MIN_BLOCK_OBJS, SLAB_MAX_BLOCK_OBJS);
+	pSlab->pBlocks = NULL;
+	pSlab->pNext = NULL;
+	pSlab->pEnd = NULL;
+	pSlab->pFreeList = NULL;
+}
+
+/**
+ * @brief Allocate an object from slab.
+ * @param pSlab Which slab to allocate from.
+ * @return Address of object, or NULL if no memory.
+ */
+void *SlabAlloc(Slab *pSlab)
+{
+	void *pObj;
+
+	// Reuse freed object first.
+	if (IS_NOT_NULL(pSlab->pFreeList))
+	{
+		pObj = pSlab->pFreeList;
+		pSlab->pFreeList = *(void **)pObj;
+		return pObj;
+	}
+
+	// Newest block is used up, chain a new one.
+	if (pSlab->pNext == pSlab->pEnd)
+	{
+		SlabBlock *pBlock = (SlabBlock *)malloc(sizeof(SlabBlock) + (size_t)pSlab->nObjSize * pSlab->nBlockObjs);
+		if (IS_NULL(pBlock))
+		{
+			return NULL;
+		}
+		pBlock->next = pSlab->pBlocks;
+		pSlab->pBlocks = pBlock;
+		pSlab->pNext = (char *)(pBlock + 1);
+		pSlab->pEnd = pSlab->pNext + (size_t)pSlab->nObjSize * pSlab->nBlockObjs;
+	}
+
+	pObj = pSlab->pNext;
+	pSlab->pNext += pSlab->nObjSize;
+	return pObj;
+}
+
+/**
+ * @brief Allocate many objects in one new block, they are released with the whole slab.
+ *
+ *   Objects are contiguous, so different threads can fill different objects of the block.
+ *
+ * @param pSlab Which slab to allocate from.
+ * @param nObjs Number of objects.
+ * @return Address of first object, or NULL if no memory.
+ */
+void *SlabAllocArray(Slab *pSlab, unsigned int nObjs)
+{
+	SlabBlock *pBlock = (SlabBlock *)malloc(sizeof(SlabBlock) + (size_t)pSlab->nObjSize * nObjs);
+	if (IS_NULL(pBlock))
+	{
+		return NULL;
+	}
+
+	// Chain it behind newest block, so SlabAlloc() goes on using newest block.
+	if (IS_NULL(pSlab->pBlocks))
+	{
+		pBlock->next = NULL;
+		pSlab->pBlocks = pBlock;
+	}
+	else
+	{
+		pBlock->next = pSlab->pBlocks->next;
+		pSlab->pBlocks->next = pBlock;
+	}
+	return pBlock + 1;
+}
+
+/**
+ * @brief Give an object back to slab, it will be reused by next SlabAlloc().
+ * @param pSlab Which slab object is allocated from.
+ * @param pObj Address of object.
+ */
+void SlabFree(Slab *pSlab, void *pObj)
+{
+	*(void **)pObj = pSlab->pFreeList;
+	pSlab->pFreeList = pObj;
+}
+
+/**
+ * @brief Release every object allocated from slab, one free for each block.
+ * @param pSlab Which slab to release.
+ */
+void SlabDestroy(Slab *pSlab)
+{
+	SlabBlock *pBlock = pSlab->pBlocks;
+	SlabBlock *pNextBlock;
+
+	while (IS_NOT_NULL(pBlock))
+	{
+		pNextBlock = pBlock->next;
+		FREE(pBlock);
+		pBlock = pNextBlock;
+	}
+	pSlab->pBlocks = NULL;
+	pSlab->pNext = NULL;
+	pSlab->pEnd = NULL;
+	pSlab->pFreeList = NULL;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file   NormalHash/Slab.h
+ *
+ * @date   Oct 16, 2026
+ * @author WangLiang
+ * @email  liang.wang@elektrobit.com
+ *
+ * @brief  Allocate same size objects from large blocks, release all of them at once.
+ */
+
+#ifndef SLAB_H_
+#define SLAB_H_
+
+/**
+ * Data structure:
+ *
+ * +--------+      +------+-----+-----+-----+     +------+-----+-----+-----+
+ * |  Slab  | -->  | next | obj | obj | obj | --> | next | obj | obj | obj | --> NULL
+ * +--------+      +------+-----+-----+-----+     +------+-----+-----+-----+
+ *                  newest block    ^ pNext         older block, all used
+ *
+ *   Objects given back by SlabFree() are chained in a free list through their first bytes, and are
+ * reused before new objects in newest block.
+ */
+
+//! Minimum and maximum number of objects in one block.
+#define SLAB_MIN_BLOCK_OBJS 64
+#define SLAB_MAX_BLOCK_OBJS 65536
+
+/**
+ * @brief Header of each block, objects follow it.
+ */
+typedef union SlabBlock
+{
+	union SlabBlock *next;    ///< Older block.
+	long double align;        ///< Keep objects after header aligned.
+}SlabBlock;
+
+/**
+ * @brief Slab information.
+ */
+typedef struct Slab
+{
+	unsigned int nObjSize;    ///< Size of each object.
+	unsigned int nBlockObjs;  ///< Number of objects in each block.
+	SlabBlock *pBlocks;       ///< Allocated blocks, newest first.
+	char *pNext;              ///< Next unused object in newest block.
+	char *pEnd;               ///< End of newest block.
+	void *pFreeList;          ///< Objects given back by SlabFree().
+}Slab;
+
+/**
+ * @brief Initialize a slab, no memory is allocated until first SlabAlloc().
+ *
+ * @param pSlab Which slab to initialize.
+ * @param nObjSize Size of each object.
+ * @param nExpectObjs How many objects expected, decides block size.
+ */
+void SlabInit(Slab *pSlab, unsigned int nObjSize, unsigned int nExpectObjs);
+
+/**
+ * @brief Allocate an object from slab.
+ * @param pSlab Which slab to allocate from.
+ * @return Address of object, or NULL if no memory.
+ */
+void *SlabAlloc(Slab *pSlab);
+
+/**
+ * @brief Allocate many objects in one new block, they are released with the whole slab.
+ *
+ *   Objects are contiguous, so different threads can fill different objects of the block.
+ *
+ * @param pSlab Which slab to allocate from.
+ * @param nObjs Number of objects.
+ * @return Address of first object, or NULL if no memory.
+ */
+void *SlabAllocArray(Slab *pSlab, unsigned int nObjs);
+
+/**
+ * @brief Give an object back to slab, it will be reused by next SlabAlloc().
+ * @param pSlab Which slab object is allocated from.
+ * @param pObj Address of object.
+ */
+void SlabFree(Slab *pSlab, void *pObj);
+
+/**
+ * @brief Release every object allocated from slab, one free for each block.
+ * @param pSlab Which slab to release.
+ */
+void SlabDestroy(Slab *pSlab);
+
+#endif /* SLAB_H_ */
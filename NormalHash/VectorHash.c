@@ -0,0 +1,224 @@
+/**
+ * @file   NormalHash/VectorHash.c
+ *
+ * @date   Oct 16, 2026
+ * @author WangLiang
+ * @email  liang.wang@elektrobit.com
+ *
+ * @brief  Hash long keys 32 bytes each step, kernel is selected by CPU at run time.
+ *
+ * Plain C, SSE2 and AVX2 kernels give exactly the same result, so a table
+ * built on one machine can be searched on another.
+ */
+
+#include <stddef.h>
+#include <string.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define VECTOR_HASH_X86
+#endif
+
+#include "HashMethod.h"
+#include "HashMethodInline.h"
+
+#define STRIPE_LEN 32
+#define STRIPES_PER_SCRAMBLE 16
+#define SCRAMBLE_PRIME 0x9E3779B1U
+
+typedef void (*AccumulateMethod)(unsigned long long *acc, const unsigned char *p, size_t nStripes);
+
+// Stripe i is mixed with secret[i % 16 .. i % 16 + 3], scramble uses secret[16 .. 19].
+static const unsigned long long secret[STRIPES_PER_SCRAMBLE + 4] =
+{
+	0x7b33938e2bce9ba7ULL, 0xde974e376c7f3679ULL, 0x3c741c30bc807fcfULL, 0x4f51cba785b9b42bULL,
+	0x62117d04b3586a59ULL, 0xda3682d4a1d67c09ULL, 0xf12647f066d5550dULL, 0x648e34ed71e2310fULL,
+	0x2f440f194a24602dULL, 0x7b7fe076e14e2989ULL, 0xd680f895a6e3c5d1ULL, 0xc9445d107ded9e29ULL,
+	0xc4350a8b2b270f95ULL, 0x051e4a8aa465d593ULL, 0x94c0be6b5525341dULL, 0xd328938bf84b4d69ULL,
+	0xce247d1f7a9a2917ULL, 0x3a508a2898b1bce7ULL, 0x03db641cea8a07e3ULL, 0xb0a60f953cd444e3ULL,
+};
+
+/**
+ * @brief Mix stripes into four accumulators, plain C version.
+ *
+ * Each 8 bytes lane does acc += lo32(d ^ s) * hi32(d ^ s) + d, every 16
+ * stripes accumulators are scrambled to keep high bits moving.
+ *
+ * @param acc Four accumulators.
+ * @param p Start of first stripe.
+ * @param nStripes How many 32 bytes stripes to mix.
+ */
+static void AccumulateScalar(unsigned long long *acc, const unsigned char *p, size_t nStripes)
+{
+	size_t stripe;
+	int i;
+
+	for (stripe = 0; stripe < nStripes; stripe++, p += STRIPE_LEN)
+	{
+		const unsigned long long *s = secret + (stripe % STRIPES_PER_SCRAMBLE);
+		for (i = 0; i < 4; i++)
+		{
+			unsigned long long d = HashRead64(p + i * 8);
+			unsigned long long k = d ^ s[i];
+			acc[i] += (k & 0xFFFFFFFFULL) * (k >> 32) + d;
+		}
+
+		if (stripe % STRIPES_PER_SCRAMBLE == STRIPES_PER_SCRAMBLE - 1)
+		{
+			for (i = 0; i < 4; i++)
+			{
+				acc[i] = (acc[i] ^ (acc[i] >> 47) ^ secret[STRIPES_PER_SCRAMBLE + i]) * SCRAMBLE_PRIME;
+			}
+		}
+	}
+}
+
+#ifdef VECTOR_HASH_X86
+
+// Same as AccumulateScalar(), two lanes in each SSE2 register.
+__attribute__((target("sse2")))
+static void AccumulateSSE2(unsigned long long *acc, const unsigned char *p, size_t nStripes)
+{
+	__m128i acc0 = _mm_loadu_si128((const __m128i *)acc);
+	__m128i acc1 = _mm_loadu_si128((const __m128i *)(acc + 2));
+	const __m128i prime = _mm_set1_epi32(SCRAMBLE_PRIME);
+	size_t stripe;
+
+	for (stripe = 0; stripe < nStripes; stripe++, p += STRIPE_LEN)
+	{
+		const unsigned long long *s = secret + (stripe % STRIPES_PER_SCRAMBLE);
+		__m128i d0 = _mm_loadu_si128((const __m128i *)p);
+		__m128i d1 = _mm_loadu_si128((const __m128i *)(p + 16));
+		__m128i k0 = _mm_xor_si128(d0, _mm_loadu_si128((const __m128i *)s));
+		__m128i k1 = _mm_xor_si128(d1, _mm_loadu_si128((const __m128i *)(s + 2)));
+
+		// _mm_mul_epu32() multiplies low 32 bits of each lane, shuffle moves high half down.
+		acc0 = _mm_add_epi64(acc0, _mm_add_epi64(_mm_mul_epu32(k0, _mm_shuffle_epi32(k0, 0x31)), d0));
+		acc1 = _mm_add_epi64(acc1, _mm_add_epi64(_mm_mul_epu32(k1, _mm_shuffle_epi32(k1, 0x31)), d1));
+
+		if (stripe % STRIPES_PER_SCRAMBLE == STRIPES_PER_SCRAMBLE - 1)
+		{
+			__m128i x0 = _mm_xor_si128(_mm_xor_si128(acc0, _mm_srli_epi64(acc0, 47)),
+					_mm_loadu_si128((const __m128i *)(secret + STRIPES_PER_SCRAMBLE)));
+			__m128i x1 = _mm_xor_si128(_mm_xor_si128(acc1, _mm_srli_epi64(acc1, 47)),
+					_mm_loadu_si128((const __m128i *)(secret + STRIPES_PER_SCRAMBLE + 2)));
+
+			// 64 bits * 32 bits = lo * prime + (hi * prime << 32).
+			acc0 = _mm_add_epi64(_mm_mul_epu32(x0, prime),
+					_mm_slli_epi64(_mm_mul_epu32(_mm_srli_epi64(x0, 32), prime), 32));
+			acc1 = _mm_add_epi64(_mm_mul_epu32(x1, prime),
+					_mm_slli_epi64(_mm_mul_epu32(_mm_srli_epi64(x1, 32), prime), 32));
+		}
+	}
+
+	_mm_storeu_si128((__m128i *)acc, acc0);
+	_mm_storeu_si128((__m128i *)(acc + 2), acc1);
+}
+
+// Same as AccumulateScalar(), four lanes in one AVX2 register.
+__attribute__((target("avx2")))
+static void AccumulateAVX2(unsigned long long *acc, const unsigned char *p, size_t nStripes)
+{
+	__m256i acc0 = _mm256_loadu_si256((const __m256i *)acc);
+	const __m256i prime = _mm256_set1_epi32(SCRAMBLE_PRIME);
+	const __m256i scramble = _mm256_loadu_si256((const __m256i *)(secret + STRIPES_PER_SCRAMBLE));
+	size_t stripe, i;
+
+	for (stripe = 0; stripe < nStripes; stripe += STRIPES_PER_SCRAMBLE)
+	{
+		size_t nBlockStripes = nStripes - stripe;
+
+		if (nBlockStripes > STRIPES_PER_SCRAMBLE)
+		{
+			nBlockStripes = STRIPES_PER_SCRAMBLE;
+		}
+
+		for (i = 0; i < nBlockStripes; i++, p += STRIPE_LEN)
+		{
+			__m256i d = _mm256_loadu_si256((const __m256i *)p);
+			__m256i k = _mm256_xor_si256(d, _mm256_loadu_si256((const __m256i *)(secret + i)));
+
+			acc0 = _mm256_add_epi64(acc0, _mm256_add_epi64(_mm256_mul_epu32(k, _mm256_shuffle_epi32(k, 0x31)), d));
+		}
+
+		if (nBlockStripes == STRIPES_PER_SCRAMBLE)
+		{
+			__m256i x = _mm256_xor_si256(_mm256_xor_si256(acc0, _mm256_srli_epi64(acc0, 47)), scramble);
+
+			acc0 = _mm256_add_epi64(_mm256_mul_epu32(x, prime),
+					_mm256_slli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(x, 32), prime), 32));
+		}
+	}
+
+	_mm256_storeu_si256((__m256i *)acc, acc0);
+}
+
+#endif
+
+/**
+ * @brief Choose the widest kernel this CPU supports.
+ *
+ * @return Kernel to mix stripes.
+ */
+static AccumulateMethod SelectAccumulate(void)
+{
+#ifdef VECTOR_HASH_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+	{
+		return AccumulateAVX2;
+	}
+	if (__builtin_cpu_supports("sse2"))
+	{
+		return AccumulateSSE2;
+	}
+#endif
+	return AccumulateScalar;
+}
+
+/**
+ * @brief Hash a key with known length, 64 bits result.
+ *
+ * Keys shorter than one stripe go to WordHash64() directly, tail of longer
+ * keys is hashed by WordHash64() seeded with accumulators.
+ *
+ * @param key Start of key.
+ * @param len Length of key in bytes.
+ * @return 64 bits hash value.
+ */
+static unsigned long long VectorHash64(const void *key, size_t len)
+{
+	// Kernel is selected at first call, racing threads always select the same one.
+	static AccumulateMethod accumulate = NULL;
+	AccumulateMethod method = __atomic_load_n(&accumulate, __ATOMIC_RELAXED);
+	const unsigned char *p = (const unsigned char *)key;
+	unsigned long long acc[4] = {WORD_HASH_P0, WORD_HASH_P1, WORD_HASH_P2, WORD_HASH_P3};
+	size_t nStripes = len / STRIPE_LEN;
+	unsigned long long seed;
+
+	if (nStripes == 0)
+	{
+		return WordHash64(key, len, 0);
+	}
+
+	if (method == NULL)
+	{
+		method = SelectAccumulate();
+		__atomic_store_n(&accumulate, method, __ATOMIC_RELAXED);
+	}
+
+	(*method)(acc, p, nStripes);
+
+	seed = HashMum(acc[0] ^ acc[2], acc[1] ^ acc[3]) ^ len;
+	return WordHash64(p + nStripes * STRIPE_LEN, len % STRIPE_LEN, seed);
+}
+
+// Vector Hash Function
+unsigned int VectorHash(const char *str)
+{
+	return FoldHash64(VectorHash64(str, strlen(str)));
+}
+
+unsigned int VectorHashLen(const void *key, size_t len)
+{
+	return FoldHash64(VectorHash64(key, len));
+}
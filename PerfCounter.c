@@ -0,0 +1,138 @@
+/**
+ * @file   PerfCounter.c
+ *
+ * @date   Oct 16, 2026
+ * @author WangLiang
+ * @email  liang.wang@elektrobit.com
+ *
+ * @brief  Read CPU performance counters of calling thread, Linux perf_event_open.
+ */
+
+#include "PerfCounter.h"
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+static const char *counterNames[PERF_COUNTER_NUM] =
+{
+	"cycles", "instructions", "llc_misses", "dtlb_misses", "branch_misses"
+};
+
+#ifdef __linux__
+
+/**
+ * @brief Open one counter of calling thread on any CPU.
+ *
+ * @return File of counter, -1 if not available.
+ */
+static int OpenCounter(unsigned int type, unsigned long long config)
+{
+	struct perf_event_attr attr;
+
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = type;
+	attr.config = config;
+	attr.disabled = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+	return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+#endif
+
+int OpenPerfCounters(PerfCounters *pCounters)
+{
+	int ret = FAILED;
+
+	for (int i=0; i<PERF_COUNTER_NUM; ++i)
+	{
+		pCounters->fds[i] = -1;
+		pCounters->values[i] = PERF_COUNTER_UNAVAILABLE;
+	}
+#ifdef __linux__
+	// Each counter has its own file, so one the CPU lacks does not take down the others.
+	pCounters->fds[PERF_CYCLES] = OpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+	pCounters->fds[PERF_INSTRUCTIONS] = OpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+	pCounters->fds[PERF_LLC_MISSES] = OpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+	pCounters->fds[PERF_DTLB_MISSES] = OpenCounter(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB
+			| (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+	pCounters->fds[PERF_BRANCH_MISSES] = OpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+	for (int i=0; i<PERF_COUNTER_NUM; ++i)
+	{
+		if (pCounters->fds[i] >= 0)
+		{
+			ret = SUCCEED;
+		}
+	}
+#endif
+	return ret;
+}
+
+void StartPerfCounters(PerfCounters *pCounters)
+{
+#ifdef __linux__
+	for (int i=0; i<PERF_COUNTER_NUM; ++i)
+	{
+		if (pCounters->fds[i] >= 0)
+		{
+			ioctl(pCounters->fds[i], PERF_EVENT_IOC_RESET, 0);
+			ioctl(pCounters->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+#else
+	(void)pCounters;
+#endif
+}
+
+void StopPerfCounters(PerfCounters *pCounters)
+{
+#ifdef __linux__
+	// Stop all first, so reading one counter is not counted by the next.
+	for (int i=0; i<PERF_COUNTER_NUM; ++i)
+	{
+		if (pCounters->fds[i] >= 0)
+		{
+			ioctl(pCounters->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+		}
+	}
+	for (int i=0; i<PERF_COUNTER_NUM; ++i)
+	{
+		// value, time enabled, time running.
+		unsigned long long data[3];
+
+		pCounters->values[i] = PERF_COUNTER_UNAVAILABLE;
+		if ((pCounters->fds[i] < 0) || (sizeof(data) != read(pCounters->fds[i], data, sizeof(data))))
+		{
+			continue;
+		}
+		if ((0 != data[2]) && (data[2] < data[1]))
+		{
+			data[0] = (unsigned long long)((double)data[0] * data[1] / data[2]);
+		}
+		pCounters->values[i] = data[0];
+	}
+#else
+	(void)pCounters;
+#endif
+}
+
+void ClosePerfCounters(PerfCounters *pCounters)
+{
+	for (int i=0; i<PERF_COUNTER_NUM; ++i)
+	{
+		if (pCounters->fds[i] >= 0)
+		{
+			close(pCounters->fds[i]);
+			pCounters->fds[i] = -1;
+		}
+	}
+}
+
+const char *PerfCounterName(int nCounter)
+{
+	return ((nCounter >= 0) && (nCounter < PERF_COUNTER_NUM)) ? counterNames[nCounter] : "unknown";
+}
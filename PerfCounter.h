@@ -0,0 +1,85 @@
+/**
+ * @file   PerfCounter.h
+ *
+ * @date   Oct 16, 2026
+ * @author WangLiang
+ * @email  liang.wang@elektrobit.com
+ *
+ * @brief  Read CPU performance counters of calling thread around a piece of code, Linux perf_event_open.
+ *
+ *   Counters the kernel or CPU do not provide, in a virtual machine or with perf_event_paranoid too
+ * high, are marked unavailable and the others still work. On other systems every counter is unavailable.
+ */
+
+#ifndef PERFCOUNTER_H_
+#define PERFCOUNTER_H_
+
+#include "CProjectDfn.h"
+
+/**
+ * @brief Counters read by PerfCounters.
+ */
+enum
+{
+	PERF_CYCLES,
+	PERF_INSTRUCTIONS,
+	PERF_LLC_MISSES,
+	PERF_DTLB_MISSES,
+	PERF_BRANCH_MISSES,
+	PERF_COUNTER_NUM
+};
+
+/**
+ * @brief Value of a counter not opened.
+ */
+#define PERF_COUNTER_UNAVAILABLE (~0ULL)
+
+/**
+ * @brief Counters of calling thread.
+ */
+typedef struct PerfCounters
+{
+	int fds[PERF_COUNTER_NUM];                      ///< File of each counter, -1 if unavailable.
+	unsigned long long values[PERF_COUNTER_NUM];    ///< Counted between last start and stop.
+}PerfCounters;
+
+/**
+ * @brief Open counters of calling thread, user space only, counters are stopped.
+ *
+ * @param pCounters Counters to open.
+ * @return SUCCEED if at least one counter is available, else FAILED.
+ */
+int OpenPerfCounters(PerfCounters *pCounters);
+
+/**
+ * @brief Reset counters to zero and start counting.
+ *
+ * @param pCounters Opened counters.
+ */
+void StartPerfCounters(PerfCounters *pCounters);
+
+/**
+ * @brief Stop counting and read counters into values.
+ *
+ *   If counters were multiplexed with other users, values are scaled to the whole time counting.
+ *
+ * @param pCounters Started counters.
+ */
+void StopPerfCounters(PerfCounters *pCounters);
+
+/**
+ * @brief Close counters.
+ *
+ * @param pCounters Opened counters.
+ */
+void ClosePerfCounters(PerfCounters *pCounters);
+
+/**
+ * @brief Short name of a counter, to print.
+ *
+ * @param nCounter One of PERF_*.
+ * @return Name like "cycles".
+ */
+const char *PerfCounterName(int nCounter);
+
+#endif /* PERFCOUNTER_H_ */
@@ -0,0 +1,674 @@
+/**
+ * @file   PerfectHash/Hash.c
+ *
+ * @date   Oct 16, 2026
+ * @author WangLiang
+ * @email  liang.wang@elektrobit.com
+ *
+ * @brief  Build a minimal perfect hash of a static key set, search key by it.
+ */
+
+#include "Hash.h"
+#include "../NormalHash/HashMethodInline.h"
+
+#define PERFECT_HASH_SEED 0x6a09e667f3bcc909ULL   ///< Seed of first build.
+#define PERFECT_HASH_SEED_STEP 0x9E3779B97F4A7C15ULL ///< Added to seed before each retry.
+#define PILOT_MULTIPLIER 0xbf58476d1ce4e5b9ULL     ///< Spreads 16 bits pilot over 64 bits.
+#define DENSE_KEY_LIMIT 0x9999999AU                ///< 60% of 2^32, keys with high hash half below go dense.
+#define DENSE_BUCKET_PERCENT 30                    ///< Part of buckets which are dense.
+
+//! Result of one build with one seed.
+enum
+{
+	BUILD_DONE,
+	BUILD_RETRY,          ///< Seed does not work, try another.
+	BUILD_NO_MEMORY,
+};
+
+/**
+ * @brief Working memory of a build, kept over retries with other seeds.
+ */
+typedef struct BuildContext
+{
+	unsigned int nKeys;            ///< Number of keys given, duplicated ones included.
+	const void **pKeys;
+	const size_t *pLens;
+	unsigned long long *hashes;    ///< Hash of each key.
+	unsigned int *order;           ///< Keys sorted by bucket.
+	unsigned int *bucketStart;     ///< First key of each bucket in order, and one after the last.
+	unsigned int *bucketSize;      ///< Keys in each bucket, duplicated keys taken out.
+	unsigned int *bucketOrder;     ///< Buckets, biggest first.
+}BuildContext;
+
+// Bucket of a key, 60% of keys go into first 30% of buckets.
+static inline unsigned int BucketOf(const HashInf *pHashInf, unsigned long long nHash)
+{
+	unsigned long long nLow = (unsigned int)nHash;
+
+	if ((unsigned int)(nHash >> 32) < DENSE_KEY_LIMIT)
+	{
+		return (unsigned int)((nLow * pHashInf->nDenseBucketNum) >> 32);
+	}
+	return pHashInf->nDenseBucketNum
+			+ (unsigned int)((nLow * (pHashInf->nBucketNum - pHashInf->nDenseBucketNum)) >> 32);
+}
+
+// Position a key lands on with a pilot, before remap.
+static inline unsigned int PositionOf(unsigned long long nHash, unsigned int nPilot, unsigned int nTableSize)
+{
+	unsigned long long x = HashMum(nHash ^ (nPilot * PILOT_MULTIPLIER), WORD_HASH_P3);
+	return (unsigned int)(((unsigned __int128)x * nTableSize) >> 64);
+}
+
+// 32 bits check of a key, from other bits than bucket and position.
+static inline unsigned int KeyCheck(unsigned long long nHash)
+{
+	return (unsigned int)HashMum(nHash ^ WORD_HASH_P1, WORD_HASH_P0);
+}
+
+// Index of a key, hash information must have at least one key.
+static inline unsigned int IndexOf(const HashInf *pHashInf, unsigned long long nHash)
+{
+	unsigned int nPos = PositionOf(nHash, pHashInf->pPilots[BucketOf(pHashInf, nHash)], pHashInf->nTableSize);
+	return (nPos < pHashInf->nItemNum) ? nPos : pHashInf->pRemap[nPos - pHashInf->nItemNum];
+}
+
+/**
+ * @brief Check a key is the one at it's index.
+ *
+ * @return Index, or -1 if another key is there. With keys dropped only fingerprints are compared.
+ */
+static inline int MatchIndex(const HashInf *pHashInf, unsigned long long nHash, unsigned int nIndex,
+		const void *key, size_t len)
+{
+	unsigned int nCheck = KeyCheck(nHash);
+	const PerfectSlot *pSlot;
+
+	if (IS_NULL(pHashInf->pSlots))
+	{
+		return ((unsigned char)nCheck == pHashInf->pFingerprints[nIndex]) ? (int)nIndex : -1;
+	}
+	pSlot = &pHashInf->pSlots[nIndex];
+	return ((nCheck == pSlot->HashKey) && IS_SAME_KEY(key, len, pSlot->item, pSlot->nKeyLen)) ? (int)nIndex : -1;
+}
+
+static inline bool_t IsTaken(const unsigned long long *taken, unsigned int nPos)
+{
+	return (taken[nPos / 64] >> (nPos % 64)) & 1;
+}
+
+static inline void FlipTaken(unsigned long long *taken, unsigned int nPos)
+{
+	taken[nPos / 64] ^= 1ULL << (nPos % 64);
+}
+
+/**
+ * @brief Free tables of a failed build, hash information can be built again.
+ */
+static void FreeTables(HashInf *pHashInf)
+{
+	SECURE_FREE(pHashInf->pPilots);
+	SECURE_FREE(pHashInf->pRemap);
+	SECURE_FREE(pHashInf->pSlots);
+	SECURE_FREE(pHashInf->pFingerprints);
+	pHashInf->nItemNum = 0;
+	pHashInf->nTableSize = 0;
+}
+
+static void FreeContext(BuildContext *pContext)
+{
+	SECURE_FREE(pContext->hashes);
+	SECURE_FREE(pContext->order);
+	SECURE_FREE(pContext->bucketStart);
+	SECURE_FREE(pContext->bucketSize);
+	SECURE_FREE(pContext->bucketOrder);
+}
+
+static int InitContext(BuildContext *pContext, unsigned int nKeys, const void **pKeys, const size_t *pLens,
+		unsigned int nBucketNum)
+{
+	pContext->nKeys = nKeys;
+	pContext->pKeys = pKeys;
+	pContext->pLens = pLens;
+	pContext->hashes = MALLOC(unsigned long long, nKeys + 1);
+	pContext->order = MALLOC(unsigned int, nKeys + 1);
+	pContext->bucketStart = MALLOC(unsigned int, nBucketNum + 1);
+	pContext->bucketSize = MALLOC(unsigned int, nBucketNum);
+	pContext->bucketOrder = MALLOC(unsigned int, nBucketNum);
+	if (IS_NULL(pContext->hashes) || IS_NULL(pContext->order) || IS_NULL(pContext->bucketStart)
+			|| IS_NULL(pContext->bucketSize) || IS_NULL(pContext->bucketOrder))
+	{
+		FreeContext(pContext);
+		return FAILED;
+	}
+	return SUCCEED;
+}
+
+/**
+ * @brief Hash keys with seed of hash information, put them into buckets, take out duplicated keys.
+ *
+ *   Same key given more than once has the same hash, the first one given is kept. Different keys with the
+ * same 64 bits hash can never be told apart by a pilot, the seed must change.
+ *
+ * @return Number of different keys, or -1 if seed does not work.
+ */
+static int FillBuckets(const HashInf *pHashInf, BuildContext *pContext)
+{
+	unsigned int nBucketNum = pHashInf->nBucketNum;
+	unsigned int *cursor = pContext->bucketOrder;
+	int nUnique = 0;
+
+	memset(pContext->bucketSize, 0, sizeof(unsigned int) * nBucketNum);
+	for (unsigned int i=0; i<pContext->nKeys; ++i)
+	{
+		pContext->hashes[i] = WordHash64(pContext->pKeys[i], pContext->pLens[i], pHashInf->nSeed);
+		++pContext->bucketSize[BucketOf(pHashInf, pContext->hashes[i])];
+	}
+	pContext->bucketStart[0] = 0;
+	for (unsigned int b=0; b<nBucketNum; ++b)
+	{
+		cursor[b] = pContext->bucketStart[b];
+		pContext->bucketStart[b+1] = pContext->bucketStart[b] + pContext->bucketSize[b];
+	}
+	for (unsigned int i=0; i<pContext->nKeys; ++i)
+	{
+		pContext->order[cursor[BucketOf(pHashInf, pContext->hashes[i])]++] = i;
+	}
+
+	for (unsigned int b=0; b<nBucketNum; ++b)
+	{
+		unsigned int *keys = pContext->order + pContext->bucketStart[b];
+		unsigned int nSize = pContext->bucketSize[b];
+
+		for (unsigned int i=1; i<nSize; )
+		{
+			unsigned int j = 0;
+			while ((j < i) && (pContext->hashes[keys[j]] != pContext->hashes[keys[i]]))
+			{
+				++j;
+			}
+			if (j == i)
+			{
+				++i;
+				continue;
+			}
+			if (!IS_SAME_KEY(pContext->pKeys[keys[i]], pContext->pLens[keys[i]],
+					pContext->pKeys[keys[j]], pContext->pLens[keys[j]]))
+			{
+				return -1;
+			}
+			memmove(&keys[i], &keys[i+1], sizeof(unsigned int) * (nSize - i - 1));
+			--nSize;
+		}
+		pContext->bucketSize[b] = nSize;
+		nUnique += nSize;
+	}
+	return nUnique;
+}
+
+/**
+ * @brief Sort buckets by size, biggest first, into bucketOrder.
+ *
+ * @return SUCCEED, or FAILED if no memory.
+ */
+static int SortBuckets(const HashInf *pHashInf, BuildContext *pContext)
+{
+	unsigned int nMaxSize = 0;
+	unsigned int *sizeStart;
+
+	for (unsigned int b=0; b<pHashInf->nBucketNum; ++b)
+	{
+		nMaxSize = MAX(nMaxSize, pContext->bucketSize[b]);
+	}
+	sizeStart = (unsigned int *)calloc(nMaxSize + 2, sizeof(unsigned int));
+	if (IS_NULL(sizeStart))
+	{
+		return FAILED;
+	}
+	// Count buckets of each size, then first place of each size with the biggest size at 0.
+	for (unsigned int b=0; b<pHashInf->nBucketNum; ++b)
+	{
+		++sizeStart[nMaxSize - pContext->bucketSize[b] + 1];
+	}
+	for (unsigned int s=1; s<=nMaxSize+1; ++s)
+	{
+		sizeStart[s] += sizeStart[s-1];
+	}
+	for (unsigned int b=0; b<pHashInf->nBucketNum; ++b)
+	{
+		pContext->bucketOrder[sizeStart[nMaxSize - pContext->bucketSize[b]]++] = b;
+	}
+	FREE(sizeStart);
+	return SUCCEED;
+}
+
+/**
+ * @brief Find a pilot for each bucket, biggest bucket first.
+ *
+ *   A pilot is taken when all keys of the bucket land on positions no other key took, a bucket whose keys
+ * collide with each other tries the next pilot as well.
+ *
+ * @return BUILD_DONE, BUILD_RETRY if a bucket finds no pilot, or BUILD_NO_MEMORY.
+ */
+static int SearchPilots(HashInf *pHashInf, BuildContext *pContext)
+{
+	unsigned int nTableSize = pHashInf->nTableSize;
+	unsigned long long *taken = (unsigned long long *)calloc(nTableSize / 64 + 1, sizeof(unsigned long long));
+	unsigned int *positions = MALLOC(unsigned int, pContext->bucketSize[pContext->bucketOrder[0]] + 1);
+	int ret = BUILD_DONE;
+
+	if (IS_NULL(taken) || IS_NULL(positions))
+	{
+		SECURE_FREE(taken);
+		SECURE_FREE(positions);
+		return BUILD_NO_MEMORY;
+	}
+	memset(pHashInf->pPilots, 0, sizeof(unsigned short) * pHashInf->nBucketNum);
+	for (unsigned int i=0; (i<pHashInf->nBucketNum) && (BUILD_DONE == ret); ++i)
+	{
+		unsigned int b = pContext->bucketOrder[i];
+		unsigned int nSize = pContext->bucketSize[b];
+		const unsigned int *keys = pContext->order + pContext->bucketStart[b];
+		unsigned int nPilot;
+
+		if (0 == nSize)
+		{
+			break;
+		}
+		for (nPilot=0; nPilot<=PERFECT_HASH_MAX_PILOT; ++nPilot)
+		{
+			unsigned int k = 0;
+			while (k < nSize)
+			{
+				positions[k] = PositionOf(pContext->hashes[keys[k]], nPilot, nTableSize);
+				if (IsTaken(taken, positions[k]))
+				{
+					break;
+				}
+				FlipTaken(taken, positions[k++]);
+			}
+			if (k == nSize)
+			{
+				break;
+			}
+			// Give back positions taken by this pilot.
+			while (k-- > 0)
+			{
+				FlipTaken(taken, positions[k]);
+			}
+		}
+		if (nPilot > PERFECT_HASH_MAX_PILOT)
+		{
+			ret = BUILD_RETRY;
+			break;
+		}
+		pHashInf->pPilots[b] = (unsigned short)nPilot;
+	}
+
+	// Keys landing at or after nItemNum move into free positions below it, in order. Keys not in set can
+	// land on a position no key took, it still gives an index, where the key check rejects them.
+	if (BUILD_DONE == ret)
+	{
+		unsigned int nFree = 0;
+		for (unsigned int nPos=pHashInf->nItemNum; nPos<nTableSize; ++nPos)
+		{
+			pHashInf->pRemap[nPos - pHashInf->nItemNum] = 0;
+			if (IsTaken(taken, nPos))
+			{
+				while (IsTaken(taken, nFree))
+				{
+					++nFree;
+				}
+				pHashInf->pRemap[nPos - pHashInf->nItemNum] = nFree++;
+			}
+		}
+	}
+	FREE(taken);
+	FREE(positions);
+	return ret;
+}
+
+/**
+ * @brief Build hash information with it's current seed.
+ *
+ * @return BUILD_DONE, BUILD_RETRY if seed does not work, or BUILD_NO_MEMORY.
+ */
+static int BuildOnce(HashInf *pHashInf, BuildContext *pContext)
+{
+	int nUnique = FillBuckets(pHashInf, pContext);
+	int ret;
+
+	if (nUnique < 0)
+	{
+		return BUILD_RETRY;
+	}
+	pHashInf->nItemNum = nUnique;
+	pHashInf->nTableSize = (unsigned int)(((unsigned long long)nUnique * 100 + PERFECT_HASH_LOAD_PERCENT - 1)
+			/ PERFECT_HASH_LOAD_PERCENT);
+	pHashInf->pPilots = MALLOC(unsigned short, pHashInf->nBucketNum);
+	pHashInf->pRemap = MALLOC(unsigned int, pHashInf->nTableSize - nUnique + 1);
+	if (pHashInf->flags & PERFECT_HASH_DROP_KEYS)
+	{
+		pHashInf->pFingerprints = MALLOC(unsigned char, nUnique + 1);
+	}
+	else
+	{
+		pHashInf->pSlots = MALLOC(PerfectSlot, nUnique + 1);
+	}
+	if (IS_NULL(pHashInf->pPilots) || IS_NULL(pHashInf->pRemap)
+			|| (IS_NULL(pHashInf->pFingerprints) && IS_NULL(pHashInf->pSlots))
+			|| (FAILED == SortBuckets(pHashInf, pContext)))
+	{
+		return BUILD_NO_MEMORY;
+	}
+	if (BUILD_DONE != (ret = SearchPilots(pHashInf, pContext)))
+	{
+		return ret;
+	}
+
+	for (unsigned int b=0; b<pHashInf->nBucketNum; ++b)
+	{
+		const unsigned int *keys = pContext->order + pContext->bucketStart[b];
+		for (unsigned int k=0; k<pContext->bucketSize[b]; ++k)
+		{
+			unsigned long long nHash = pContext->hashes[keys[k]];
+			unsigned int nIndex = IndexOf(pHashInf, nHash);
+
+			if (IS_NOT_NULL(pHashInf->pFingerprints))
+			{
+				pHashInf->pFingerprints[nIndex] = (unsigned char)KeyCheck(nHash);
+				continue;
+			}
+			pHashInf->pSlots[nIndex].HashKey = KeyCheck(nHash);
+			pHashInf->pSlots[nIndex].nKeyLen = (unsigned int)pContext->pLens[keys[k]];
+			pHashInf->pSlots[nIndex].item = (void *)pContext->pKeys[keys[k]];
+		}
+	}
+	return BUILD_DONE;
+}
+
+/**
+ * @brief Check keys against hash information, see VerifyHashInf().
+ */
+static int VerifyKeys(HashInf *pHashInf, int itemNum, const void **pKeys, const size_t *pLens)
+{
+	int *owner;
+	unsigned int nTaken = 0;
+	int ret = SUCCEED;
+
+	if (0 == pHashInf->nItemNum)
+	{
+		return (itemNum <= 0) ? SUCCEED : FAILED;
+	}
+	owner = MALLOC(int, pHashInf->nItemNum);
+	if (IS_NULL(owner))
+	{
+		return FAILED;
+	}
+	memset(owner, 0xFF, sizeof(int) * pHashInf->nItemNum);
+	for (int i=0; (i<itemNum) && (SUCCEED == ret); ++i)
+	{
+		unsigned long long nHash = WordHash64(pKeys[i], pLens[i], pHashInf->nSeed);
+		unsigned int nIndex = IndexOf(pHashInf, nHash);
+
+		if ((nIndex >= pHashInf->nItemNum) || ((int)nIndex != MatchIndex(pHashInf, nHash, nIndex, pKeys[i], pLens[i])))
+		{
+			ret = FAILED;
+		}
+		else if (owner[nIndex] < 0)
+		{
+			owner[nIndex] = i;
+			++nTaken;
+		}
+		else if (!IS_SAME_KEY(pKeys[i], pLens[i], pKeys[owner[nIndex]], pLens[owner[nIndex]]))
+		{
+			ret = FAILED;
+		}
+	}
+	FREE(owner);
+	return ((SUCCEED == ret) && (nTaken == pHashInf->nItemNum)) ? SUCCEED : FAILED;
+}
+
+/**
+ * @brief Length of each string in array.
+ *
+ * @return Lengths, free them after use, or NULL if no memory.
+ */
+static size_t *StringLengths(int itemNum, char **pArray)
+{
+	size_t *pLens = MALLOC(size_t, MAX(itemNum, 0) + 1);
+
+	for (int i=0; IS_NOT_NULL(pLens) && (i<itemNum); ++i)
+	{
+		pLens[i] = strlen(pArray[i]);
+	}
+	return pLens;
+}
+
+/**
+ * @brief Create hash information from a array.
+ *
+ * @param itemNum Number of items in array.
+ * @param pArray Pointer pointed to array which will create hash information, strings are not copied.
+ * @return Pointer to created hash information, or NULL if no memory or no seed works.
+ */
+HashInf *HashFromArray(int itemNum, char **pArray)
+{
+	return HashFromArrayEx(itemNum, pArray, PERFECT_HASH_KEEP_KEYS);
+}
+
+/**
+ * @brief Create hash information from a array, choose whether to keep strings.
+ *
+ * @param itemNum Number of items in array.
+ * @param pArray Pointer pointed to array which will create hash information, strings are not copied.
+ * @param flags PERFECT_HASH_KEEP_KEYS or PERFECT_HASH_DROP_KEYS, or'ed with PERFECT_HASH_VERIFY.
+ * @return Pointer to created hash information, or NULL if no memory, no seed works or verify failed.
+ */
+HashInf *HashFromArrayEx(int itemNum, char **pArray, unsigned int flags)
+{
+	size_t *pLens = StringLengths(itemNum, pArray);
+	HashInf *pHashInf;
+
+	if (IS_NULL(pLens))
+	{
+		return NULL;
+	}
+	pHashInf = HashFromKeys(itemNum, (const void **)pArray, pLens, flags);
+	FREE(pLens);
+	return pHashInf;
+}
+
+/**
+ * @brief Create hash information from keys with known length, keys need no terminating '\0'.
+ *
+ * @param itemNum Number of keys.
+ * @param pKeys Address of each key, saved in hash table as it is, not copied.
+ * @param pLens Length of each key.
+ * @param flags PERFECT_HASH_KEEP_KEYS or PERFECT_HASH_DROP_KEYS, or'ed with PERFECT_HASH_VERIFY.
+ * @return Pointer to created hash information, or NULL if no memory, no seed works or verify failed.
+ */
+HashInf *HashFromKeys(int itemNum, const void **pKeys, const size_t *pLens, unsigned int flags)
+{
+	HashInf *pHashInf = (HashInf *)calloc(1, sizeof(HashInf));
+	BuildContext context;
+	int ret = BUILD_RETRY;
+
+	if (IS_NULL(pHashInf))
+	{
+		return NULL;
+	}
+	itemNum = MAX(itemNum, 0);
+	pHashInf->flags = flags;
+	pHashInf->nBucketNum = MAX((unsigned int)(itemNum + PERFECT_HASH_KEYS_PER_BUCKET - 1)
+			/ PERFECT_HASH_KEYS_PER_BUCKET, 1U);
+	pHashInf->nDenseBucketNum = (unsigned int)((unsigned long long)pHashInf->nBucketNum
+			* DENSE_BUCKET_PERCENT / 100);
+	if (FAILED == InitContext(&context, itemNum, pKeys, pLens, pHashInf->nBucketNum))
+	{
+		FREE(pHashInf);
+		return NULL;
+	}
+
+	for (int nTry=0; (BUILD_RETRY == ret) && (nTry < PERFECT_HASH_MAX_SEEDS); ++nTry)
+	{
+		FreeTables(pHashInf);
+		pHashInf->nSeed = PERFECT_HASH_SEED + nTry * PERFECT_HASH_SEED_STEP;
+		ret = BuildOnce(pHashInf, &context);
+	}
+	FreeContext(&context);
+
+	if ((BUILD_DONE != ret) || ((flags & PERFECT_HASH_VERIFY)
+			&& (FAILED == VerifyKeys(pHashInf, itemNum, pKeys, pLens))))
+	{
+		DeleteHashInf(&pHashInf);
+	}
+	return pHashInf;
+}
+
+/**
+ * @brief Check hash information is a minimal perfect hash of strings it was built from.
+ *
+ * @param pHashInf Which hash information to check.
+ * @param itemNum Number of items in array.
+ * @param pArray Array hash information was built from.
+ * @return SUCCEED, or FAILED if any check fails.
+ */
+int VerifyHashInf(HashInf *pHashInf, int itemNum, char **pArray)
+{
+	size_t *pLens = StringLengths(itemNum, pArray);
+	int ret;
+
+	if (IS_NULL(pLens))
+	{
+		return FAILED;
+	}
+	ret = VerifyKeys(pHashInf, itemNum, (const void **)pArray, pLens);
+	FREE(pLens);
+	return ret;
+}
+
+/**
+ * @brief Delete created hash information.
+ *
+ * @param pHashInf Pointer to which hash information you want to delete.
+ */
+void DeleteHashInf(HashInf **pHashInf)
+{
+	if (IS_NULL(pHashInf) || IS_NULL(*pHashInf))
+	{
+		return;
+	}
+	FreeTables(*pHashInf);
+	FREE(*pHashInf);
+}
+
+/**
+ * @brief Get index of a key with known length.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param key Which key you want to find.
+ * @param len Length of key.
+ * @return Index between 0 and nItemNum-1, or -1 if key is not in set.
+ */
+int GetKeyIndex(HashInf *pHashInf, const void *key, size_t len)
+{
+	unsigned long long nHash;
+
+	if (0 == pHashInf->nItemNum)
+	{
+		return -1;
+	}
+	nHash = WordHash64(key, len, pHashInf->nSeed);
+	return MatchIndex(pHashInf, nHash, IndexOf(pHashInf, nHash), key, len);
+}
+
+/**
+ * @brief Get index of a string, index of a key never changes while hash information lives.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param str Which string you want to find.
+ * @return Index between 0 and nItemNum-1, or -1 if string is not in set.
+ */
+int GetStringIndex(HashInf *pHashInf, const char *str)
+{
+	return GetKeyIndex(pHashInf, str, strlen(str));
+}
+
+/**
+ * @brief Get real key address, key has known length and needs no terminating '\0'.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param key Which key you want to find.
+ * @param len Length of key.
+ * @return Real key address, or NULL if not found or keys are dropped.
+ */
+void *GetKeyAddress(HashInf *pHashInf, const void *key, size_t len)
+{
+	int nIndex;
+
+	if (IS_NULL(pHashInf->pSlots))
+	{
+		return NULL;
+	}
+	nIndex = GetKeyIndex(pHashInf, key, len);
+	return (nIndex >= 0) ? pHashInf->pSlots[nIndex].item : NULL;
+}
+
+/**
+ * @brief Get real string address, the string must be in array which created hash information.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param str Which string you want to find.
+ * @return Real string address, or NULL if not found or keys are dropped.
+ */
+void *GetStringAddress(HashInf *pHashInf, const char *str)
+{
+	return GetKeyAddress(pHashInf, str, strlen(str));
+}
+
+/**
+ * @brief Get real string address of many strings at once.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param keys Strings you want to find.
+ * @param n Number of strings.
+ * @param out Save real string address of each string, NULL if not found or keys are dropped.
+ */
+void GetStringAddressBatch(HashInf *pHashInf, const char **keys, size_t n, void **out)
+{
+	unsigned long long nHash[BATCH_GROUP_SIZE];
+	unsigned int nIndex[BATCH_GROUP_SIZE];
+	size_t nLen[BATCH_GROUP_SIZE];
+
+	if (IS_NULL(pHashInf->pSlots) || (0 == pHashInf->nItemNum))
+	{
+		memset(out, 0, sizeof(void *) * n);
+		return;
+	}
+	for (size_t nStart=0; nStart<n; nStart+=BATCH_GROUP_SIZE)
+	{
+		size_t nGroup = MIN(n - nStart, (size_t)BATCH_GROUP_SIZE);
+
+		// Hash whole group, ask for each pilot.
+		for (size_t i=0; i<nGroup; ++i)
+		{
+			nLen[i] = strlen(keys[nStart+i]);
+			nHash[i] = WordHash64(keys[nStart+i], nLen[i], pHashInf->nSeed);
+			PREFETCH(&pHashInf->pPilots[BucketOf(pHashInf, nHash[i])]);
+		}
+
+		// Pilots are on the way or in cache, ask for each slot.
+		for (size_t i=0; i<nGroup; ++i)
+		{
+			nIndex[i] = IndexOf(pHashInf, nHash[i]);
+			PREFETCH(&pHashInf->pSlots[nIndex[i]]);
+		}
+
+		for (size_t i=0; i<nGroup; ++i)
+		{
+			int nFound = MatchIndex(pHashInf, nHash[i], nIndex[i], keys[nStart+i], nLen[i]);
+			out[nStart+i] = (nFound >= 0) ? pHashInf->pSlots[nFound].item : NULL;
+		}
+	}
+}
@@ -0,0 +1,191 @@
+/**
+ * @file   PerfectHash/Hash.h
+ *
+ * @date   Oct 16, 2026
+ * @author WangLiang
+ * @email  liang.wang@elektrobit.com
+ *
+ * @brief  Minimal perfect hash of a static key set, each key gets it's own index, one probe per lookup.
+ *
+ *   Built the PTHash way. Each key is hashed once by WordHash64() and thrown into a small bucket, 60% of
+ * keys into 30% of buckets, so big buckets are placed while positions are still free. Then buckets, the
+ * biggest first, each search a pilot, a 16 bits number mixed into position hash of their keys, until all
+ * keys of the bucket land on free positions. Positions are PERFECT_HASH_LOAD_PERCENT% used, that keeps
+ * pilots small, and keys landing at or after nItemNum are moved into the holes below it by a remap table.
+ *
+ *   Lookup hashes the key, reads the pilot of it's bucket and gets the index, no probe sequence and no
+ * collision. Metadata is 16 / PERFECT_HASH_KEYS_PER_BUCKET bits of pilot and less than one bit of remap
+ * for each key. Key set can not change after build, build again to add or remove keys.
+ */
+
+#ifndef HASH_H_
+#define HASH_H_
+
+#include "../CProjectDfn.h"
+
+/**
+ * @brief Build flags.
+ */
+#define PERFECT_HASH_KEEP_KEYS 0x00   ///< Keep address, length and 32 bits check of each key, keys not in set
+                                      ///< are found not in set.
+#define PERFECT_HASH_DROP_KEYS 0x01   ///< Keep only an 8 bits fingerprint of each key, lookups give index but
+                                      ///< no address, 1 of 256 keys not in set gets the index of another key.
+#define PERFECT_HASH_VERIFY 0x02      ///< Check every key after build, see VerifyHashInf().
+
+/**
+ * @brief Average number of keys in a bucket, each bucket has a 16 bits pilot.
+ */
+#define PERFECT_HASH_KEYS_PER_BUCKET 4
+
+/**
+ * @brief Part of positions keys land on, the rest makes pilot search of last buckets short.
+ */
+#define PERFECT_HASH_LOAD_PERCENT 98
+
+/**
+ * @brief Largest pilot, a bucket which finds no pilot up to it restarts the build with another seed.
+ */
+#define PERFECT_HASH_MAX_PILOT 65535
+
+/**
+ * @brief Seeds tried before build gives up.
+ */
+#define PERFECT_HASH_MAX_SEEDS 16
+
+/**
+ * @brief Number of strings hashed and prefetched together by GetStringAddressBatch().
+ */
+#define BATCH_GROUP_SIZE 16
+
+/**
+ * @brief Key of one index, kept when built with PERFECT_HASH_KEEP_KEYS.
+ */
+typedef struct PerfectSlot
+{
+	unsigned int HashKey;      ///< 32 bits check from hash of key, compared before key bytes.
+	unsigned int nKeyLen;      ///< Length of key, keys must be shorter than 4 GB.
+	void *item;                ///< Address of key, as it was given to build.
+}PerfectSlot;
+
+/**
+ * @brief Hash information, pilots of buckets and keys of each index.
+ */
+typedef struct HashTableInf
+{
+	unsigned long long nSeed;           ///< Seed of key hash, the one build succeeded with.
+	unsigned int nItemNum;              ///< Number of different keys, indexes are 0 to nItemNum-1.
+	unsigned int nTableSize;            ///< Positions keys land on before remap, a bit more than nItemNum.
+	unsigned int nBucketNum;            ///< Number of buckets, one pilot each.
+	unsigned int nDenseBucketNum;       ///< First buckets which take 60% of keys.
+	unsigned int flags;                 ///< PERFECT_HASH_* build flags.
+	unsigned short *pPilots;            ///< Pilot of each bucket.
+	unsigned int *pRemap;               ///< Index of keys landing on position nItemNum + i.
+	PerfectSlot *pSlots;                ///< Key of each index, NULL if keys are dropped.
+	unsigned char *pFingerprints;       ///< Fingerprint of key of each index, NULL if keys are kept.
+}HashInf;
+
+/**
+ * @brief Create hash information from a array.
+ *
+ * @param itemNum Number of items in array.
+ * @param pArray Pointer pointed to array which will create hash information, strings are not copied.
+ * @return Pointer to created hash information, or NULL if no memory or no seed works.
+ */
+HashInf *HashFromArray(int itemNum, char **pArray);
+
+/**
+ * @brief Create hash information from a array, choose whether to keep strings.
+ *
+ * @param itemNum Number of items in array.
+ * @param pArray Pointer pointed to array which will create hash information, strings are not copied.
+ * @param flags PERFECT_HASH_KEEP_KEYS or PERFECT_HASH_DROP_KEYS, or'ed with PERFECT_HASH_VERIFY.
+ * @return Pointer to created hash information, or NULL if no memory, no seed works or verify failed.
+ */
+HashInf *HashFromArrayEx(int itemNum, char **pArray, unsigned int flags);
+
+/**
+ * @brief Create hash information from keys with known length, keys need no terminating '\0'.
+ *
+ *   Same key given more than once gets one index, nItemNum counts different keys only.
+ *
+ * @param itemNum Number of keys.
+ * @param pKeys Address of each key, saved in hash table as it is, not copied.
+ * @param pLens Length of each key.
+ * @param flags PERFECT_HASH_KEEP_KEYS or PERFECT_HASH_DROP_KEYS, or'ed with PERFECT_HASH_VERIFY.
+ * @return Pointer to created hash information, or NULL if no memory, no seed works or verify failed.
+ */
+HashInf *HashFromKeys(int itemNum, const void **pKeys, const size_t *pLens, unsigned int flags);
+
+/**
+ * @brief Check hash information is a minimal perfect hash of strings it was built from.
+ *
+ *   Every string must get an index below nItemNum, different strings different indexes, and all indexes
+ * must be taken. With keys kept, every string must also be found at it's index.
+ *
+ * @param pHashInf Which hash information to check.
+ * @param itemNum Number of items in array.
+ * @param pArray Array hash information was built from.
+ * @return SUCCEED, or FAILED if any check fails.
+ */
+int VerifyHashInf(HashInf *pHashInf, int itemNum, char **pArray);
+
+/**
+ * @brief Delete created hash information.
+ *
+ * @param pHashInf Pointer to which hash information you want to delete.
+ */
+void DeleteHashInf(HashInf **pHashInf);
+
+/**
+ * @brief Get index of a string, index of a key never changes while hash information lives.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param str Which string you want to find.
+ * @return Index between 0 and nItemNum-1, or -1 if string is not in set. With keys dropped a string not in
+ *         set can get the index of another one.
+ */
+int GetStringIndex(HashInf *pHashInf, const char *str);
+
+/**
+ * @brief Get index of a key with known length.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param key Which key you want to find.
+ * @param len Length of key.
+ * @return Index between 0 and nItemNum-1, or -1 if key is not in set.
+ */
+int GetKeyIndex(HashInf *pHashInf, const void *key, size_t len);
+
+/**
+ * @brief Get real string address, the string must be in array which created hash information.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param str Which string you want to find.
+ * @return Real string address, or NULL if not found or keys are dropped.
+ */
+void *GetStringAddress(HashInf *pHashInf, const char *str);
+
+/**
+ * @brief Get real key address, key has known length and needs no terminating '\0'.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param key Which key you want to find.
+ * @param len Length of key.
+ * @return Real key address, or NULL if not found or keys are dropped.
+ */
+void *GetKeyAddress(HashInf *pHashInf, const void *key, size_t len);
+
+/**
+ * @brief Get real string address of many strings at once.
+ *
+ *   Strings are handled in groups of BATCH_GROUP_SIZE, pilots of a whole group are prefetched, then slots
+ * of a whole group, so cache misses of the group overlap.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param keys Strings you want to find.
+ * @param n Number of strings.
+ * @param out Save real string address of each string, NULL if not found or keys are dropped.
+ */
+void GetStringAddressBatch(HashInf *pHashInf, const char **keys, size_t n, void **out);
+
+#endif /* HASH_H_ */
@@ -0,0 +1,153 @@
+/**
+ * @file   StringPool.h
+ *
+ * @date   Oct 16, 2026
+ * @author WangLiang
+ * @email  liang.wang@elektrobit.com
+ *
+ * @brief  Copies of keys packed into large blocks owned by a hash information, shared by MPQHash and NormalHash.
+ *
+ * Data structure:
+ *
+ * +------------+      +------+-----+------------+-----+------------+----
+ * | StringPool | -->  | next | len | bytes '\0' | len | bytes '\0' | ...      --> older block --> NULL
+ * +------------+      +------+-----+------------+-----+------------+----
+ *                      newest block                                 ^ pNext
+ *
+ *   Each key is copied after a 4 bytes length and followed by '\0', so a copy is used as string as well.
+ * Entries are rounded up to 4 bytes, length of next entry stays aligned. Copies never move, they are
+ * only released all together by StringPoolDestroy(), a removed key keeps it's bytes until then.
+ */
+
+#ifndef STRINGPOOL_H_
+#define STRINGPOOL_H_
+
+#include "CProjectDfn.h"
+
+/**
+ * @brief Min bytes of a block, bigger blocks are allocated for a reserve or a long key.
+ */
+#define STRING_POOL_BLOCK_SIZE (64 * 1024)
+
+/**
+ * @brief Header of each block, entries follow it.
+ */
+typedef union StringPoolBlock
+{
+	union StringPoolBlock *next;  ///< Older block.
+	long double align;            ///< Keep entries after header aligned.
+}StringPoolBlock;
+
+/**
+ * @brief String pool information.
+ */
+typedef struct StringPool
+{
+	StringPoolBlock *pBlocks;     ///< Allocated blocks, newest first.
+	char *pNext;                  ///< Next unused byte in newest block.
+	char *pEnd;                   ///< End of newest block.
+}StringPool;
+
+/**
+ * @brief Bytes an entry of a key takes in pool.
+ * @param len Length of key.
+ * @return Bytes of length, key, '\0' and padding.
+ */
+static inline size_t StringPoolEntrySize(size_t len)
+{
+	return (sizeof(unsigned int) + len + 1 + sizeof(unsigned int) - 1) / sizeof(unsigned int) * sizeof(unsigned int);
+}
+
+/**
+ * @brief Initialize a string pool, no memory is allocated until first copy.
+ * @param pPool Which pool to initialize.
+ */
+static inline void StringPoolInit(StringPool *pPool)
+{
+	pPool->pBlocks = NULL;
+	pPool->pNext = NULL;
+	pPool->pEnd = NULL;
+}
+
+/**
+ * @brief Make sure next nBytes of entries go into one block, so they are contiguous.
+ *
+ * @param pPool Which pool to reserve in.
+ * @param nBytes Bytes of entries, sum of StringPoolEntrySize().
+ * @return SUCCEED, or FAILED if no memory.
+ */
+static inline int StringPoolReserve(StringPool *pPool, size_t nBytes)
+{
+	if ((size_t)(pPool->pEnd - pPool->pNext) >= nBytes)
+	{
+		return SUCCEED;
+	}
+
+	// Rest of newest block is left unused.
+	nBytes = MAX(nBytes, (size_t)STRING_POOL_BLOCK_SIZE);
+	StringPoolBlock *pBlock = (StringPoolBlock *)malloc(sizeof(StringPoolBlock) + nBytes);
+	if (IS_NULL(pBlock))
+	{
+		return FAILED;
+	}
+	pBlock->next = pPool->pBlocks;
+	pPool->pBlocks = pBlock;
+	pPool->pNext = (char *)(pBlock + 1);
+	pPool->pEnd = pPool->pNext + nBytes;
+	return SUCCEED;
+}
+
+/**
+ * @brief Copy a key into pool.
+ *
+ * @param pPool Which pool to copy into.
+ * @param key Key to copy, need no terminating '\0'.
+ * @param len Length of key, less than 4G.
+ * @return Address of copy, followed by '\0', or NULL if no memory.
+ */
+static inline char *StringPoolAdd(StringPool *pPool, const void *key, size_t len)
+{
+	size_t nSize = StringPoolEntrySize(len);
+	char *pCopy;
+
+	if (FAILED == StringPoolReserve(pPool, nSize))
+	{
+		return NULL;
+	}
+	*(unsigned int *)pPool->pNext = (unsigned int)len;
+	pCopy = pPool->pNext + sizeof(unsigned int);
+	memcpy(pCopy, key, len);
+	pCopy[len] = '\0';
+	pPool->pNext += nSize;
+	return pCopy;
+}
+
+/**
+ * @brief Get length of a copy in pool, read from length before it.
+ * @param pCopy Address returned by StringPoolAdd().
+ * @return Length of key.
+ */
+static inline size_t StringPoolKeyLen(const char *pCopy)
+{
+	return *(const unsigned int *)(pCopy - sizeof(unsigned int));
+}
+
+/**
+ * @brief Release every copy in pool, one free for each block.
+ * @param pPool Which pool to release.
+ */
+static inline void StringPoolDestroy(StringPool *pPool)
+{
+	StringPoolBlock *pBlock = pPool->pBlocks;
+	StringPoolBlock *pNextBlock;
+
+	while (IS_NOT_NULL(pBlock))
+	{
+		pNextBlock = pBlock->next;
+		FREE(pBlock);
+		pBlock = pNextBlock;
+	}
+	StringPoolInit(pPool);
+}
+
+#endif /* STRINGPOOL_H_ */
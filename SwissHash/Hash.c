@@ -0,0 +1,553 @@
+/**
+ * @file   SwissHash/Hash.c
+ *
+ * @date   Oct 16, 2026
+ * @author WangLiang
+ * @email  liang.wang@elektrobit.com
+ *
+ * @brief  Create a hash table from string array or list, search string by hash table, probing groups of
+ *         slots by SIMD.
+ */
+
+#include "Hash.h"
+#include "../NormalHash/HashMethodInline.h"
+
+#define SWISS_TAG_BITS 7
+
+// 32 bits hash of a key, low 7 bits are it's tag.
+static inline unsigned int KeyHash(const void *key, size_t len)
+{
+	return (unsigned int)WordHash64(key, len, 0);
+}
+
+static inline signed char TagOf(unsigned int nHashKey)
+{
+	return (signed char)(nHashKey & ((1U << SWISS_TAG_BITS) - 1));
+}
+
+// First group a key is searched in.
+static inline unsigned int GroupOf(unsigned int nHashKey, unsigned int nGroupNum)
+{
+	return (nHashKey >> SWISS_TAG_BITS) & (nGroupNum - 1);
+}
+
+/**
+ * @brief Compare one byte with all control bytes of a group.
+ *
+ * @param ctrl First control byte of group, aligned to group.
+ * @param c Byte to look for.
+ * @return Bit i set when control byte i equals c.
+ */
+static inline unsigned int MatchByte(const signed char *ctrl, signed char c)
+{
+#if defined(__AVX2__)
+	__m256i group = _mm256_load_si256((const __m256i *)ctrl);
+	return (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(group, _mm256_set1_epi8(c)));
+#elif defined(__SSE2__)
+	__m128i group = _mm_load_si128((const __m128i *)ctrl);
+	return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(c)));
+#else
+	unsigned int nMatch = 0;
+	for (int i=0; i<SWISS_GROUP_WIDTH; ++i)
+	{
+		nMatch |= (unsigned int)(ctrl[i] == c) << i;
+	}
+	return nMatch;
+#endif
+}
+
+/**
+ * @brief Find empty or deleted slots of a group, both have the high bit set.
+ *
+ * @return Bit i set when slot i is free.
+ */
+static inline unsigned int MatchFree(const signed char *ctrl)
+{
+#if defined(__AVX2__)
+	return (unsigned int)_mm256_movemask_epi8(_mm256_load_si256((const __m256i *)ctrl));
+#elif defined(__SSE2__)
+	return (unsigned int)_mm_movemask_epi8(_mm_load_si128((const __m128i *)ctrl));
+#else
+	unsigned int nMatch = 0;
+	for (int i=0; i<SWISS_GROUP_WIDTH; ++i)
+	{
+		nMatch |= (unsigned int)(ctrl[i] < 0) << i;
+	}
+	return nMatch;
+#endif
+}
+
+/**
+ * @brief Allocate control bytes and slots of a table, all slots empty.
+ *
+ * @return SUCCEED, or FAILED if no memory.
+ */
+static int AllocTable(unsigned int nGroupNum, signed char **pCtrl, SwissSlot **pSlots)
+{
+	size_t nSlots = (size_t)nGroupNum * SWISS_GROUP_WIDTH;
+	void *ctrl = NULL;
+
+	// A group of control bytes never crosses a cache line.
+	if (0 != posix_memalign(&ctrl, 64, nSlots))
+	{
+		return FAILED;
+	}
+	*pSlots = MALLOC(SwissSlot, nSlots);
+	if (IS_NULL(*pSlots))
+	{
+		FREE(ctrl);
+		return FAILED;
+	}
+	memset(ctrl, SWISS_CTRL_EMPTY, nSlots);
+	*pCtrl = (signed char *)ctrl;
+	return SUCCEED;
+}
+
+/**
+ * @brief Find first empty or deleted slot on probe path of a hash key, table must have one.
+ *
+ *   Groups are probed at triangular steps, 1, 2, 3... groups further each time, which visits every group
+ * of a power of 2 table.
+ *
+ * @return Index of slot.
+ */
+static unsigned int FindFreeSlot(const signed char *ctrl, unsigned int nGroupNum, unsigned int nHashKey)
+{
+	unsigned int nGroup = GroupOf(nHashKey, nGroupNum);
+
+	for (unsigned int nStep=1; ; ++nStep)
+	{
+		unsigned int nFree = MatchFree(ctrl + (size_t)nGroup * SWISS_GROUP_WIDTH);
+		if (0 != nFree)
+		{
+			return nGroup * SWISS_GROUP_WIDTH + __builtin_ctz(nFree);
+		}
+		nGroup = (nGroup + nStep) & (nGroupNum - 1);
+	}
+}
+
+static inline void SetSlot(HashInf *pHashInf, unsigned int nPos, unsigned int nHashKey, const void *key,
+		size_t len)
+{
+	pHashInf->pCtrl[nPos] = TagOf(nHashKey);
+	pHashInf->pSlots[nPos].HashKey = nHashKey;
+	pHashInf->pSlots[nPos].nKeyLen = (unsigned int)len;
+	pHashInf->pSlots[nPos].item = (void *)key;
+}
+
+/**
+ * @brief Find slot of a key, slots are read only when their tag matches.
+ *
+ * @return Index of slot, or -1 if not found.
+ */
+static int FindSlot(const HashInf *pHashInf, unsigned int nHashKey, const void *key, size_t len)
+{
+	unsigned int nGroup = GroupOf(nHashKey, pHashInf->nGroupNum);
+	signed char tag = TagOf(nHashKey);
+
+	for (unsigned int nStep=1; nStep<=pHashInf->nGroupNum; ++nStep)
+	{
+		const signed char *ctrl = pHashInf->pCtrl + (size_t)nGroup * SWISS_GROUP_WIDTH;
+		unsigned int nMatch = MatchByte(ctrl, tag);
+
+		while (0 != nMatch)
+		{
+			unsigned int nPos = nGroup * SWISS_GROUP_WIDTH + __builtin_ctz(nMatch);
+			const SwissSlot *pSlot = &pHashInf->pSlots[nPos];
+			if ((nHashKey == pSlot->HashKey) && IS_SAME_KEY(key, len, pSlot->item, pSlot->nKeyLen))
+			{
+				return (int)nPos;
+			}
+			nMatch &= nMatch - 1;
+		}
+		// Key would have been put into this group, it is not further on.
+		if (0 != MatchByte(ctrl, SWISS_CTRL_EMPTY))
+		{
+			return -1;
+		}
+		nGroup = (nGroup + nStep) & (pHashInf->nGroupNum - 1);
+	}
+	return -1;
+}
+
+/**
+ * @brief Move all keys into a table of nGroupNum groups, deleted slots are dropped.
+ *
+ * @return SUCCEED, or FAILED if no memory, hash information is not changed then.
+ */
+static int ResizeTable(HashInf *pHashInf, unsigned int nGroupNum)
+{
+	size_t nOldSlots = (size_t)pHashInf->nGroupNum * SWISS_GROUP_WIDTH;
+	signed char *ctrl;
+	SwissSlot *pSlots;
+
+	if (FAILED == AllocTable(nGroupNum, &ctrl, &pSlots))
+	{
+		return FAILED;
+	}
+	for (size_t i=0; i<nOldSlots; ++i)
+	{
+		if (pHashInf->pCtrl[i] >= 0)
+		{
+			unsigned int nPos = FindFreeSlot(ctrl, nGroupNum, pHashInf->pSlots[i].HashKey);
+			ctrl[nPos] = pHashInf->pCtrl[i];
+			pSlots[nPos] = pHashInf->pSlots[i];
+		}
+	}
+	FREE(pHashInf->pCtrl);
+	FREE(pHashInf->pSlots);
+	pHashInf->pCtrl = ctrl;
+	pHashInf->pSlots = pSlots;
+	pHashInf->nGroupNum = nGroupNum;
+	pHashInf->nDeletedNum = 0;
+	return SUCCEED;
+}
+
+/**
+ * @brief Make sure one more key can be put, keeping used and deleted slots within max load.
+ *
+ *   When keys alone take more than half of max load the table doubles, else it is rebuilt at the same
+ * size to clean deleted slots.
+ *
+ * @return SUCCEED, or FAILED if no memory or table is at it's max size.
+ */
+static int ReserveOneSlot(HashInf *pHashInf)
+{
+	unsigned long long nSlots = (unsigned long long)pHashInf->nGroupNum * SWISS_GROUP_WIDTH;
+	unsigned int nGroupNum = pHashInf->nGroupNum;
+
+	if ((pHashInf->nItemNum + pHashInf->nDeletedNum + 1ULL) * 8 <= nSlots * SWISS_MAX_LOAD_EIGHTHS)
+	{
+		return SUCCEED;
+	}
+	if ((pHashInf->nItemNum + 1ULL) * 16 > nSlots * SWISS_MAX_LOAD_EIGHTHS)
+	{
+		if (nGroupNum >= (1U << SWISS_MAX_GROUP_BITS))
+		{
+			return FAILED;
+		}
+		nGroupNum *= 2;
+	}
+	return ResizeTable(pHashInf, nGroupNum);
+}
+
+/**
+ * @brief Create empty hash information.
+ *
+ * @param itemNum Number of items expected, table holds them within max load.
+ * @return Pointer to created hash information, or NULL if no memory.
+ */
+static HashInf *CreateHashInf(int itemNum)
+{
+	HashInf *pHashInf = MALLOC(HashInf, 1);
+	unsigned long long nSlots = (unsigned long long)MAX(itemNum, 0) * 8 / SWISS_MAX_LOAD_EIGHTHS + 1;
+	unsigned int nGroupNum = 1;
+
+	if (IS_NULL(pHashInf))
+	{
+		return NULL;
+	}
+	while (((unsigned long long)nGroupNum * SWISS_GROUP_WIDTH < nSlots) && (nGroupNum < (1U << SWISS_MAX_GROUP_BITS)))
+	{
+		nGroupNum *= 2;
+	}
+	if (FAILED == AllocTable(nGroupNum, &pHashInf->pCtrl, &pHashInf->pSlots))
+	{
+		FREE(pHashInf);
+		return NULL;
+	}
+	pHashInf->nGroupNum = nGroupNum;
+	pHashInf->nItemNum = 0;
+	pHashInf->nDeletedNum = 0;
+	return pHashInf;
+}
+
+/**
+ * @brief Create hash information from list.
+ *
+ * @param itemNum Number of items in array.
+ * @param list Pointer pointed to list which will create hash information.
+ * @param GetNextStr Method of how to get string from list.
+ * @return Pointer to created hash information, or NULL if no memory.
+ */
+HashInf *HashFromList(int itemNum, char *(GetNextStr)(void **), void *list)
+{
+	char *str = NULL;
+	HashInf *pHashInf = CreateHashInf(itemNum);
+
+	// Get every string in list and add them to hash table.
+	while (IS_NOT_NULL(pHashInf) && (NULL != (str = (*GetNextStr)(&list))))
+	{
+		if (FAILED == InsertString(pHashInf, str))
+		{
+			DeleteHashInf(&pHashInf);
+		}
+	}
+	return pHashInf;
+}
+
+/**
+ * @brief Create hash information from a array.
+ *
+ * @param itemNum Number of items in array.
+ * @param pArray Pointer pointed to array which will create hash information.
+ * @return Pointer to created hash information, or NULL if no memory.
+ */
+HashInf *HashFromArray(int itemNum, char **pArray)
+{
+	HashInf *pHashInf = CreateHashInf(itemNum);
+
+	// Add each string to hash table.
+	for (int i=0; IS_NOT_NULL(pHashInf) && (i<itemNum); ++i)
+	{
+		if (FAILED == InsertString(pHashInf, pArray[i]))
+		{
+			DeleteHashInf(&pHashInf);
+		}
+	}
+	return pHashInf;
+}
+
+/**
+ * @brief Create hash information from keys with known length, keys need no terminating '\0'.
+ *
+ * @param itemNum Number of keys.
+ * @param pKeys Address of each key, saved in hash table as it is, not copied.
+ * @param pLens Length of each key.
+ * @return Pointer to created hash information, or NULL if no memory.
+ */
+HashInf *HashFromKeys(int itemNum, const void **pKeys, const size_t *pLens)
+{
+	HashInf *pHashInf = CreateHashInf(itemNum);
+
+	for (int i=0; IS_NOT_NULL(pHashInf) && (i<itemNum); ++i)
+	{
+		if (FAILED == InsertKey(pHashInf, pKeys[i], pLens[i]))
+		{
+			DeleteHashInf(&pHashInf);
+		}
+	}
+	return pHashInf;
+}
+
+/**
+ * @brief Put a key with known hash key into a free slot, it is not checked whether already in table.
+ *
+ * @return SUCCEED, or FAILED if no memory to grow hash table.
+ */
+static int InsertHashed(HashInf *pHashInf, unsigned int nHashKey, const void *key, size_t len)
+{
+	unsigned int nPos;
+
+	if (FAILED == ReserveOneSlot(pHashInf))
+	{
+		return FAILED;
+	}
+	nPos = FindFreeSlot(pHashInf->pCtrl, pHashInf->nGroupNum, nHashKey);
+	if (SWISS_CTRL_DELETED == pHashInf->pCtrl[nPos])
+	{
+		--pHashInf->nDeletedNum;
+	}
+	SetSlot(pHashInf, nPos, nHashKey, key, len);
+	++pHashInf->nItemNum;
+	return SUCCEED;
+}
+
+/**
+ * @brief Free slot of a key.
+ *
+ *   A group never gets an empty slot back once it was full, searches passing it would stop there. So a
+ * slot of a group still having an empty one is empty again, else it is marked deleted.
+ *
+ * @return SUCCEED, or FAILED if key is not in hash table.
+ */
+static int RemoveHashed(HashInf *pHashInf, unsigned int nHashKey, const void *key, size_t len)
+{
+	int nPos = FindSlot(pHashInf, nHashKey, key, len);
+	const signed char *ctrl;
+
+	if (nPos < 0)
+	{
+		return FAILED;
+	}
+	ctrl = pHashInf->pCtrl + (nPos & ~(SWISS_GROUP_WIDTH - 1));
+	if (0 != MatchByte(ctrl, SWISS_CTRL_EMPTY))
+	{
+		pHashInf->pCtrl[nPos] = SWISS_CTRL_EMPTY;
+	}
+	else
+	{
+		pHashInf->pCtrl[nPos] = SWISS_CTRL_DELETED;
+		++pHashInf->nDeletedNum;
+	}
+	--pHashInf->nItemNum;
+	return SUCCEED;
+}
+
+/**
+ * @brief Replace address of a key already in table, or insert it.
+ *
+ * @return SUCCEED, or FAILED if no memory to grow hash table.
+ */
+static int UpsertHashed(HashInf *pHashInf, unsigned int nHashKey, const void *key, size_t len)
+{
+	int nPos = FindSlot(pHashInf, nHashKey, key, len);
+
+	if (nPos < 0)
+	{
+		return InsertHashed(pHashInf, nHashKey, key, len);
+	}
+	pHashInf->pSlots[nPos].item = (void *)key;
+	return SUCCEED;
+}
+
+/**
+ * @brief Insert a string into created hash information, hash table grows if needed.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param str Which string want to insert, it is not checked whether already in hash table.
+ * @return SUCCEED, or FAILED if no memory to grow hash table.
+ */
+int InsertString(HashInf *pHashInf, const char *str)
+{
+	return InsertKey(pHashInf, str, strlen(str));
+}
+
+/**
+ * @brief Remove a string from created hash information.
+ *
+ * @param pHashInf Which hash information to remove from.
+ * @param str Which string want to remove.
+ * @return SUCCEED, or FAILED if string is not in hash table.
+ */
+int RemoveString(HashInf *pHashInf, const char *str)
+{
+	return RemoveKey(pHashInf, str, strlen(str));
+}
+
+/**
+ * @brief Insert a string into created hash information, or replace same string already in it.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param str Which string want to insert, GetStringAddress() returns this address afterwards.
+ * @return SUCCEED, or FAILED if no memory to grow hash table.
+ */
+int UpsertString(HashInf *pHashInf, const char *str)
+{
+	return UpsertKey(pHashInf, str, strlen(str));
+}
+
+/**
+ * @brief Insert a key with known length into created hash information, hash table grows if needed.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param key Which key want to insert, it is not copied or checked whether already in hash table.
+ * @param len Length of key.
+ * @return SUCCEED, or FAILED if no memory to grow hash table.
+ */
+int InsertKey(HashInf *pHashInf, const void *key, size_t len)
+{
+	return InsertHashed(pHashInf, KeyHash(key, len), key, len);
+}
+
+/**
+ * @brief Remove a key with known length from created hash information.
+ *
+ * @param pHashInf Which hash information to remove from.
+ * @param key Which key want to remove.
+ * @param len Length of key.
+ * @return SUCCEED, or FAILED if key is not in hash table.
+ */
+int RemoveKey(HashInf *pHashInf, const void *key, size_t len)
+{
+	return RemoveHashed(pHashInf, KeyHash(key, len), key, len);
+}
+
+/**
+ * @brief Insert a key with known length into created hash information, or replace same key already in it.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param key Which key want to insert, GetKeyAddress() returns this address afterwards.
+ * @param len Length of key.
+ * @return SUCCEED, or FAILED if no memory to grow hash table.
+ */
+int UpsertKey(HashInf *pHashInf, const void *key, size_t len)
+{
+	return UpsertHashed(pHashInf, KeyHash(key, len), key, len);
+}
+
+/**
+ * @brief Delete created hash information.
+ *
+ * @param pHashInf Pointer to which hash information you want to delete.
+ */
+void DeleteHashInf(HashInf **pHashInf)
+{
+	if (IS_NULL(pHashInf) || IS_NULL(*pHashInf))
+	{
+		return;
+	}
+	SECURE_FREE((*pHashInf)->pCtrl);
+	SECURE_FREE((*pHashInf)->pSlots);
+	FREE(*pHashInf);
+}
+
+/**
+ * @brief Get real key address, key has known length and needs no terminating '\0'.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param key Which key you want to find.
+ * @param len Length of key.
+ * @return Real key address, or NULL if not found.
+ */
+void *GetKeyAddress(HashInf *pHashInf, const void *key, size_t len)
+{
+	int nPos = FindSlot(pHashInf, KeyHash(key, len), key, len);
+	return (nPos >= 0) ? pHashInf->pSlots[nPos].item : NULL;
+}
+
+/**
+ * @brief Get real string address, the string must be in array or list which created hash information.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param str Which string you want to find.
+ * @return Real string address, or NULL if not found.
+ */
+void *GetStringAddress(HashInf *pHashInf, const char *str)
+{
+	return GetKeyAddress(pHashInf, str, strlen(str));
+}
+
+/**
+ * @brief Get real string address of many strings at once.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param keys Strings you want to find.
+ * @param n Number of strings.
+ * @param out Save real string address of each string, NULL if not found.
+ */
+void GetStringAddressBatch(HashInf *pHashInf, const char **keys, size_t n, void **out)
+{
+	unsigned int nHashKey[BATCH_GROUP_SIZE];
+	size_t nLen[BATCH_GROUP_SIZE];
+
+	for (size_t nStart=0; nStart<n; nStart+=BATCH_GROUP_SIZE)
+	{
+		size_t nGroup = MIN(n - nStart, (size_t)BATCH_GROUP_SIZE);
+
+		// Hash whole group, ask for control bytes of each first group.
+		for (size_t i=0; i<nGroup; ++i)
+		{
+			nLen[i] = strlen(keys[nStart+i]);
+			nHashKey[i] = KeyHash(keys[nStart+i], nLen[i]);
+			PREFETCH(pHashInf->pCtrl + (size_t)GroupOf(nHashKey[i], pHashInf->nGroupNum) * SWISS_GROUP_WIDTH);
+		}
+
+		// Control bytes are on the way or in cache, search them.
+		for (size_t i=0; i<nGroup; ++i)
+		{
+			int nPos = FindSlot(pHashInf, nHashKey[i], keys[nStart+i], nLen[i]);
+			out[nStart+i] = (nPos >= 0) ? pHashInf->pSlots[nPos].item : NULL;
+		}
+	}
+}
@@ -0,0 +1,211 @@
+/**
+ * @file   SwissHash/Hash.h
+ *
+ * @date   Oct 16, 2026
+ * @author WangLiang
+ * @email  liang.wang@elektrobit.com
+ *
+ * @brief  Create a hash table from string array or list, search string by hash table, probing groups of
+ *         slots by SIMD.
+ *
+ *   Table is cut into groups of SWISS_GROUP_WIDTH slots. Besides slots, each slot has one control byte,
+ * kept in a separate array, holding 7 bits tag of hash key, or empty or deleted. A search compares the
+ * tag with all control bytes of a group by one SSE2 or AVX2 instruction and only reads slots whose tag
+ * matches, one in 128 for a wrong key. Search stops at the first group with an empty slot, so at 87.5%
+ * load nearly every search reads one group of control bytes, one cache line, and one slot.
+ *
+ *   Build with -mavx2 for groups of 32 slots, else SSE2 compares groups of 16, a plain loop does the
+ * same without SSE2.
+ */
+
+#ifndef HASH_H_
+#define HASH_H_
+
+#include "../CProjectDfn.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SWISS_GROUP_WIDTH 32
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SWISS_GROUP_WIDTH 16
+#else
+#define SWISS_GROUP_WIDTH 16
+#endif
+
+/**
+ * @brief Control byte of a slot never used, search stops at a group having one.
+ */
+#define SWISS_CTRL_EMPTY ((signed char)0x80)
+
+/**
+ * @brief Control byte of a removed slot, search goes on, insert reuses it.
+ */
+#define SWISS_CTRL_DELETED ((signed char)0xFE)
+
+/**
+ * @brief Max part of slots used or deleted, in eighths, table grows or cleans deleted slots above it.
+ */
+#define SWISS_MAX_LOAD_EIGHTHS 7
+
+/**
+ * @brief Groups of hash key bits 7 to 31, so table has at most 2^25 groups.
+ */
+#define SWISS_MAX_GROUP_BITS 25
+
+/**
+ * @brief Number of strings hashed and prefetched together by GetStringAddressBatch().
+ */
+#define BATCH_GROUP_SIZE 16
+
+/**
+ * @brief Key of one slot, only valid when control byte holds a tag.
+ *
+ *   Hash key is kept whole, low 7 bits are the tag and next bits the group, so growing the table never
+ * reads keys again.
+ */
+typedef struct SwissSlot
+{
+	unsigned int HashKey;      ///< 32 bits hash of key.
+	unsigned int nKeyLen;      ///< Length of key, keys must be shorter than 4 GB.
+	void *item;                ///< Address of key.
+}SwissSlot;
+
+/**
+ * @brief Hash information, control bytes and slots of hash table.
+ */
+typedef struct HashTableInf
+{
+	signed char *pCtrl;        ///< Control byte of each slot, aligned to a group.
+	SwissSlot *pSlots;         ///< Slots, same order as control bytes.
+	unsigned int nGroupNum;    ///< Number of groups, power of 2.
+	unsigned int nItemNum;     ///< Number of keys.
+	unsigned int nDeletedNum;  ///< Number of deleted slots.
+}HashInf;
+
+/**
+ * @brief Create hash information from list.
+ *
+ * @param itemNum Number of items in array.
+ * @param list Pointer pointed to list which will create hash information.
+ * @param GetNextStr Method of how to get string from list.
+ * @return Pointer to created hash information, or NULL if no memory.
+ */
+HashInf *HashFromList(int itemNum, char *(GetNextStr)(void **), void *list);
+
+/**
+ * @brief Create hash information from a array.
+ *
+ * @param itemNum Number of items in array.
+ * @param pArray Pointer pointed to array which will create hash information.
+ * @return Pointer to created hash information, or NULL if no memory.
+ */
+HashInf *HashFromArray(int itemNum, char **pArray);
+
+/**
+ * @brief Create hash information from keys with known length, keys need no terminating '\0'.
+ *
+ * @param itemNum Number of keys.
+ * @param pKeys Address of each key, saved in hash table as it is, not copied.
+ * @param pLens Length of each key.
+ * @return Pointer to created hash information, or NULL if no memory.
+ */
+HashInf *HashFromKeys(int itemNum, const void **pKeys, const size_t *pLens);
+
+/**
+ * @brief Insert a string into created hash information, hash table grows if needed.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param str Which string want to insert, it is not checked whether already in hash table.
+ * @return SUCCEED, or FAILED if no memory to grow hash table.
+ */
+int InsertString(HashInf *pHashInf, const char *str);
+
+/**
+ * @brief Remove a string from created hash information.
+ *
+ * @param pHashInf Which hash information to remove from.
+ * @param str Which string want to remove.
+ * @return SUCCEED, or FAILED if string is not in hash table.
+ */
+int RemoveString(HashInf *pHashInf, const char *str);
+
+/**
+ * @brief Insert a string into created hash information, or replace same string already in it.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param str Which string want to insert, GetStringAddress() returns this address afterwards.
+ * @return SUCCEED, or FAILED if no memory to grow hash table.
+ */
+int UpsertString(HashInf *pHashInf, const char *str);
+
+/**
+ * @brief Insert a key with known length into created hash information, hash table grows if needed.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param key Which key want to insert, it is not copied or checked whether already in hash table.
+ * @param len Length of key.
+ * @return SUCCEED, or FAILED if no memory to grow hash table.
+ */
+int InsertKey(HashInf *pHashInf, const void *key, size_t len);
+
+/**
+ * @brief Remove a key with known length from created hash information.
+ *
+ * @param pHashInf Which hash information to remove from.
+ * @param key Which key want to remove.
+ * @param len Length of key.
+ * @return SUCCEED, or FAILED if key is not in hash table.
+ */
+int RemoveKey(HashInf *pHashInf, const void *key, size_t len);
+
+/**
+ * @brief Insert a key with known length into created hash information, or replace same key already in it.
+ *
+ * @param pHashInf Which hash information to insert.
+ * @param key Which key want to insert, GetKeyAddress() returns this address afterwards.
+ * @param len Length of key.
+ * @return SUCCEED, or FAILED if no memory to grow hash table.
+ */
+int UpsertKey(HashInf *pHashInf, const void *key, size_t len);
+
+/**
+ * @brief Delete created hash information.
+ *
+ * @param pHashInf Pointer to which hash information you want to delete.
+ */
+void DeleteHashInf(HashInf **pHashInf);
+
+/**
+ * @brief Get real string address, the string must be in array or list which created hash information.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param str Which string you want to find.
+ * @return Real string address, or NULL if not found.
+ */
+void *GetStringAddress(HashInf *pHashInf, const char *str);
+
+/**
+ * @brief Get real key address, key has known length and needs no terminating '\0'.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param key Which key you want to find.
+ * @param len Length of key.
+ * @return Real key address, or NULL if not found.
+ */
+void *GetKeyAddress(HashInf *pHashInf, const void *key, size_t len);
+
+/**
+ * @brief Get real string address of many strings at once.
+ *
+ *   Strings are handled in groups of BATCH_GROUP_SIZE, all of a group are hashed and control bytes of
+ * their first groups are prefetched before any is searched, so cache misses of the group overlap.
+ *
+ * @param pHashInf Which hash information to search.
+ * @param keys Strings you want to find.
+ * @param n Number of strings.
+ * @param out Save real string address of each string, NULL if not found.
+ */
+void GetStringAddressBatch(HashInf *pHashInf, const char **keys, size_t n, void **out);
+
+#endif /* HASH_H_ */